@@ -155,6 +155,11 @@ void _new_thread(char *pStackMem, unsigned stackSize, _thread_entry_t pEntry,
 
 	_nano_timeout_tcs_init(tcs);
 
+#ifdef CONFIG_NANO_FIBER_EDF
+	/* not scheduled by deadline until it asks for it */
+	tcs->edf.rel_deadline = 0;
+#endif
+
 	/* initial values in all other registers/TCS entries are irrelevant */
 
 	THREAD_MONITOR_INIT(tcs);
@@ -180,6 +180,9 @@ struct tcs {
 #ifdef CONFIG_NANO_TIMEOUTS
 	struct _nano_timeout nano_timeout;
 #endif
+#ifdef CONFIG_NANO_FIBER_EDF
+	struct _nano_edf edf;
+#endif
 #ifdef CONFIG_ERRNO
 	int errno_var;
 #endif
@@ -210,8 +213,10 @@ struct s_NANO {
 	 */
 
 	struct firq_regs firq_regs;
-#ifdef CONFIG_NANO_TIMEOUTS
+#if defined(CONFIG_NANO_TIMEOUTS) || defined(CONFIG_NANO_TIMERS)
 	sys_dlist_t timeout_q;
+#endif
+#ifdef CONFIG_NANO_TIMEOUTS
 	int32_t task_timeout;
 #endif
 };
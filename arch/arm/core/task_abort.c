@@ -62,7 +62,7 @@ void _TaskAbort(void)
 		cmd_packet.args.g1.opt = taskAbortCode;
 		cmd_packet.alloc = false;
 		_k_current_task->args = &cmd_packet;
-		nano_isr_stack_push(&_k_command_stack, (uint32_t) &cmd_packet);
+		_k_command_isr_push(&cmd_packet);
 		_ScbPendsvSet();
 	}
 }
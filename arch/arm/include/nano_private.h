@@ -125,6 +125,12 @@ struct tcs {
 #ifdef CONFIG_NANO_TIMEOUTS
 	struct _nano_timeout nano_timeout;
 #endif
+#ifdef CONFIG_NANO_FIBER_EDF
+	struct _nano_edf edf;
+#endif
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	uint64_t runtime; /* cycles spent running, see __pendsv() */
+#endif
 #ifdef CONFIG_ERRNO
 	int errno_var;
 #endif
@@ -148,8 +154,10 @@ struct s_NANO {
 	int32_t idle; /* Number of ticks for kernel idling */
 #endif		      /* CONFIG_ADVANCED_POWER_MANAGEMENT */
 
-#ifdef CONFIG_NANO_TIMEOUTS
+#if defined(CONFIG_NANO_TIMEOUTS) || defined(CONFIG_NANO_TIMERS)
 	sys_dlist_t timeout_q;
+#endif
+#ifdef CONFIG_NANO_TIMEOUTS
 	int32_t task_timeout;
 #endif
 };
@@ -25,6 +25,10 @@
  * The module also provides an implementation of nano_cpu_atomic_idle(), which
  * atomically re-enables interrupts and enters low power mode.
  *
+ * In a nanokernel system with tickless idle, both routines stop the periodic
+ * system clock interrupts until the next timeout is due before entering low
+ * power mode.
+ *
  * INTERNAL
  * These implementations of nano_cpu_idle() and nano_cpu_atomic_idle() could be
  * used when operating as a Hypervisor guest.  More specifically, the Hypervisor
@@ -42,6 +46,12 @@
 extern uint64_t __idle_tsc;  /* timestamp when CPU went idle */
 #endif
 
+#if defined(CONFIG_NANOKERNEL) && defined(CONFIG_TICKLESS_IDLE)
+extern void _power_save_idle(void);
+#else
+#define _power_save_idle() do { } while ((0))
+#endif
+
 /**
  *
  * @brief Power save idle routine for IA-32
@@ -55,6 +65,11 @@ extern uint64_t __idle_tsc;  /* timestamp when CPU went idle */
  */
 void nano_cpu_idle(void)
 {
+#if defined(CONFIG_NANOKERNEL) && defined(CONFIG_TICKLESS_IDLE)
+	/* the timeout queues must not change until the CPU is halted */
+	irq_lock();
+#endif
+	_power_save_idle();
 	_int_latency_stop();
 	_sys_k_event_logger_enter_sleep();
 #if defined(CONFIG_BOOT_TIME_MEASUREMENT)
@@ -90,6 +105,7 @@ void nano_cpu_idle(void)
 
 void nano_cpu_atomic_idle(unsigned int imask)
 {
+	_power_save_idle();
 	_int_latency_stop();
 	_sys_k_event_logger_enter_sleep();
 
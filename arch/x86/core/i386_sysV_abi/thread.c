@@ -189,6 +189,15 @@ static void _new_thread_internal(char *pStackMem, unsigned stackSize,
 #endif /* CONFIG_THREAD_MONITOR */
 
 	_nano_timeout_tcs_init(tcs);
+
+#ifdef CONFIG_NANO_FIBER_EDF
+	/* not scheduled by deadline until it asks for it */
+	tcs->edf.rel_deadline = 0;
+#endif
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	tcs->runtime = 0;
+#endif
 }
 
 #if defined(CONFIG_GDB_INFO) || defined(CONFIG_GDB_SERVER)
@@ -24,6 +24,12 @@ extern void _sys_k_event_logger_context_switch(void);
 #define _sys_k_event_logger_context_switch()
 #endif
 
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+extern void _sys_thread_runtime_switch(void);
+#else
+#define _sys_thread_runtime_switch()
+#endif
+
 unsigned int _Swap(unsigned int eflags)
 {
 	struct tcs *next;
@@ -42,6 +48,7 @@ unsigned int _Swap(unsigned int eflags)
 			 :"=m" (_nanokernel.current->coopReg.esp));
 
 	_sys_k_event_logger_context_switch();
+	_sys_thread_runtime_switch();
 
 	/* find the next context to run */
 	if (_nanokernel.fiber) {
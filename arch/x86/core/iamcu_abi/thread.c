@@ -138,4 +138,13 @@ void _new_thread(char *stack_memory, unsigned stack_size,
 #endif /* CONFIG_THREAD_MONITOR */
 
 	_nano_timeout_tcs_init(tcs);
+
+#ifdef CONFIG_NANO_FIBER_EDF
+	/* not scheduled by deadline until it asks for it */
+	tcs->edf.rel_deadline = 0;
+#endif
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	tcs->runtime = 0;
+#endif
 }
@@ -663,6 +663,13 @@ struct tcs {
 	struct _nano_timeout nano_timeout;
 #endif
 
+#ifdef CONFIG_NANO_FIBER_EDF
+	struct _nano_edf edf;
+#endif
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	uint64_t runtime; /* cycles spent running, see _Swap() */
+#endif
+
 #ifdef CONFIG_ERRNO
 	int errno_var;
 #endif
@@ -720,8 +727,10 @@ typedef struct s_NANO {
 
 	struct tcs *current_fp; /* thread (fiber or task) that owns the FP regs */
 #endif			  /* CONFIG_FP_SHARING */
-#ifdef CONFIG_NANO_TIMEOUTS
+#if defined(CONFIG_NANO_TIMEOUTS) || defined(CONFIG_NANO_TIMERS)
 	sys_dlist_t timeout_q;
+#endif
+#ifdef CONFIG_NANO_TIMEOUTS
 	int32_t task_timeout;
 #endif
 } tNANO;
@@ -30,6 +30,11 @@
 
 #include <misc/shell.h>
 
+#if defined(CONFIG_THREAD_RUNTIME_STATS) && defined(CONFIG_THREAD_MONITOR)
+#include <nano_private.h>
+#define SHELL_THREADS_CMD
+#endif
+
 /* maximum number of command parameters */
 #define ARGC_MAX 10
 
@@ -121,12 +126,76 @@ static void show_help(int argc, char *argv[])
 
 	printk("Available commands:\n");
 	printk("help\n");
+#ifdef SHELL_THREADS_CMD
+	printk("threads\n");
+#endif
 
 	for (i = 0; commands[i].cmd_name; i++) {
 		printk("%s\n", commands[i].cmd_name);
 	}
 }
 
+#ifdef SHELL_THREADS_CMD
+/* maximum number of threads listed by the threads command */
+#define THREADS_MAX 16
+
+struct thread_info {
+	struct tcs *thread;
+	uint64_t runtime;
+	int prio;
+};
+
+static void show_threads(int argc, char *argv[])
+{
+	struct thread_info info[THREADS_MAX];
+	unsigned int key;
+	struct tcs *thread;
+	struct tcs *current;
+	uint64_t total = 0;
+	int count = 0;
+	int more = 0;
+	int i;
+
+	/*
+	 * The thread list must not change while it is walked: take a snapshot
+	 * of it, and print it once interrupts are unlocked again.
+	 */
+	key = irq_lock();
+
+	for (thread = _nanokernel.threads; thread;
+	     thread = thread->next_thread) {
+		uint64_t runtime = sys_thread_runtime_get(thread);
+
+		total += runtime;
+		if (count == THREADS_MAX) {
+			more++;
+			continue;
+		}
+		info[count].thread = thread;
+		info[count].runtime = runtime;
+		info[count].prio = thread->prio;
+		count++;
+	}
+	current = _nanokernel.current;
+
+	irq_unlock(key);
+
+	printk("thread\t\tprio\trun time (ms)\tcpu\n");
+
+	for (i = 0; i < count; i++) {
+		printk("0x%x%c\t%d\t%u\t\t%u%%\n", (uint32_t)info[i].thread,
+		       info[i].thread == current ? '*' : ' ', info[i].prio,
+		       (uint32_t)(info[i].runtime /
+				  (sys_clock_hw_cycles_per_sec / MSEC_PER_SEC)),
+		       total ? (uint32_t)(info[i].runtime * 100 / total) : 0);
+	}
+
+	if (more) {
+		printk("(%d more threads not shown)\n", more);
+	}
+}
+#endif
+
 static shell_cmd_function_t get_cb(const char *string)
 {
 	size_t len;
@@ -141,6 +210,12 @@ static shell_cmd_function_t get_cb(const char *string)
 		return show_help;
 	}
 
+#ifdef SHELL_THREADS_CMD
+	if (!strncmp(string, "threads", len)) {
+		return show_threads;
+	}
+#endif
+
 	for (i = 0; commands[i].cmd_name; i++) {
 		if (!strncmp(string, commands[i].cmd_name, len)) {
 			return commands[i].cb;
@@ -32,13 +32,40 @@
 
 static inline uint32_t eth_read(uint32_t base_addr, uint32_t offset)
 {
+#ifdef CONFIG_ETH_DW_LOOPBACK
+	ARG_UNUSED(base_addr);
+	return eth_dw_loopback_read(offset);
+#else
 	return sys_read32(base_addr + offset);
+#endif
 }
 
 static inline void eth_write(uint32_t base_addr, uint32_t offset,
 			     uint32_t val)
 {
+#ifdef CONFIG_ETH_DW_LOOPBACK
+	ARG_UNUSED(base_addr);
+	eth_dw_loopback_write(offset, val);
+#else
 	sys_write32(val, base_addr + offset);
+#endif
+}
+
+/* @brief Prepare a receive buffer to be passed to the IP stack.
+ *
+ *        Sets up the IP stack metadata of a buffer of the driver pool the
+ *        way ip_buf_get_reserve_rx() does for the buffers of the stack.
+ */
+static void eth_rx_buf_setup(struct net_buf *buf, uint32_t frm_len)
+{
+	ip_buf_type(buf) = IP_BUF_RX;
+	ip_buf_context(buf) = NULL;
+	ip_buf_reserve(buf) = 0;
+	ip_buf_appdata(buf) = buf->data;
+	ip_buf_appdatalen(buf) = 0;
+
+	net_buf_add(buf, frm_len);
+	uip_len(buf) = frm_len;
 }
 
 static void eth_rx(struct device *port)
@@ -46,92 +73,149 @@ static void eth_rx(struct device *port)
 	struct eth_runtime *context = port->driver_data;
 	struct eth_config *config = port->config->config_info;
 	uint32_t base_addr = config->base_addr;
-	struct net_buf *buf;
+	volatile struct eth_rx_desc *desc;
+	struct net_buf *buf, *new_buf;
 	uint32_t frm_len = 0;
+	int count = 0;
 
-	/* Check whether the RX descriptor is still owned by the device.  If not,
-	 * process the received frame or an error that may have occurred.
+	/* Process the received frames and errors of all the RX descriptors no
+	 * longer owned by the device, in ring order, so that frames received
+	 * back-to-back are all handled by one interrupt.
 	 */
-	if (context->rx_desc.own == 1) {
-		ETH_ERR("Spurious receive interrupt from Ethernet MAC.\n");
-		return;
-	}
+	for (desc = &context->rx_desc[context->rx_head]; desc->own == 0;
+	     desc = &context->rx_desc[context->rx_head]) {
+		buf = context->rx_bufs[context->rx_head];
+		count++;
+
+		if (!net_driver_ethernet_is_opened()) {
+			goto release_desc;
+		}
+
+		if (desc->err_summary) {
+			ETH_ERR("Error receiving frame: RDES0 = %08x, "
+				"RDES1 = %08x.\n", desc->rdes0, desc->rdes1);
+			goto release_desc;
+		}
+
+		frm_len = desc->frm_len;
+		if (!desc->first_desc || !desc->last_desc ||
+		    frm_len > UIP_BUFSIZE) {
+			ETH_ERR("Frame too large: %u.\n", frm_len);
+			goto release_desc;
+		}
+
+		/* Refill the descriptor before passing its buffer up; the
+		 * frame is dropped, and the buffer reused, if none is free.
+		 */
+		new_buf = net_buf_get(&context->rx_free, 0);
+		if (new_buf == NULL) {
+			ETH_ERR("Failed to obtain RX buffer.\n");
+			goto release_desc;
+		}
+
+		context->rx_bufs[context->rx_head] = new_buf;
+		desc->buf1_ptr = new_buf->data;
+
+		eth_rx_buf_setup(buf, frm_len);
+		net_driver_ethernet_recv(buf);
 
-	if (!net_driver_ethernet_is_opened()) {
-		goto release_desc;
-	}
+release_desc:
+		/* Return ownership of the RX descriptor to the device. */
+		desc->own = 1;
 
-	if (context->rx_desc.err_summary) {
-		ETH_ERR("Error receiving frame: RDES0 = %08x, RDES1 = %08x.\n",
-			context->rx_desc.rdes0, context->rx_desc.rdes1);
-		goto release_desc;
+		context->rx_head = (context->rx_head + 1) % ETH_DW_RX_DESC_COUNT;
 	}
 
-	buf = ip_buf_get_reserve_rx(0);
-	if (buf == NULL) {
-		ETH_ERR("Failed to obtain RX buffer.\n");
-		goto release_desc;
+	/* A frame received while the previous interrupt was being handled may
+	 * have been processed already.
+	 */
+	if (count == 0) {
+		return;
 	}
 
-	frm_len = context->rx_desc.frm_len;
-	if (frm_len > UIP_BUFSIZE) {
-		ETH_ERR("Frame too large: %u.\n", frm_len);
-		goto release_desc;
-	}
+	/* Request that the device check for an available RX descriptor, since
+	 * ownership of descriptors was just transferred to the device.
+	 */
+	eth_write(base_addr, REG_ADDR_RX_POLL_DEMAND, 1);
+}
 
-	memcpy(net_buf_add(buf, frm_len), (void *)context->rx_buf, frm_len);
-	uip_len(buf) = frm_len;
+/* @brief Reclaim the TX descriptors of the transmitted frames.
+ *
+ *        Releases the buffers the device has finished transmitting and makes
+ *        their descriptors available to eth_tx() again.
+ */
+static void eth_tx_done(struct device *port)
+{
+	struct eth_runtime *context = port->driver_data;
+	volatile struct eth_tx_desc *desc;
+	struct net_buf *buf;
 
-	net_driver_ethernet_recv(buf);
+	for (desc = &context->tx_desc[context->tx_tail];
+	     (buf = context->tx_bufs[context->tx_tail]) && desc->own == 0;
+	     desc = &context->tx_desc[context->tx_tail]) {
+#ifdef CONFIG_ETHERNET_DEBUG
+		/* Check whether an error occurred transmitting the frame. */
+		if (desc->err_summary) {
+			ETH_ERR("Error transmitting frame: TDES0 = %08x, "
+				"TDES1 = %08x.\n", desc->tdes0, desc->tdes1);
+		}
+#endif
 
-release_desc:
-	/* Return ownership of the RX descriptor to the device. */
-	context->rx_desc.own = 1;
+		context->tx_bufs[context->tx_tail] = NULL;
+		context->tx_tail = (context->tx_tail + 1) % ETH_DW_TX_DESC_COUNT;
 
-	/* Request that the device check for an available RX descriptor, since
-	 * ownership of the descriptor was just transferred to the device.
-	 */
-	eth_write(base_addr, REG_ADDR_RX_POLL_DEMAND, 1);
+		ip_buf_unref(buf);
+		nano_sem_give(&context->tx_free);
+	}
 }
 
 /* @brief Transmit the current Ethernet frame.
  *
- *        This procedure will block indefinitely until the Ethernet device is
- *        ready to accept a new outgoing frame.  It then copies the current
- *        Ethernet frame from the global uip_buf buffer to the device DMA
- *        buffer and signals to the device that a new frame is available to be
- *        transmitted.
+ *        This procedure waits until a TX descriptor is free, or fails if
+ *        none is when called from an ISR.  It then points the descriptor at
+ *        the frame data of the buffer, holding a reference to the buffer
+ *        until the frame is transmitted, and signals to the device that a
+ *        new frame is available to be transmitted.
  */
 static int eth_tx(struct device *port, struct net_buf *buf)
 {
 	struct eth_runtime *context = port->driver_data;
 	struct eth_config *config = port->config->config_info;
 	uint32_t base_addr = config->base_addr;
+	volatile struct eth_tx_desc *desc;
+	int32_t timeout = TICKS_UNLIMITED;
+	unsigned int key;
+
+	if (uip_len(buf) > UIP_BUFSIZE) {
+		ETH_ERR("Frame too large to TX: %u\n", uip_len(buf));
 
-	/* Wait until the TX descriptor is no longer owned by the device. */
-	while (context->tx_desc.own == 1) {
+		return -1;
 	}
 
-#ifdef CONFIG_ETHERNET_DEBUG
-	/* Check whether an error occurred transmitting the previous frame. */
-	if (context->tx_desc.err_summary) {
-		ETH_ERR("Error transmitting frame: TDES0 = %08x, TDES1 = %08x.\n",
-			context->tx_desc.tdes0, context->tx_desc.tdes1);
+	/* Wait until a TX descriptor is no longer owned by the device. */
+	if (sys_execution_context_type_get() == NANO_CTX_ISR) {
+		timeout = TICKS_NONE;
 	}
-#endif
 
-	/* Transmit the next frame. */
-	if (uip_len(buf) > UIP_BUFSIZE) {
-		ETH_ERR("Frame too large to TX: %u\n", uip_len(buf));
+	if (!nano_sem_take(&context->tx_free, timeout)) {
+		ETH_ERR("No free TX descriptor.\n");
 
 		return -1;
 	}
 
-	memcpy((void *)context->tx_buf, uip_buf(buf), uip_len(buf));
+	/* Transmit the next frame. */
+	key = irq_lock();
+
+	desc = &context->tx_desc[context->tx_head];
+	context->tx_bufs[context->tx_head] = net_buf_ref(buf);
+	context->tx_head = (context->tx_head + 1) % ETH_DW_TX_DESC_COUNT;
 
-	context->tx_desc.tx_buf1_sz = uip_len(buf);
+	desc->buf1_ptr = uip_buf(buf);
+	desc->tx_buf1_sz = uip_len(buf);
 
-	context->tx_desc.own = 1;
+	desc->own = 1;
+
+	irq_unlock(key);
 
 	/* Request that the device check for an available TX descriptor, since
 	 * ownership of the descriptor was just transferred to the device.
@@ -154,15 +238,25 @@ void eth_dw_isr(struct device *port)
 	 * by the shared IRQ driver. So check here if the interrupt
 	 * is coming from the GPIO controller (or somewhere else).
 	 */
-	if ((int_status & STATUS_RX_INT) == 0) {
+	if ((int_status & (STATUS_RX_INT | STATUS_TX_INT)) == 0) {
 		return;
 	}
 #endif
 
-	eth_rx(port);
+	/* Acknowledge the interrupts before handling them, so that frames
+	 * completing meanwhile raise them again.
+	 */
+	eth_write(base_addr, REG_ADDR_STATUS,
+		  int_status & (STATUS_RX_INT | STATUS_TX_INT));
+
+	/* Reclaim TX descriptors first, since receiving may send replies. */
+	if (int_status & STATUS_TX_INT) {
+		eth_tx_done(port);
+	}
 
-	/* Acknowledge the interrupt. */
-	eth_write(base_addr, REG_ADDR_STATUS, STATUS_RX_INT);
+	if (int_status & STATUS_RX_INT) {
+		eth_rx(port);
+	}
 }
 
 #ifdef CONFIG_PCI
@@ -197,6 +291,7 @@ static int eth_initialize(struct device *port)
 	struct eth_runtime *context = port->driver_data;
 	struct eth_config *config = port->config->config_info;
 	uint32_t base_addr;
+	int i;
 
 	union {
 		struct {
@@ -217,30 +312,42 @@ static int eth_initialize(struct device *port)
 
 	net_set_mac(mac_addr.bytes, sizeof(mac_addr.bytes));
 
-	/* Initialize transmit descriptor. */
-	context->tx_desc.tdes0 = 0;
-	context->tx_desc.tdes1 = 0;
+	/* Initialize transmit descriptors. */
+	for (i = 0; i < ETH_DW_TX_DESC_COUNT; i++) {
+		context->tx_desc[i].tdes0 = 0;
+		context->tx_desc[i].tdes1 = 0;
+
+		context->tx_desc[i].first_seg_in_frm = 1;
+		context->tx_desc[i].last_seg_in_frm = 1;
+		context->tx_desc[i].intr_on_complete = 1;
+	}
+	context->tx_desc[ETH_DW_TX_DESC_COUNT - 1].tx_end_of_ring = 1;
+
+	nano_sem_init(&context->tx_free);
+	nano_sem_give_n(&context->tx_free, ETH_DW_TX_DESC_COUNT);
 
-	context->tx_desc.buf1_ptr = (uint8_t *)context->tx_buf;
-	context->tx_desc.tx_end_of_ring = 1;
-	context->tx_desc.first_seg_in_frm = 1;
-	context->tx_desc.last_seg_in_frm = 1;
-	context->tx_desc.tx_end_of_ring = 1;
+	/* Initialize receive descriptors, each holding a receive buffer. */
+	config->config_bufs();
 
-	/* Initialize receive descriptor. */
-	context->rx_desc.rdes0 = 0;
-	context->rx_desc.rdes1 = 0;
+	for (i = 0; i < ETH_DW_RX_DESC_COUNT; i++) {
+		context->rx_bufs[i] = net_buf_get(&context->rx_free, 0);
 
-	context->rx_desc.buf1_ptr = (uint8_t *)context->rx_buf;
-	context->rx_desc.own = 1;
-	context->rx_desc.first_desc = 1;
-	context->rx_desc.last_desc = 1;
-	context->rx_desc.rx_buf1_sz = UIP_BUFSIZE;
-	context->rx_desc.rx_end_of_ring = 1;
+		context->rx_desc[i].rdes0 = 0;
+		context->rx_desc[i].rdes1 = 0;
+
+		context->rx_desc[i].buf1_ptr = context->rx_bufs[i]->data;
+		context->rx_desc[i].own = 1;
+		context->rx_desc[i].first_desc = 1;
+		context->rx_desc[i].last_desc = 1;
+		context->rx_desc[i].rx_buf1_sz = UIP_BUFSIZE;
+	}
+	context->rx_desc[ETH_DW_RX_DESC_COUNT - 1].rx_end_of_ring = 1;
 
 	/* Install transmit and receive descriptors. */
-	eth_write(base_addr, REG_ADDR_RX_DESC_LIST, (uint32_t)&context->rx_desc);
-	eth_write(base_addr, REG_ADDR_TX_DESC_LIST, (uint32_t)&context->tx_desc);
+	eth_write(base_addr, REG_ADDR_RX_DESC_LIST,
+		  (uint32_t)&context->rx_desc[0]);
+	eth_write(base_addr, REG_ADDR_TX_DESC_LIST,
+		  (uint32_t)&context->tx_desc[0]);
 
 	eth_write(base_addr, REG_ADDR_MAC_CONF,
 		  /* Set the RMII speed to 100Mbps */
@@ -255,7 +362,9 @@ static int eth_initialize(struct device *port)
 	eth_write(base_addr, REG_ADDR_INT_ENABLE,
 		  INT_ENABLE_NORMAL |
 		  /* Enable receive interrupts */
-		  INT_ENABLE_RX);
+		  INT_ENABLE_RX |
+		  /* Enable transmit interrupts */
+		  INT_ENABLE_TX);
 
 	eth_write(base_addr, REG_ADDR_DMA_OPERATION,
 		  /* Enable receive store-and-forward mode for simplicity. */
@@ -279,6 +388,7 @@ static int eth_initialize(struct device *port)
 /* Bindings to the plaform */
 #if CONFIG_ETH_DW_0
 static void eth_config_0_irq(struct device *port);
+static void eth_config_0_bufs(void);
 
 static struct eth_config eth_config_0 = {
 	.base_addr		= CONFIG_ETH_DW_0_BASE_ADDR,
@@ -295,6 +405,7 @@ static struct eth_config eth_config_0 = {
 	.pci_dev.bar		= CONFIG_ETH_DW_0_BAR,
 #endif
 	.config_func		= eth_config_0_irq,
+	.config_bufs		= eth_config_0_bufs,
 
 #ifdef CONFIG_ETH_DW_0_IRQ_SHARED
 	.shared_irq_dev_name	= CONFIG_ETH_DW_0_IRQ_SHARED_NAME,
@@ -303,6 +414,9 @@ static struct eth_config eth_config_0 = {
 
 static struct eth_runtime eth_0_runtime;
 
+static NET_BUF_POOL(eth_0_rx_bufs, ETH_DW_RX_BUF_COUNT, UIP_BUFSIZE,
+		    &eth_0_runtime.rx_free, NULL, sizeof(struct ip_buf));
+
 DEVICE_INIT(eth_dw_0, CONFIG_ETH_DW_0_NAME, eth_initialize,
 				&eth_0_runtime, &eth_config_0,
 				NANOKERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEVICE);
@@ -312,12 +426,21 @@ static int eth_net_tx(struct net_buf *buf)
 	return eth_tx(DEVICE_GET(eth_dw_0), buf);
 }
 
+static void eth_config_0_bufs(void)
+{
+	net_buf_pool_init(eth_0_rx_bufs);
+}
+
 static void eth_config_0_irq(struct device *port)
 {
 	struct eth_config *config = port->config->config_info;
 	struct device *shared_irq_dev;
 
-#ifdef CONFIG_ETH_DW_0_IRQ_DIRECT
+#if defined(CONFIG_ETH_DW_LOOPBACK)
+	/* The loopback model calls eth_dw_isr() itself. */
+	ARG_UNUSED(config);
+	ARG_UNUSED(shared_irq_dev);
+#elif defined(CONFIG_ETH_DW_0_IRQ_DIRECT)
 	ARG_UNUSED(shared_irq_dev);
 	IRQ_CONNECT(CONFIG_ETH_DW_0_IRQ, CONFIG_ETH_DW_0_PRI, eth_dw_isr,
 		    DEVICE_GET(eth_dw_0), 0);
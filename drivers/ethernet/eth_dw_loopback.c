@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2016 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Software model of the DesignWare Ethernet device in loopback mode.
+ *
+ * The model stands in for the registers of port 0, so that the descriptor
+ * rings of the driver can be exercised on targets without the device. Like
+ * the DMA engine, it walks the transmit and receive rings the driver
+ * installs, and it moves each frame of a transmit descriptor owned by the
+ * device into the next receive descriptor owned by the device. A frame for
+ * which no receive descriptor is available waits, with its transmit
+ * descriptor, until the driver issues a poll demand.
+ *
+ * The model raises the device interrupts with irq_offload(), and calls
+ * eth_dw_isr() until they are acknowledged; those raised from interrupt
+ * context are handled by the interrupt being serviced.
+ */
+
+#include <nanokernel.h>
+#include <device.h>
+#include <irq_offload.h>
+#include <string.h>
+#include "eth_dw_priv.h"
+
+/* locally administered address read from the MAC address registers */
+#define LOOPBACK_MACADDR_HI 0x00000df0
+#define LOOPBACK_MACADDR_LO 0x15efbe0a
+
+#define LOOPBACK_INT (STATUS_RX_INT | STATUS_TX_INT)
+
+static uint32_t status;
+static uint32_t int_enable;
+static bool held;
+
+/* next descriptors the device processes */
+static volatile struct eth_tx_desc *tx_ring, *tx_next;
+static volatile struct eth_rx_desc *rx_ring, *rx_next;
+
+static void loopback_isr(void *unused)
+{
+	struct device *port = device_get_binding(CONFIG_ETH_DW_0_NAME);
+
+	ARG_UNUSED(unused);
+
+	while (status & int_enable & LOOPBACK_INT) {
+		eth_dw_isr(port);
+	}
+}
+
+static void loopback_run(void)
+{
+	volatile struct eth_tx_desc *tx;
+	volatile struct eth_rx_desc *rx;
+	unsigned int key;
+
+	key = irq_lock();
+
+	while (!held && tx_next && rx_next && tx_next->own && rx_next->own) {
+		tx = tx_next;
+		rx = rx_next;
+
+		memcpy(rx->buf1_ptr, tx->buf1_ptr, tx->tx_buf1_sz);
+
+		rx->rdes0 = 0;
+		rx->frm_len = tx->tx_buf1_sz;
+		rx->first_desc = 1;
+		rx->last_desc = 1;
+
+		tx->own = 0;
+
+		tx_next = tx->tx_end_of_ring ? tx_ring : tx + 1;
+		rx_next = rx->rx_end_of_ring ? rx_ring : rx + 1;
+
+		status |= LOOPBACK_INT;
+	}
+
+	if ((status & int_enable & LOOPBACK_INT) &&
+	    sys_execution_context_type_get() != NANO_CTX_ISR) {
+		irq_offload(loopback_isr, NULL);
+	}
+
+	irq_unlock(key);
+}
+
+uint32_t eth_dw_loopback_read(uint32_t offset)
+{
+	switch (offset) {
+	case REG_ADDR_MACADDR_HI:
+		return LOOPBACK_MACADDR_HI;
+	case REG_ADDR_MACADDR_LO:
+		return LOOPBACK_MACADDR_LO;
+	case REG_ADDR_STATUS:
+		return status;
+	case REG_ADDR_INT_ENABLE:
+		return int_enable;
+	default:
+		return 0;
+	}
+}
+
+void eth_dw_loopback_write(uint32_t offset, uint32_t val)
+{
+	switch (offset) {
+	case REG_ADDR_STATUS:
+		/* status bits are cleared by writing 1 to them */
+		status &= ~val;
+		break;
+	case REG_ADDR_INT_ENABLE:
+		int_enable = val;
+		break;
+	case REG_ADDR_TX_DESC_LIST:
+		tx_ring = tx_next = (volatile struct eth_tx_desc *)val;
+		break;
+	case REG_ADDR_RX_DESC_LIST:
+		rx_ring = rx_next = (volatile struct eth_rx_desc *)val;
+		break;
+	case REG_ADDR_TX_POLL_DEMAND:
+	case REG_ADDR_RX_POLL_DEMAND:
+		loopback_run();
+		break;
+	default:
+		break;
+	}
+}
+
+/* @brief Hold back the frames transmitted, or stop doing so.
+ *
+ *        While held, the transmit descriptors handed to the device are
+ *        neither transmitted nor reclaimed, as on a stalled link.
+ */
+void eth_dw_loopback_hold(bool hold)
+{
+	held = hold;
+	if (!hold) {
+		loopback_run();
+	}
+}
@@ -22,7 +22,10 @@
 #include <pci/pci_mgr.h>
 #endif /* CONFIG_PCI */
 
+#include <stdbool.h>
+#include <device.h>
 #include <misc/util.h>
+#include <net/buf.h>
 
 #include "contiki/ip/uip.h"
 
@@ -31,6 +34,7 @@ extern "C" {
 #endif
 
 typedef void (*eth_config_irq_t)(struct device *port);
+typedef void (*eth_config_bufs_t)(void);
 
 struct eth_config {
 	uint32_t base_addr;
@@ -39,6 +43,7 @@ struct eth_config {
 	struct pci_dev_info pci_dev;
 #endif  /* CONFIG_PCI */
 	eth_config_irq_t config_func;
+	eth_config_bufs_t config_bufs;
 
 #ifdef CONFIG_ETH_DW_SHARED_IRQ
 	char *shared_irq_dev_name;
@@ -48,12 +53,26 @@ struct eth_config {
 /* Refer to Intel Quark SoC X1000 Datasheet, Chapter 15 for more details on
  * Ethernet device operation.
  *
- * This driver puts the Ethernet device into a very simple and space-efficient
- * mode of operation.  It only allocates a single packet descriptor for each of
- * the transmit and receive directions, computes checksums on the CPU, and
- * enables store-and-forward mode for both transmit and receive directions.
+ * This driver puts the Ethernet device into a simple mode of operation.  It
+ * allocates a ring of packet descriptors for each of the transmit and receive
+ * directions, computes checksums on the CPU, and enables store-and-forward
+ * mode for both transmit and receive directions.
+ *
+ * The descriptors point directly at the data of network buffers, so frames
+ * are never copied: each receive descriptor holds a buffer from a pool owned
+ * by the driver, which is handed to the IP stack once a frame is received
+ * into it, and each transmit descriptor holds a reference to the buffer
+ * being sent until the device reports it transmitted.
  */
 
+#define ETH_DW_RX_DESC_COUNT           CONFIG_ETH_DW_RX_DESC_COUNT
+#define ETH_DW_TX_DESC_COUNT           CONFIG_ETH_DW_TX_DESC_COUNT
+#define ETH_DW_RX_BUF_COUNT            CONFIG_ETH_DW_RX_BUF_COUNT
+
+#if ETH_DW_RX_BUF_COUNT <= ETH_DW_RX_DESC_COUNT
+#error "ETH_DW_RX_BUF_COUNT must be larger than ETH_DW_RX_DESC_COUNT"
+#endif
+
 /* Transmit descriptor */
 struct eth_tx_desc {
 	/* First word of transmit descriptor */
@@ -104,8 +123,8 @@ struct eth_tx_desc {
 	};
 	/* Pointer to frame data buffer */
 	uint8_t *buf1_ptr;
-	/* Unused, since this driver initializes only a single descriptor for each
-	 * direction.
+	/* Unused, since this driver places a single buffer in each
+	 * descriptor.
 	 */
 	uint8_t *buf2_ptr;
 };
@@ -152,30 +171,50 @@ struct eth_rx_desc {
 	};
 	/* Pointer to frame data buffer */
 	uint8_t *buf1_ptr;
-	/* Unused, since this driver initializes only a single descriptor for each
-	 * direction.
+	/* Unused, since this driver places a single buffer in each
+	 * descriptor.
 	 */
 	uint8_t *buf2_ptr;
 };
 
 /* Driver metadata associated with each Ethernet device */
 struct eth_runtime {
-	/* Transmit descriptor */
-	volatile struct eth_tx_desc tx_desc;
-	/* Transmit DMA packet buffer */
-	volatile uint8_t tx_buf[UIP_BUFSIZE];
-	/* Receive descriptor */
-	volatile struct eth_rx_desc rx_desc;
-	/* Receive DMA packet buffer */
-	volatile uint8_t rx_buf[UIP_BUFSIZE];
+	/* Transmit descriptor ring */
+	volatile struct eth_tx_desc tx_desc[ETH_DW_TX_DESC_COUNT];
+	/* Buffers being transmitted by each transmit descriptor */
+	struct net_buf *tx_bufs[ETH_DW_TX_DESC_COUNT];
+	/* Next transmit descriptor to fill */
+	int tx_head;
+	/* Oldest transmit descriptor not yet reclaimed */
+	int tx_tail;
+	/* Counts the free transmit descriptors */
+	struct nano_sem tx_free;
+	/* Receive descriptor ring */
+	volatile struct eth_rx_desc rx_desc[ETH_DW_RX_DESC_COUNT];
+	/* Buffers receiving into each receive descriptor */
+	struct net_buf *rx_bufs[ETH_DW_RX_DESC_COUNT];
+	/* Next receive descriptor to be handed back by the device */
+	int rx_head;
+	/* Free receive buffers */
+	struct nano_fifo rx_free;
 };
 
+#ifdef CONFIG_ETH_DW_LOOPBACK
+/* Software model of the device registers, see eth_dw_loopback.c */
+uint32_t eth_dw_loopback_read(uint32_t offset);
+void eth_dw_loopback_write(uint32_t offset, uint32_t val);
+void eth_dw_loopback_hold(bool hold);
+
+void eth_dw_isr(struct device *port);
+#endif  /* CONFIG_ETH_DW_LOOPBACK */
+
 #define MAC_CONF_14_RMII_100M          BIT(14)
 #define MAC_CONF_11_DUPLEX             BIT(11)
 #define MAC_CONF_3_TX_EN               BIT(3)
 #define MAC_CONF_2_RX_EN               BIT(2)
 
 #define STATUS_RX_INT                  BIT(6)
+#define STATUS_TX_INT                  BIT(0)
 
 #define OP_MODE_25_RX_STORE_N_FORWARD  BIT(25)
 #define OP_MODE_21_TX_STORE_N_FORWARD  BIT(21)
@@ -184,6 +223,7 @@ struct eth_runtime {
 
 #define INT_ENABLE_NORMAL              BIT(16)
 #define INT_ENABLE_RX                  BIT(6)
+#define INT_ENABLE_TX                  BIT(0)
 
 #define REG_ADDR_MAC_CONF              0x0000
 #define REG_ADDR_MACADDR_HI            0x0040
@@ -67,12 +67,12 @@
 
 extern struct nano_stack _k_command_stack;
 
+#endif /*  CONFIG_MICROKERNEL */
+
 #ifdef CONFIG_TICKLESS_IDLE
 #define TIMER_SUPPORTS_TICKLESS
 #endif
 
-#endif /*  CONFIG_MICROKERNEL */
-
 #include <board.h>
 
 /* HPET register offsets */
@@ -111,8 +111,8 @@ extern struct nano_stack _k_command_stack;
 
 /*
  * Although the general interrupt status is 64-bits, only a 32-bit access
- * is performed since this driver only utilizes timer0
- * (i.e. there is no need to determine the interrupt status of other timers).
+ * is performed since this driver only utilizes timer0, and timer1 for the
+ * high resolution timers.
  */
 
 #define _HPET_GENERAL_INT_STATUS ((volatile uint32_t *) \
@@ -132,6 +132,11 @@ extern struct nano_stack _k_command_stack;
 #define _HPET_TIMER0_FSB_INT_ROUTE ((volatile uint64_t *) \
 		(CONFIG_HPET_TIMER_BASE_ADDRESS + TIMER0_FSB_INT_ROUTE_REG))
 
+#define _HPET_TIMER1_CONFIG_CAPS ((volatile uint64_t *) \
+		(CONFIG_HPET_TIMER_BASE_ADDRESS + TIMER1_CONFIG_CAP_REG))
+#define _HPET_TIMER1_COMPARATOR ((volatile uint64_t *) \
+		(CONFIG_HPET_TIMER_BASE_ADDRESS + TIMER1_COMPARATOR_REG))
+
 /* general capabilities register macros */
 
 #define HPET_COUNTER_CLK_PERIOD(caps) (caps >> 32)
@@ -184,6 +189,15 @@ extern struct nano_stack _k_command_stack;
 #endif
 
 
+#ifdef CONFIG_SYS_HRTIMER
+/* timer1 is hardwired to IRQ8 in legacy emulation mode */
+#ifdef CONFIG_HPET_TIMER_LEGACY_EMULATION
+#define HPET_HRTIMER_IRQ 8
+#else
+#define HPET_HRTIMER_IRQ CONFIG_HPET_HRTIMER_IRQ
+#endif
+#endif /* CONFIG_SYS_HRTIMER */
+
 #ifdef CONFIG_INT_LATENCY_BENCHMARK
 static uint32_t main_count_first_irq_value;
 static uint32_t main_count_expected_value;
@@ -267,8 +281,6 @@ void _timer_int_handler(void *unused)
 	main_count_expected_value += main_count_first_irq_value;
 #endif
 
-#ifdef CONFIG_MICROKERNEL
-
 #ifndef TIMER_SUPPORTS_TICKLESS
 
 	/*
@@ -296,6 +308,7 @@ void _timer_int_handler(void *unused)
 	*_HPET_TIMER0_COMPARATOR = counter_last_value + counter_load_value;
 	programmed_ticks = 1;
 
+#ifdef CONFIG_MICROKERNEL
 	/*
 	 * Increment the tick because _timer_idle_exit does not account
 	 * for the tick due to the timer interrupt itself. Also, if not in
@@ -314,12 +327,17 @@ void _timer_int_handler(void *unused)
 	if (_sys_idle_elapsed_ticks == 1) {
 		_sys_clock_tick_announce();
 	}
-
-#endif /* !TIMER_SUPPORTS_TICKLESS */
-
 #else
+	/*
+	 * The nanokernel processes the ticks as soon as they are announced, so
+	 * the ticks elapsed while idling have already been announced by
+	 * _timer_idle_exit: only announce the tick of the interrupt itself.
+	 */
+	_sys_idle_elapsed_ticks = 1;
 	_sys_clock_tick_announce();
 #endif /* CONFIG_MICROKERNEL */
+
+#endif /* !TIMER_SUPPORTS_TICKLESS */
 }
 
 #ifdef TIMER_SUPPORTS_TICKLESS
@@ -469,6 +487,99 @@ void _timer_idle_exit(void)
 
 #endif /* TIMER_SUPPORTS_TICKLESS */
 
+#ifdef CONFIG_SYS_HRTIMER
+
+/**
+ *
+ * @brief High resolution timer interrupt handler
+ *
+ * This routine handles the interrupt of timer1, which is programmed in
+ * one-shot mode for the deadline of the first armed high resolution timer.
+ *
+ * @return N/A
+ */
+static void _hrtimer_int_handler(void *unused)
+{
+	ARG_UNUSED(unused);
+
+#if defined(CONFIG_HPET_TIMER_LEVEL_LOW) || defined(CONFIG_HPET_TIMER_LEVEL_HIGH)
+	/* Acknowledge interrupt */
+	*_HPET_GENERAL_INT_STATUS = (1 << 1);
+#endif
+
+	_sys_hrtimer_announce();
+}
+
+/**
+ *
+ * @brief Program the high resolution timer deadline
+ *
+ * This routine loads timer1's comparator with the specified value of the
+ * lower 32 bits of the main counter, and enables its interrupt. A deadline
+ * that is already past, or so close that the comparator could miss it, is
+ * postponed by HPET_COMP_DELAY cycles.
+ *
+ * @return N/A
+ */
+void _timer_hr_deadline_set(uint32_t deadline)
+{
+	unsigned int key = irq_lock();
+	uint32_t now = (uint32_t)*_HPET_MAIN_COUNTER_VALUE;
+
+	if ((int32_t)(deadline - now) < HPET_COMP_DELAY) {
+		deadline = now + HPET_COMP_DELAY;
+	}
+
+	*_HPET_TIMER1_COMPARATOR = deadline;
+	*_HPET_TIMER1_CONFIG_CAPS |= HPET_Tn_INT_ENB_CNF;
+
+	irq_unlock(key);
+}
+
+/**
+ *
+ * @brief Cancel the high resolution timer deadline
+ *
+ * @return N/A
+ */
+void _timer_hr_deadline_cancel(void)
+{
+	*_HPET_TIMER1_CONFIG_CAPS &= ~HPET_Tn_INT_ENB_CNF;
+}
+
+/**
+ *
+ * @brief Set up timer1 for the high resolution timers
+ *
+ * Timer1 is used in 32-bit one-shot mode, so that its comparator matches the
+ * value returned by sys_cycle_get_32(). Its interrupt is left disabled until
+ * a deadline is programmed.
+ *
+ * @return N/A
+ */
+static void _hrtimer_init(void)
+{
+	*_HPET_TIMER1_CONFIG_CAPS =
+		(*_HPET_TIMER1_CONFIG_CAPS &
+		 ~(HPET_Tn_TYPE_CNF | HPET_Tn_INT_ENB_CNF |
+		   HPET_Tn_INT_ROUTE_CNF_MASK))
+		| HPET_Tn_32MODE_CNF
+#if HPET_HRTIMER_IRQ < 32
+		| (HPET_HRTIMER_IRQ << HPET_Tn_INT_ROUTE_CNF_SHIFT)
+#endif
+#if defined(CONFIG_HPET_TIMER_LEVEL_LOW) || defined(CONFIG_HPET_TIMER_LEVEL_HIGH)
+		| HPET_Tn_INT_TYPE_CNF
+#endif
+		;
+
+	IRQ_CONNECT(HPET_HRTIMER_IRQ, CONFIG_HPET_HRTIMER_IRQ_PRIORITY,
+		   _hrtimer_int_handler, 0, HPET_IOAPIC_FLAGS);
+
+	irq_enable(HPET_HRTIMER_IRQ);
+}
+
+#endif /* CONFIG_SYS_HRTIMER */
+
 /**
  *
  * @brief Initialize and enable the system clock
@@ -619,6 +730,10 @@ int _sys_clock_driver_init(struct device *device)
 
 	irq_enable(CONFIG_HPET_TIMER_IRQ);
 
+#ifdef CONFIG_SYS_HRTIMER
+	_hrtimer_init();
+#endif
+
 	/* enable the HPET generally, and timer0 specifically */
 
 	*_HPET_GENERAL_CONFIG |= HPET_ENABLE_CNF;
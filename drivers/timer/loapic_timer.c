@@ -102,9 +102,9 @@
 #define LOAPIC_TIMER_PERIODIC 0x00020000 /* Timer Mode: Periodic */
 
 
-#if defined(CONFIG_MICROKERNEL) && defined(CONFIG_TICKLESS_IDLE)
+#if defined(CONFIG_TICKLESS_IDLE)
 #define TIMER_SUPPORTS_TICKLESS
-#endif /* CONFIG_MICROKERNEL && CONFIG_TICKLESS_IDLE */
+#endif /* CONFIG_TICKLESS_IDLE */
 
 /* Helpful macros and inlines for programming timer */
 #define _REG_TIMER ((volatile uint32_t *) \
@@ -320,6 +320,7 @@ void _timer_int_handler(void *unused /* parameter is not used */
 		timer_mode = TIMER_MODE_PERIODIC;
 	}
 
+#if defined(CONFIG_MICROKERNEL)
 	/*
 	 * Increment the tick because _timer_idle_exit() does not account
 	 * for the tick due to the timer interrupt itself. Also, if not in
@@ -339,20 +340,24 @@ void _timer_int_handler(void *unused /* parameter is not used */
 	if (_sys_idle_elapsed_ticks == 1) {
 		_sys_clock_tick_announce();
 	}
+#else
+	/*
+	 * The nanokernel processes the ticks as soon as they are announced, so
+	 * the ticks elapsed while idling have already been announced (and
+	 * accounted for) by _timer_idle_exit(): only announce the tick of the
+	 * interrupt itself.
+	 */
+	_sys_idle_elapsed_ticks = 1;
+	accumulated_cycle_count += cycles_per_tick;
+	_sys_clock_tick_announce();
+#endif /* CONFIG_MICROKERNEL */
 #else
 	/* track the accumulated cycle count */
 	accumulated_cycle_count += cycles_per_tick;
 
-#if defined(CONFIG_MICROKERNEL)
 	_sys_clock_tick_announce();
-#endif
-
 #endif /*TIMER_SUPPORTS_TICKLESS*/
 
-#if defined(CONFIG_NANOKERNEL)
-	_sys_clock_tick_announce();
-#endif /*  CONFIG_NANOKERNEL */
-
 #ifdef LOAPIC_TIMER_PERIODIC_WORKAROUND
 	/*
 	 * On platforms where the LOAPIC timer periodic mode is broken,
@@ -366,6 +371,24 @@ void _timer_int_handler(void *unused /* parameter is not used */
 }
 
 #if defined(TIMER_SUPPORTS_TICKLESS)
+/**
+ *
+ * @brief Announce the ticks elapsed while idling
+ *
+ * The microkernel consumes the elapsed ticks when it services the tick event,
+ * after _timer_int_handler() has accounted for them. The nanokernel consumes
+ * them right away, so their cycles are accounted for here.
+ *
+ * @return N/A
+ */
+static inline void idle_ticks_announce(void)
+{
+#if defined(CONFIG_NANOKERNEL)
+	accumulated_cycle_count += cycles_per_tick * _sys_idle_elapsed_ticks;
+#endif
+	_sys_clock_tick_announce();
+}
+
 /**
  *
  * @brief Initialize the tickless idle feature
@@ -496,7 +519,7 @@ void _timer_idle_exit(void)
 		 * (The timer ISR reprograms the timer for the next tick.)
 		 */
 
-		_sys_clock_tick_announce();
+		idle_ticks_announce();
 
 		timer_known_to_have_expired = true;
 
@@ -527,7 +550,7 @@ void _timer_idle_exit(void)
 	_sys_idle_elapsed_ticks = programmed_full_ticks - remaining_full_ticks;
 
 	if (_sys_idle_elapsed_ticks > 0) {
-		_sys_clock_tick_announce();
+		idle_ticks_announce();
 	}
 
 	if (remaining_full_ticks > 0) {
@@ -220,6 +220,44 @@ static inline uint64_t _NanoTscRead(void)
 }
 
 
+#if defined(CONFIG_CMPXCHG8B)
+/**
+ *
+ * @brief Atomically read a 64-bit variable
+ *
+ * This routine reads a 64-bit variable in a single instruction, so that it
+ * cannot be torn by an interrupt updating the variable, without locking
+ * interrupts. The 'cmpxchg8b' instruction is given the same value to compare
+ * against and to exchange with: the variable is either left unchanged or
+ * rewritten with its own value, and its contents are loaded in edx:eax.
+ *
+ * @return the value of the variable
+ */
+
+static ALWAYS_INLINE int64_t _do_read_atomic_64(int64_t *target)
+{
+	union {
+		struct  {
+			uint32_t lo;
+			uint32_t hi;
+		};
+		int64_t  value;
+	}  rv;
+
+	__asm__ volatile (
+		"movl %%ebx, %%eax;\n\t"
+		"movl %%ecx, %%edx;\n\t"
+		"lock cmpxchg8b %2;\n\t"
+		: "=&a" (rv.lo), "=&d" (rv.hi), "+m" (*target)
+		:
+		: "memory", "cc"
+		);
+
+	return rv.value;
+}
+#endif /* CONFIG_CMPXCHG8B */
+
+
 /**
  *
  * @brief Get a 32 bit CPU timestamp counter
@@ -55,6 +55,18 @@ extern void _timer_idle_enter(int32_t ticks);
 extern void _timer_idle_exit(void);
 #endif /* TIMER_SUPPORTS_TICKLESS */
 
+#ifdef CONFIG_SYS_HRTIMER
+/*
+ * The driver raises an interrupt when the cycle counter reaches the
+ * deadline, and calls _sys_hrtimer_announce() from it; a deadline that is
+ * already past or too close to be programmed is delivered as soon as
+ * possible.
+ */
+extern void _timer_hr_deadline_set(uint32_t deadline);
+extern void _timer_hr_deadline_cancel(void);
+extern void _sys_hrtimer_announce(void);
+#endif /* CONFIG_SYS_HRTIMER */
+
 extern uint32_t _nano_get_earliest_deadline(void);
 
 extern void _nano_sys_clock_tick_announce(int32_t ticks);
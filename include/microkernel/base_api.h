@@ -22,6 +22,10 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <toolchain.h>
+#include <atomic.h>
+#ifdef CONFIG_MICROKERNEL_TIMER_WHEEL
+#include <nanokernel.h>
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -90,6 +94,19 @@ struct k_msg {
 	} extra;
 };
 
+/* Kernel timer structure */
+
+struct k_timer {
+	struct k_timer *next;
+	struct k_timer *prev;
+	int32_t duration;
+	int32_t period;
+	struct k_args *args;
+#ifdef CONFIG_MICROKERNEL_TIMER_WHEEL
+	struct _nano_timeout timeout;
+#endif
+};
+
 /* Task control block */
 
 struct k_task {
@@ -104,6 +121,12 @@ struct k_task {
 	int worksize;
 	void (*fn_abort)(void);
 	struct k_args *args;
+#ifdef CONFIG_MICROKERNEL_TIMER_WHEEL
+	struct k_timer timeout;	/* timer of the task's timed requests */
+#endif
+#ifdef CONFIG_TIMESLICE_FAIR
+	uint32_t slice_used;	/* cycles executed in the current time slice */
+#endif
 };
 
 /**
@@ -147,6 +170,7 @@ struct _k_sem_struct {
 struct _k_fifo_struct {
 	int Nelms;
 	int element_size;
+	int by_ref;
 	char *base;
 	char *end_point;
 	char *enqueue_point;
@@ -224,17 +248,24 @@ struct _k_pipe_struct {
 #endif
 };
 
-/* Memory map related structure */
+/*
+ * Memory map related structure. Must be aligned on a 4-byte boundary, since
+ * memory maps are also handed to the microkernel server as commands.
+ */
 
 struct _k_mem_map_struct {
 	int Nelms;
 	int element_size;
 	char *base;
+#ifdef CONFIG_MEM_MAP_LOCK_FREE
+	atomic_t free;     /* tag and index of the first free block */
+#else
 	char *free;
+#endif
 	struct k_args *waiters;
-	int num_used;
-	int high_watermark;
-	int count;
+	atomic_t num_used;
+	atomic_t high_watermark;
+	atomic_t count;
 #ifdef CONFIG_DEBUG_TRACING_KERNEL_OBJECTS
 	struct _k_mem_map_struct *next;
 #endif
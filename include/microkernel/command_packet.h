@@ -41,6 +41,27 @@ extern "C" {
 
 typedef uint32_t cmdPkt_t[CMD_PKT_SIZE_IN_WORDS];
 
+#ifdef CONFIG_COMMAND_PACKET_STATS
+
+/* usage statistics of the microkernel server's command packet pool */
+
+struct cmd_pkt_stats {
+	uint32_t used;      /* packets currently in use */
+	uint32_t used_max;  /* highest number of packets ever in use */
+	uint32_t waits;     /* asynchronous sends held back for lack of packets */
+};
+
+/**
+ * @brief Read the command packet usage statistics
+ *
+ * @param stats Structure receiving the statistics.
+ *
+ * @return N/A
+ */
+extern void sys_command_packet_stats_get(struct cmd_pkt_stats *stats);
+
+#endif /* CONFIG_COMMAND_PACKET_STATS */
+
 #ifdef __cplusplus
 }
 #endif
@@ -61,6 +61,24 @@ extern int _task_fifo_ioctl(kfifo_t queue, int op);
 	  .count = 0,\
 	}
 
+/**
+ * @brief Initializer for by-reference microkernel FIFO
+ */
+#define __K_FIFO_REF_DEFAULT(depth, buffer) \
+	{ \
+	  .Nelms = depth,\
+	  .element_size = sizeof(void *),\
+	  .by_ref = 1,\
+	  .base = buffer,\
+	  .end_point = (buffer + (depth * sizeof(void *))),\
+	  .enqueue_point = buffer,\
+	  .dequeue_point = buffer,\
+	  .waiters = NULL,\
+	  .num_used = 0,\
+	  .high_watermark = 0,\
+	  .count = 0,\
+	}
+
 /**
  * @endcond
  */
@@ -72,6 +90,9 @@ extern int _task_fifo_ioctl(kfifo_t queue, int op);
  * then the routine either waits until space becomes available, or until the
  * specified time limit is reached.
  *
+ * In a by-reference FIFO the item is the pointer itself, which is queued
+ * without copying the data it points to.
+ *
  * @param queue FIFO queue.
  * @param data Pointer to data to add to queue.
  * @param timeout Affects the action taken should the FIFO be full. If
@@ -93,6 +114,10 @@ extern int task_fifo_put(kfifo_t queue, void *data, int32_t timeout);
  * currently empty then the routine either waits until an item is added to
  * the FIFO before fetching it, or until the specified time limit is reached.
  *
+ * In a by-reference FIFO the item is a pointer, which is stored at the
+ * location pointed to by @a data; ownership of the data it points to passes
+ * to the caller.
+ *
  * @param queue FIFO queue.
  * @param data Pointer to storage location of the FIFO entry.
  * @param timeout Affects the action taken should the FIFO be empty. If
@@ -123,6 +148,35 @@ extern int task_fifo_get(kfifo_t queue, void *data, int32_t timeout);
  */
 #define task_fifo_purge(q) _task_fifo_ioctl(q, 1)
 
+/**
+ * @brief By-reference FIFO enqueue request
+ *
+ * This routine adds a pointer to a by-reference FIFO. The data it points to
+ * is not copied, and must not be accessed by the caller once the routine has
+ * succeeded; it then belongs to the task that dequeues the pointer.
+ *
+ * @param q By-reference FIFO queue.
+ * @param ptr Pointer to add to queue.
+ * @param timeout As for task_fifo_put().
+ *
+ * @return As for task_fifo_put().
+ */
+#define task_fifo_ref_put(q, ptr, timeout) task_fifo_put(q, ptr, timeout)
+
+/**
+ * @brief By-reference FIFO dequeue request
+ *
+ * This routine fetches the oldest pointer from a by-reference FIFO. The
+ * caller becomes the owner of the data it points to.
+ *
+ * @param q By-reference FIFO queue.
+ * @param pptr Pointer to storage location of the pointer.
+ * @param timeout As for task_fifo_get().
+ *
+ * @return As for task_fifo_get().
+ */
+#define task_fifo_ref_get(q, pptr, timeout) task_fifo_get(q, pptr, timeout)
+
 
 /**
  * @brief Define a private microkernel FIFO
@@ -140,6 +194,21 @@ extern int task_fifo_get(kfifo_t queue, void *data, int32_t timeout);
 	       __K_FIFO_DEFAULT(depth, width, __##name_buffer); \
 	const kfifo_t name = (kfifo_t)&_k_fifo_obj_##name;
 
+/**
+ * @brief Define a private by-reference microkernel FIFO
+ *
+ * This declares and initializes a private FIFO whose items are pointers,
+ * to be passed to task_fifo_ref_put() and task_fifo_ref_get().
+ *
+ * @param name Name of the FIFO
+ * @param depth Depth of the FIFO
+ */
+#define DEFINE_FIFO_REF(name, depth) \
+	static char __noinit __##name##_buffer[(depth * sizeof(void *))]; \
+	struct _k_fifo_struct _k_fifo_obj_##name = \
+	       __K_FIFO_REF_DEFAULT(depth, __##name##_buffer); \
+	const kfifo_t name = (kfifo_t)&_k_fifo_obj_##name;
+
 #ifdef __cplusplus
 }
 #endif
@@ -150,6 +150,38 @@ extern int task_mbox_get(kmbox_t mbox, struct k_msg *M, int32_t timeout);
 extern int task_mbox_data_block_get(struct k_msg *M, struct k_block *block,
 					kmemory_pool_t pool_id, int32_t timeout);
 
+/**
+ * @brief Gets a message from a mailbox into a block, with time limited waiting
+ *
+ * This routine receives a message whose data is returned in a block of the
+ * specified memory pool, which the caller must release once done with it.
+ * When the message was sent using task_mbox_block_put() with a block of
+ * that same pool, the sender's block itself is handed over to the caller
+ * and no data is copied. Otherwise a block is allocated from the pool and
+ * the data is copied into it, as task_mbox_data_block_get() does; should
+ * that allocation fail, the message is left for the caller to retrieve or
+ * discard with task_mbox_data_block_get() or task_mbox_data_get().
+ *
+ * The block of a message without data has a pool ID of -1.
+ *
+ * @param mbox Mailbox
+ * @param M Pointer to message
+ * @param block Block
+ * @param pool_id Memory pool name
+ * @param timeout Affects the action taken should there not be a waiting
+ * sender, or a block to copy the data into. If TICKS_NONE, then return
+ * immediately. If TICKS_UNLIMITED, then wait as long as necessary.
+ * Otherwise wait up to the specified number of ticks before timing out.
+ *
+ * @return RC_OK Successfully received message and its data
+ * @return RC_TIME Timed out while waiting to receive message or its data
+ * @return RC_FAIL Failed to immediately receive message or its data when
+ * @a timeout = TICKS_NONE
+ */
+extern int task_mbox_block_get(kmbox_t mbox, struct k_msg *M,
+			       struct k_block *block, kmemory_pool_t pool_id,
+			       int32_t timeout);
+
 /**
  * @brief Define a private microkernel mailbox
  *
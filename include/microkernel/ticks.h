@@ -64,6 +64,26 @@ extern "C" {
  */
 extern void sys_scheduler_time_slice_set(int32_t t, kpriority_t p);
 
+#ifdef CONFIG_TIMESLICE_PER_PRIORITY
+
+/**
+ * @brief Set the time slicing period of a priority level
+ *
+ * This routine sets the maximum time slice length (in ticks) of the tasks of
+ * priority @a p, regardless of the priority level set with
+ * sys_scheduler_time_slice_set(). A length of zero exempts these tasks from
+ * time slicing, and a negative length makes them use the period and scope
+ * set with sys_scheduler_time_slice_set() again.
+ *
+ * @param p Task priority.
+ * @param t Time slice length (in ticks).
+ *
+ * @return N/A
+ */
+extern void sys_scheduler_time_slice_prio_set(kpriority_t p, int32_t t);
+
+#endif /* CONFIG_TIMESLICE_PER_PRIORITY */
+
 /**
  * @brief Allocate a timer and return its object identifier
  *
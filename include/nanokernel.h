@@ -57,11 +57,29 @@ struct _nano_queue {
 
 #include <misc/dlist.h>
 
+struct _nano_timeout;
+
+typedef void (*_nano_timeout_func_t)(struct _nano_timeout *t);
+
 struct _nano_timeout {
 	sys_dlist_t node;
 	struct _nano_queue *wait_q;
+#ifdef CONFIG_NANO_TIMEOUT_WHEEL
+	uint32_t expiry;
+#else
 	int32_t delta_ticks_from_prev;
+#endif
+	_nano_timeout_func_t func;
+};
+
+#ifdef CONFIG_NANO_FIBER_EDF
+struct _nano_edf {
+	uint32_t deadline;	/* absolute deadline of the current job */
+	uint32_t release;	/* start of the current period */
+	int32_t period;
+	int32_t rel_deadline;	/* 0 if not scheduled by deadline */
 };
+#endif
 /**
  * @endcond
  */
@@ -280,6 +298,41 @@ extern void fiber_delayed_start_cancel(void *handle);
  * @return N/A
  */
 extern void fiber_fiber_delayed_start_cancel(void *handle);
+
+#ifdef CONFIG_NANO_FIBER_EDF
+/**
+ * @brief Schedule the current fiber by earliest deadline
+ *
+ * This routine turns the current fiber into a periodic fiber scheduled by
+ * earliest deadline first. The fiber is moved to the priority reserved by
+ * CONFIG_NANO_FIBER_EDF_PRIO, where the runnable fibers with the earliest
+ * absolute deadline are scheduled first. Its first period starts now.
+ *
+ * This routine can only be called from a fiber.
+ *
+ * @param period Period of the fiber, in system ticks
+ * @param deadline Deadline of each job of the fiber, relative to the start
+ * of its period, in system ticks
+ *
+ * @return N/A
+ */
+extern void fiber_deadline_set(int32_t period, int32_t deadline);
+
+/**
+ * @brief Wait for the next period of the current fiber
+ *
+ * This routine completes the current job of a fiber scheduled by earliest
+ * deadline: the fiber sleeps until the start of its next period, if it has
+ * not started yet, and is then scheduled according to the deadline of its
+ * next job.
+ *
+ * This routine can only be called from a fiber that has called
+ * fiber_deadline_set().
+ *
+ * @return 1 if the deadline of the completed job was missed, 0 otherwise
+ */
+extern int fiber_period_wait(void);
+#endif
 #endif
 
 /**
@@ -380,6 +433,26 @@ extern void nano_fifo_init(struct nano_fifo *fifo);
  */
 extern void nano_fifo_put(struct nano_fifo *fifo, void *data);
 
+/**
+ *
+ * @brief Add a list of elements to the end of a fifo
+ *
+ * This is a convenience wrapper for the execution context-specific APIs. This
+ * is helpful whenever the exact execution context is not known, but should be
+ * avoided when the context is known up-front (to avoid unnecessary overhead).
+ *
+ * The elements must be linked through their first word, which is used by the
+ * fifo, starting with @a head and ending with @a tail. The link in the first
+ * word of @a tail is ignored. The list must contain at least one element.
+ *
+ * @param fifo FIFO on which to interact.
+ * @param head First element of the list.
+ * @param tail Last element of the list.
+ *
+ * @return N/A
+ */
+extern void nano_fifo_put_list(struct nano_fifo *fifo, void *head, void *tail);
+
 /**
  *
  * @brief Get an element from the head a fifo
@@ -425,6 +498,30 @@ extern void *nano_fifo_get(struct nano_fifo *fifo, int32_t timeout_in_ticks);
  */
 extern void nano_isr_fifo_put(struct nano_fifo *fifo, void *data);
 
+/**
+ *
+ * @brief Add a list of elements to the end of a FIFO from an ISR context.
+ *
+ * This routine adds several elements to a fifo object under a single
+ * interrupt lock; it may be called from an ISR context. Each fiber pending on
+ * the fifo object is handed an element, in order, until the waiting fibers or
+ * the elements run out; those fibers are made ready, but will NOT be
+ * scheduled to execute. The remaining elements are linked to the end of the
+ * list.
+ *
+ * The elements must be linked through their first word, which is used by the
+ * fifo, starting with @a head and ending with @a tail. The link in the first
+ * word of @a tail is ignored. The list must contain at least one element.
+ *
+ * @param fifo FIFO on which to interact.
+ * @param head First element of the list.
+ * @param tail Last element of the list.
+ *
+ * @return N/A
+ */
+extern void nano_isr_fifo_put_list(struct nano_fifo *fifo, void *head,
+				   void *tail);
+
 /**
  * @brief Get an element from the head of a FIFO from an ISR context.
  *
@@ -458,6 +555,29 @@ extern void *nano_isr_fifo_get(struct nano_fifo *fifo, int32_t timeout_in_ticks)
  */
 extern void nano_fiber_fifo_put(struct nano_fifo *fifo, void *data);
 
+/**
+ *
+ * @brief Add a list of elements to the end of a FIFO from a fiber.
+ *
+ * This routine adds several elements to a fifo object under a single
+ * interrupt lock; it may be called from a fiber. Each fiber pending on the
+ * fifo object is handed an element, in order, until the waiting fibers or the
+ * elements run out; those fibers are made ready, but will NOT be scheduled to
+ * execute. The remaining elements are linked to the end of the list.
+ *
+ * The elements must be linked through their first word, which is used by the
+ * fifo, starting with @a head and ending with @a tail. The link in the first
+ * word of @a tail is ignored. The list must contain at least one element.
+ *
+ * @param fifo FIFO on which to interact.
+ * @param head First element of the list.
+ * @param tail Last element of the list.
+ *
+ * @return N/A
+ */
+extern void nano_fiber_fifo_put_list(struct nano_fifo *fifo, void *head,
+				     void *tail);
+
 /**
  * @brief Get an element from the head of a FIFO from a fiber.
  *
@@ -498,6 +618,30 @@ extern void *nano_fiber_fifo_get(struct nano_fifo *fifo,
  */
 extern void nano_task_fifo_put(struct nano_fifo *fifo, void *data);
 
+/**
+ *
+ * @brief Add a list of elements to the end of a fifo from a task.
+ *
+ * This routine adds several elements to a fifo object under a single
+ * interrupt lock; it can be called from only a task. Each fiber pending on
+ * the fifo object is handed an element, in order, until the waiting fibers or
+ * the elements run out; those fibers are made ready, and the first one to be
+ * scheduled preempts the running task once all the elements have been
+ * handled. The remaining elements are linked to the end of the list.
+ *
+ * The elements must be linked through their first word, which is used by the
+ * fifo, starting with @a head and ending with @a tail. The link in the first
+ * word of @a tail is ignored. The list must contain at least one element.
+ *
+ * @param fifo FIFO on which to interact.
+ * @param head First element of the list.
+ * @param tail Last element of the list.
+ *
+ * @return N/A
+ */
+extern void nano_task_fifo_put_list(struct nano_fifo *fifo, void *head,
+				    void *tail);
+
 /**
  * @brief Get an element from the head of a FIFO from a task, poll if empty
  *
@@ -741,6 +885,21 @@ extern void nano_sem_init(struct nano_sem *sem);
  */
 extern void nano_sem_give(struct nano_sem *sem);
 
+/**
+ *
+ * @brief Give a nanokernel semaphore several times
+ *
+ * This is a convenience wrapper for the execution context-specific APIs. This
+ * is helpful whenever the exact execution context is not known, but should be
+ * avoided when the context is known up-front (to avoid unnecessary overhead).
+ *
+ * @param sem Pointer to a nano_sem structure.
+ * @param count Number of times to give the semaphore.
+ *
+ * @return N/A
+ */
+extern void nano_sem_give_n(struct nano_sem *sem, int count);
+
 /**
  *
  * @brief Take a nanokernel semaphore, poll/pend if not available
@@ -779,6 +938,22 @@ extern int nano_sem_take(struct nano_sem *sem, int32_t timeout_in_ticks);
  */
 extern void nano_isr_sem_give(struct nano_sem *sem);
 
+/**
+ *
+ * @brief Give a nanokernel semaphore several times (no context switch)
+ *
+ * This routine performs @a count "give" operations on a nanokernel semaphore
+ * object under a single interrupt lock; it may be called from an ISR context.
+ * Up to @a count fibers pending on the semaphore object will be made ready,
+ * but will NOT be scheduled to execute.
+ *
+ * @param sem Pointer to a nano_sem structure.
+ * @param count Number of times to give the semaphore.
+ *
+ * @return N/A
+ */
+extern void nano_isr_sem_give_n(struct nano_sem *sem, int count);
+
 /**
  *
  * @brief Take a nanokernel semaphore, fail if unavailable
@@ -813,6 +988,22 @@ extern int nano_isr_sem_take(struct nano_sem *sem, int32_t timeout_in_ticks);
  */
 extern void nano_fiber_sem_give(struct nano_sem *sem);
 
+/**
+ *
+ * @brief Give a nanokernel semaphore several times (no context switch)
+ *
+ * This routine performs @a count "give" operations on a nanokernel semaphore
+ * object under a single interrupt lock; it may be called from a fiber. Up to
+ * @a count fibers pending on the semaphore object will be made ready, but
+ * will NOT be scheduled to execute.
+ *
+ * @param sem Pointer to a nano_sem structure.
+ * @param count Number of times to give the semaphore.
+ *
+ * @return N/A
+ */
+extern void nano_fiber_sem_give_n(struct nano_sem *sem, int count);
+
 /**
  *
  * @brief Take a nanokernel semaphore, wait or fail if unavailable
@@ -846,6 +1037,23 @@ extern int nano_fiber_sem_take(struct nano_sem *sem, int32_t timeout_in_ticks);
  */
 extern void nano_task_sem_give(struct nano_sem *sem);
 
+/**
+ *
+ * @brief Give a nanokernel semaphore several times
+ *
+ * This routine performs @a count "give" operations on a nanokernel semaphore
+ * object under a single interrupt lock; it can only be called from a task. Up
+ * to @a count fibers pending on the semaphore object will be made ready, and
+ * the first one to be scheduled preempts the running task once all of them
+ * have been made ready.
+ *
+ * @param sem Pointer to a nano_sem structure.
+ * @param count Number of times to give the semaphore.
+ *
+ * @return N/A
+ */
+extern void nano_task_sem_give_n(struct nano_sem *sem, int count);
+
 /**
  *
  * @brief Take a nanokernel semaphore, fail if unavailable
@@ -1049,6 +1257,11 @@ extern void sys_thread_custom_data_set(void *value);
 extern void *sys_thread_custom_data_get(void);
 #endif /* CONFIG_THREAD_CUSTOM_DATA */
 
+/* thread runtime statistics APIs */
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+extern uint64_t sys_thread_runtime_get(nano_thread_id_t thread);
+#endif /* CONFIG_THREAD_RUNTIME_STATS */
+
 /**
  * @}
  * @brief Nanokernel Timers
@@ -1058,8 +1271,7 @@ extern void *sys_thread_custom_data_get(void);
  */
 
 struct nano_timer {
-	struct nano_timer *link;
-	uint32_t ticks;
+	struct _nano_timeout timeout;
 	struct nano_lifo lifo;
 	void *userData;
 #ifdef CONFIG_DEBUG_TRACING_KERNEL_OBJECTS
@@ -1134,6 +1346,22 @@ static inline void *nano_timer_test(struct nano_timer *timer, int32_t timeout_in
  */
 extern void nano_timer_stop(struct nano_timer *timer);
 
+/**
+ * @brief Get nanokernel timer remaining ticks
+ *
+ * This function returns the number of system clock ticks remaining before
+ * a previously started nanokernel timer expires. A timer that has expired
+ * reports 0 whether or not its expiry has been tested yet, as does a timer
+ * that has been stopped or never started.
+ *
+ * It may be called from an ISR, a fiber or a task.
+ *
+ * @param timer Timer to query
+ *
+ * @return remaining ticks, or 0 if the timer has expired or is not running
+ */
+extern int32_t nano_timer_ticks_remain(struct nano_timer *timer);
+
 /* methods for ISRs */
 
 /**
@@ -1319,6 +1547,79 @@ extern int64_t sys_tick_delta(int64_t *reftime);
  */
 extern uint32_t sys_tick_delta_32(int64_t *reftime);
 
+#ifdef CONFIG_SYS_HRTIMER
+struct sys_hrtimer;
+
+/**
+ * @brief High resolution timer expiry function
+ *
+ * An expiry function is invoked in ISR context, with the expired timer as
+ * argument. It may restart that timer, or start and stop any other one.
+ */
+typedef void (*sys_hrtimer_func_t)(struct sys_hrtimer *timer);
+
+struct sys_hrtimer {
+	sys_dnode_t node;
+	uint32_t expiry;	/* absolute expiry, in hardware clock cycles */
+	sys_hrtimer_func_t func;
+};
+
+/**
+ * @brief Initialize a high resolution timer
+ *
+ * This routine initializes a high resolution timer, which expires after a
+ * number of hardware clock cycles rather than system clock ticks, and which
+ * invokes an expiry function instead of waking up a waiting thread.
+ *
+ * @param timer Timer to initialize
+ * @param func Function to invoke, in ISR context, when the timer expires
+ *
+ * @return N/A
+ */
+extern void sys_hrtimer_init(struct sys_hrtimer *timer,
+			     sys_hrtimer_func_t func);
+
+/**
+ * @brief Start a high resolution timer
+ *
+ * This routine arms a high resolution timer to expire after the specified
+ * number of hardware clock cycles, as counted by sys_cycle_get_32(), and
+ * independently of the system clock tick. A timer that is already running
+ * is restarted. The number of cycles must be less than 2^31.
+ *
+ * It may be called from either an ISR, a fiber or a task.
+ *
+ * @param timer Timer to start
+ * @param cycles Number of hardware clock cycles before the timer expires
+ *
+ * @return N/A
+ */
+extern void sys_hrtimer_start(struct sys_hrtimer *timer, uint32_t cycles);
+
+/**
+ * @brief Stop a high resolution timer
+ *
+ * This routine disarms a high resolution timer, if it is running; its
+ * expiry function is not invoked.
+ *
+ * It may be called from either an ISR, a fiber or a task.
+ *
+ * @param timer Timer to stop
+ *
+ * @return N/A
+ */
+extern void sys_hrtimer_stop(struct sys_hrtimer *timer);
+
+/**
+ * @brief Check if a high resolution timer is running
+ *
+ * @param timer Timer to check
+ *
+ * @return 1 if the timer has been started and has not yet expired, else 0
+ */
+extern int sys_hrtimer_is_running(struct sys_hrtimer *timer);
+#endif /* CONFIG_SYS_HRTIMER */
+
 
 /*
  * Lists for object tracing
@@ -37,6 +37,9 @@ struct net_buf {
 	/** FIFO uses first 4 bytes itself, reserve space */
 	int _unused;
 
+	/** Fragments associated with this buffer. */
+	struct net_buf *frags;
+
 	/** Size of the user data associated with this buffer. */
 	const uint16_t user_data_size;
 
@@ -134,7 +137,8 @@ struct net_buf *net_buf_get(struct nano_fifo *fifo, size_t reserve_head);
 /** @brief Decrements the reference count of a buffer.
  *
  *  Decrements the reference count of a buffer and puts it back into the
- *  pool if the count reaches zero.
+ *  pool if the count reaches zero. The fragments of a buffer put back into
+ *  its pool are unreferenced in turn.
  *
  *  @param buf Buffer.
  */
@@ -151,6 +155,8 @@ struct net_buf *net_buf_ref(struct net_buf *buf);
 /** @brief Duplicate buffer
  *
  *  Duplicate given buffer including any data and headers currently stored.
+ *  The fragments of the buffer are not copied: the duplicate shares them,
+ *  taking a reference to the first one.
  *
  *  @param buf Buffer.
  *
@@ -266,6 +272,116 @@ size_t net_buf_headroom(struct net_buf *buf);
  */
 #define net_buf_tail(buf) ((buf)->data + (buf)->len)
 
+/** @brief Find the last fragment in the fragment list.
+ *
+ *  @param frags Buffer or fragment to start from.
+ *
+ *  @return Pointer to the last fragment in the list.
+ */
+struct net_buf *net_buf_frag_last(struct net_buf *frags);
+
+/** @brief Insert a new fragment to a chain of bufs.
+ *
+ *  Insert a new fragment, or a chain of fragments, into the buffer
+ *  fragments list after the parent. The reference of the caller to the
+ *  fragment is handed over to the chain, so the caller must not unref it.
+ *
+ *  @param parent Parent buffer/fragment.
+ *  @param frag Fragment to insert.
+ */
+void net_buf_frag_insert(struct net_buf *parent, struct net_buf *frag);
+
+/** @brief Add a new fragment to the end of a chain of bufs.
+ *
+ *  Append a new fragment, or a chain of fragments, into the buffer
+ *  fragments list. The reference of the caller to the fragment is handed
+ *  over to the chain, so the caller must not unref it.
+ *
+ *  @param head Head of the fragment chain, or NULL.
+ *  @param frag Fragment to add.
+ *
+ *  @return New head of the fragment chain: head, or frag if head is NULL.
+ */
+struct net_buf *net_buf_frag_add(struct net_buf *head, struct net_buf *frag);
+
+/** @brief Delete existing fragment from a chain of bufs.
+ *
+ *  Unlink a fragment from its chain and unref it.
+ *
+ *  @param parent Parent buffer/fragment, or NULL if there is no parent.
+ *  @param frag Fragment to delete.
+ *
+ *  @return Pointer to the fragment following the deleted one, or NULL.
+ */
+struct net_buf *net_buf_frag_del(struct net_buf *parent, struct net_buf *frag);
+
+/** @brief Calculate the amount of data in a chain of bufs.
+ *
+ *  @param buf Head of the fragment chain.
+ *
+ *  @return Number of data bytes held by the buffer and all its fragments.
+ */
+size_t net_buf_frags_len(struct net_buf *buf);
+
+/** @brief Add data at the end of a chain of bufs.
+ *
+ *  Copies data to the tailroom of the last fragment of the chain, then to
+ *  new fragments taken from the given FIFO, which are appended to the
+ *  chain. Large data can thus be held by several small buffers.
+ *
+ *  @param buf Head of the fragment chain.
+ *  @param fifo Which FIFO to take new fragments from.
+ *  @param mem Data to add.
+ *  @param len Number of bytes to add.
+ *
+ *  @return Number of bytes added, which is less than len only if out of
+ *  buffers in an ISR.
+ */
+size_t net_buf_frags_add_mem(struct net_buf *buf, struct nano_fifo *fifo,
+			     const void *mem, size_t len);
+
+/** @brief Push data to the beginning of a chain of bufs.
+ *
+ *  Makes room for len bytes of data, such as a protocol header, in front
+ *  of the data of the chain. The room is taken from the headroom of the
+ *  buffer if large enough. Otherwise, rather than moving the data of the
+ *  chain, a new fragment is taken from the given FIFO and put in front of
+ *  the chain, with the room at its end.
+ *
+ *  @param buf Head of the fragment chain.
+ *  @param fifo Which FIFO to take a new fragment from.
+ *  @param len Number of bytes to add to the beginning.
+ *
+ *  @return New head of the fragment chain, whose data pointer points to the
+ *  room made, or NULL if out of buffers.
+ */
+struct net_buf *net_buf_frags_push(struct net_buf *buf,
+				   struct nano_fifo *fifo, size_t len);
+
+/** @brief Remove data from the beginning of a chain of bufs.
+ *
+ *  Pulls the data from the buffer and its fragments in turn. The fragments
+ *  following the buffer that this empties are deleted from the chain.
+ *
+ *  @param buf Head of the fragment chain.
+ *  @param len Number of bytes to remove.
+ */
+void net_buf_frags_pull(struct net_buf *buf, size_t len);
+
+/** @brief Copy the data of a chain of bufs into a linear buffer.
+ *
+ *  @param dst Destination buffer.
+ *  @param dst_len Size of the destination buffer.
+ *  @param src Head of the fragment chain.
+ *  @param offset Offset of the first byte to copy in the data of the chain.
+ *  @param len Number of bytes to copy.
+ *
+ *  @return Number of bytes copied, limited by dst_len and by the data of
+ *  the chain.
+ */
+size_t net_buf_linearize(void *dst, size_t dst_len, struct net_buf *src,
+			 size_t offset, size_t len);
+
 #ifdef __cplusplus
 }
 #endif
@@ -23,6 +23,9 @@
 #include <micro_private_types.h>
 #include <kernel_main.h>
 #include <nano_private.h>
+#ifdef CONFIG_MICROKERNEL_TIMER_WHEEL
+#include <timeout_wheel.h>
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -44,8 +47,8 @@ extern "C" {
 /* give the specified semaphore */
 #define KERNEL_CMD_SEMAPHORE_TYPE	(2u)
 
-/* not used */
-#define KERNEL_CMD_RESERVED_TYPE	(3u)
+/* hand the free blocks of the specified memory map to its waiting tasks */
+#define KERNEL_CMD_MEM_MAP_TYPE		(3u)
 
 /* mask for isolating the 2 type bits */
 #define KERNEL_CMD_TYPE_MASK		(3u)
@@ -64,8 +67,12 @@ extern int _k_mem_pool_count;
 extern struct k_task *_k_current_task;
 extern uint32_t _k_task_priority_bitmap[];
 
+#ifdef CONFIG_MICROKERNEL_TIMER_WHEEL
+extern struct _nano_timeout_wheel _k_timer_wheel;
+#else
 extern struct k_timer *_k_timer_list_head;
 extern struct k_timer *_k_timer_list_tail;
+#endif
 
 extern struct nano_stack _k_command_stack;
 extern struct nano_lifo _k_server_command_packet_free;
@@ -74,13 +81,23 @@ extern struct nano_lifo _k_timer_free;
 extern void _k_timer_enlist(struct k_timer *T);
 extern void _k_timer_delist(struct k_timer *T);
 
-extern void _k_timeout_alloc(struct k_args *P);
+extern void _k_timeout_alloc(struct k_args *P, struct k_task *task);
 extern void _k_timeout_free(struct k_timer *T);
 extern void _k_timeout_cancel(struct k_args *A);
 
 extern void _k_timer_list_update(int ticks);
 
+#ifdef CONFIG_TIMESLICE_FAIR
+extern void _k_time_slice_switch(void);
+#endif
+#if defined(CONFIG_TIMESLICING) && defined(CONFIG_TICKLESS_IDLE)
+extern int32_t _k_time_slice_ticks_left(void);
+#endif
+
 extern void _k_do_event_signal(kevent_t event);
+#ifdef CONFIG_MEM_MAP_LOCK_FREE
+extern void _k_mem_map_waiters_serve(struct _k_mem_map_struct *M);
+#endif
 
 extern void _k_state_bit_set(struct k_task *, uint32_t);
 extern void _k_state_bit_reset(struct k_task *, uint32_t);
@@ -126,7 +143,7 @@ extern void _k_task_call(struct k_args *);
 #define TF_LOCK 0x00200000     /* Waiting for a mutex */
 #define TF_ALLO 0x00400000     /* Waiting on a memory mapping */
 #define TF_GTBL 0x00800000     /* Waiting on a memory pool */
-#define TF_RES1 0x01000000     /* Reserved */
+#define TF_CPKT 0x01000000     /* Waiting for a command packet */
 #define TF_RES2 0x02000000     /* Reserved */
 #define TF_RECVDATA 0x04000000 /* Waiting to receive data */
 #define TF_SENDDATA 0x08000000 /* Waiting to send data */
@@ -207,21 +224,63 @@ extern void _k_workload_monitor_idle_end(void);
 		}                                       \
 	}
 
+extern struct k_args *_k_command_packet_alloc(void);
+extern void _k_command_packet_free(struct k_args *A);
+extern void _k_command_packet_task_free(struct k_args *A);
+
+#if (CONFIG_COMMAND_PACKET_RESERVE > 0)
+extern bool _k_command_packet_wait(struct k_args *A);
+#else
+#define _k_command_packet_wait(A) (false)
+#endif
+
 #define GETARGS(A)                        \
 	do {                              \
-		(A) = _nano_fiber_lifo_get_panic(&_k_server_command_packet_free); \
+		(A) = _k_command_packet_alloc(); \
 	} while (0)
 #define GETTIMER(T)                        \
 	do {                               \
 		(T) = _nano_fiber_lifo_get_panic(&_k_timer_free); \
 	} while (0)
 
-#define FREEARGS(A) nano_fiber_lifo_put(&_k_server_command_packet_free, (A))
+#define FREEARGS(A) _k_command_packet_free(A)
+#ifdef CONFIG_MICROKERNEL_TIMER_WHEEL
+/*
+ * The timers of the timed requests are embedded in the requesting tasks: only
+ * those allocated with task_timer_alloc() go back to the timer pool.
+ */
+#define FREETIMER(T) do { } while (0)
+#define FREEPOOLTIMER(T) nano_fiber_lifo_put(&_k_timer_free, (T))
+#else
 #define FREETIMER(T) nano_fiber_lifo_put(&_k_timer_free, (T))
+#define FREEPOOLTIMER(T) FREETIMER(T)
+#endif
 
 #define TO_ALIST(L, A) nano_fiber_stack_push((L), (uint32_t)(A))
 
-#define SENDARGS(A) nano_fiber_stack_push(&_k_command_stack, (uint32_t)(A))
+/*
+ * Queue a command (a command packet, or a tagged event or semaphore) for
+ * processing by _k_server, from ISR/fiber or from task context.
+ */
+#ifdef CONFIG_FIFO_COMMAND_QUEUE
+extern void _k_command_isr_put(uint32_t cmd);
+extern void _k_command_task_put(uint32_t cmd);
+extern int _k_command_get(uint32_t *cmd);
+extern void _k_command_wait(uint32_t *cmd);
+
+#define _k_command_isr_push(C) _k_command_isr_put((uint32_t)(C))
+#define _k_command_fiber_push(C) _k_command_isr_put((uint32_t)(C))
+#define _k_command_task_push(C) _k_command_task_put((uint32_t)(C))
+#else
+#define _k_command_isr_push(C) \
+	nano_isr_stack_push(&_k_command_stack, (uint32_t)(C))
+#define _k_command_fiber_push(C) \
+	nano_fiber_stack_push(&_k_command_stack, (uint32_t)(C))
+#define _k_command_task_push(C) \
+	nano_task_stack_push(&_k_command_stack, (uint32_t)(C))
+#endif
+
+#define SENDARGS(A) _k_command_fiber_push(A)
 
 #ifdef __cplusplus
 }
@@ -29,16 +29,6 @@ extern "C" {
 
 typedef union k_args_args K_ARGS_ARGS;
 
-/* Kernel timer structure */
-
-struct k_timer {
-	struct k_timer *next;
-	struct k_timer *prev;
-	int32_t duration;
-	int32_t period;
-	struct k_args *args;
-};
-
 /* Kernel server command codes */
 
 #define _K_SVC_UNDEFINED				(NULL)
@@ -389,15 +379,11 @@ struct k_args {
 /* ---------------------------------------------------------------------- */
 /* KERNEL OBJECT STRUCTURES */
 
-struct block_stat {
-	char *mem_blocks;
-	uint32_t mem_status;
-};
-
 struct pool_block {
 	int block_size;
 	int nr_of_entries;
-	struct block_stat *blocktable;
+	uint32_t *free_bitmap;
+	int nr_free;
 	int count;
 };
 
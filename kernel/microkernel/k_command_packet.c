@@ -43,5 +43,172 @@ void _k_task_call(struct k_args *cmd_packet)
 {
 	cmd_packet->alloc = false;
 	_k_current_task->args = cmd_packet;
-	nano_task_stack_push(&_k_command_stack, (uint32_t)cmd_packet);
+	_k_command_task_push(cmd_packet);
 }
+
+#if defined(CONFIG_COMMAND_PACKET_STATS) || (CONFIG_COMMAND_PACKET_RESERVE > 0)
+#define CMD_PKT_COUNT
+static uint32_t cmd_pkt_used;
+#endif
+
+#ifdef CONFIG_COMMAND_PACKET_STATS
+static uint32_t cmd_pkt_used_max;
+static uint32_t cmd_pkt_waits;
+#endif
+
+#if (CONFIG_COMMAND_PACKET_RESERVE > 0)
+/* asynchronous send requests held back until command packets are freed */
+static struct k_args *cmd_pkt_waiters;
+static struct k_args *cmd_pkt_waiters_tail;
+#endif
+
+/**
+ *
+ * @brief Allocate a command packet from the command packet pool
+ *
+ * The pool is only ever accessed by _k_server, so its free list is handled
+ * directly rather than through the nanokernel LIFO routines, which would lock
+ * interrupts. Running out of command packets is a fatal error.
+ *
+ * @return pointer to the command packet
+ */
+struct k_args *_k_command_packet_alloc(void)
+{
+	struct k_args *A = _k_server_command_packet_free.list;
+
+	if (A == NULL) {
+		/* report the fatal error */
+		return _nano_fiber_lifo_get_panic(&_k_server_command_packet_free);
+	}
+
+	_k_server_command_packet_free.list = A->next;
+
+#ifdef CMD_PKT_COUNT
+	cmd_pkt_used++;
+#endif
+#ifdef CONFIG_COMMAND_PACKET_STATS
+	if (cmd_pkt_used > cmd_pkt_used_max) {
+		cmd_pkt_used_max = cmd_pkt_used;
+	}
+#endif
+
+	return A;
+}
+
+/**
+ *
+ * @brief Return a command packet to the command packet pool
+ *
+ * If more than CONFIG_COMMAND_PACKET_RESERVE packets are then free, the
+ * oldest held back asynchronous send is queued for processing again.
+ *
+ * @param A Command packet
+ * @return N/A
+ */
+void _k_command_packet_free(struct k_args *A)
+{
+	A->next = _k_server_command_packet_free.list;
+	_k_server_command_packet_free.list = A;
+
+#ifdef CMD_PKT_COUNT
+	cmd_pkt_used--;
+#endif
+
+#if (CONFIG_COMMAND_PACKET_RESERVE > 0)
+	if ((cmd_pkt_waiters != NULL) &&
+	    (CONFIG_NUM_COMMAND_PACKETS - cmd_pkt_used >
+	     CONFIG_COMMAND_PACKET_RESERVE)) {
+		struct k_args *W = cmd_pkt_waiters;
+
+		cmd_pkt_waiters = W->next;
+		W->next = NULL;
+		_k_state_bit_reset(W->Ctxt.task, TF_CPKT);
+		SENDARGS(W);
+	}
+#endif
+}
+
+/**
+ *
+ * @brief Return a command packet to the pool from task context
+ *
+ * The free list is only otherwise accessed by _k_server, which can preempt
+ * the calling task, so it is updated with interrupts locked. Held back
+ * asynchronous sends are not resumed here: the caller must follow up with a
+ * request whose processing frees a command packet from _k_server.
+ *
+ * @param A Command packet
+ * @return N/A
+ */
+void _k_command_packet_task_free(struct k_args *A)
+{
+	unsigned int key = irq_lock();
+
+	A->next = _k_server_command_packet_free.list;
+	_k_server_command_packet_free.list = A;
+
+#ifdef CMD_PKT_COUNT
+	cmd_pkt_used--;
+#endif
+
+	irq_unlock(key);
+}
+
+#if (CONFIG_COMMAND_PACKET_RESERVE > 0)
+/**
+ *
+ * @brief Hold back an asynchronous send if command packets are short
+ *
+ * Called by _k_server when it starts processing an asynchronous send request.
+ * While no more than CONFIG_COMMAND_PACKET_RESERVE command packets are free,
+ * the request is set aside and the requesting task waits; the request is
+ * processed again once a command packet is freed and more are then free.
+ *
+ * @param A Asynchronous send request
+ * @return true if the request was held back, false if it may proceed
+ */
+bool _k_command_packet_wait(struct k_args *A)
+{
+	if (CONFIG_NUM_COMMAND_PACKETS - cmd_pkt_used >
+	    CONFIG_COMMAND_PACKET_RESERVE) {
+		return false;
+	}
+
+	/*
+	 * A request held back before still records its task, since the
+	 * handlers call this routine before altering the request.
+	 */
+
+	if (_k_current_task->args == A) {
+		A->Ctxt.task = _k_current_task;
+	}
+	_k_state_bit_set(A->Ctxt.task, TF_CPKT);
+
+	A->next = NULL;
+	if (cmd_pkt_waiters == NULL) {
+		cmd_pkt_waiters = A;
+	} else {
+		cmd_pkt_waiters_tail->next = A;
+	}
+	cmd_pkt_waiters_tail = A;
+
+#ifdef CONFIG_COMMAND_PACKET_STATS
+	cmd_pkt_waits++;
+#endif
+
+	return true;
+}
+#endif
+
+#ifdef CONFIG_COMMAND_PACKET_STATS
+void sys_command_packet_stats_get(struct cmd_pkt_stats *stats)
+{
+	unsigned int key = irq_lock();
+
+	stats->used = cmd_pkt_used;
+	stats->used_max = cmd_pkt_used_max;
+	stats->waits = cmd_pkt_waits;
+
+	irq_unlock(key);
+}
+#endif
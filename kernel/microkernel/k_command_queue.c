@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2016 Wind River Systems, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file
+ * @brief FIFO microkernel server command queue
+ *
+ * This module implements the queue through which commands are handed to the
+ * _k_server fiber when CONFIG_FIFO_COMMAND_QUEUE is enabled. The queue has two
+ * FIFO levels: the commands queued by fibers, by ISRs and by _k_server itself
+ * are handed out ahead of those queued by tasks. Since _k_server processes
+ * every queued command before it switches tasks, the only task command ever
+ * queued is that of the current task.
+ */
+
+#include <micro_private.h>
+#include <nano_private.h>
+#include <toolchain.h>
+#include <sections.h>
+#include <misc/__assert.h>
+
+/* level of the commands queued by fibers, ISRs and _k_server */
+#define KERNEL_LEVEL 0
+/* level of the commands queued by tasks */
+#define TASK_LEVEL 1
+
+#define NUM_LEVELS 2
+
+struct cmd_entry {
+	struct cmd_entry *next;
+	uint32_t cmd;
+};
+
+struct cmd_level {
+	struct cmd_entry *head;
+	struct cmd_entry *tail;
+};
+
+static struct cmd_entry cmd_entries[CONFIG_COMMAND_STACK_SIZE];
+static int cmd_entries_used;
+static struct cmd_entry *cmd_entry_free;
+
+static struct cmd_level cmd_levels[NUM_LEVELS];
+
+/* _k_server, if it is waiting for a command */
+static struct tcs *cmd_server;
+
+/*
+ * must be called with interrupts locked
+ *
+ * Returns 1 if the command was queued, or 0 if the queue is full, which is
+ * a fatal error.
+ */
+static int cmd_put(uint32_t cmd, int level)
+{
+	struct cmd_entry *entry = cmd_entry_free;
+	struct cmd_level *l = &cmd_levels[level];
+
+	/*
+	 * Entries are handed out in array order until they have all been used
+	 * once, after which they are recycled through the free list; this
+	 * spares the need for an initialization routine, since commands can be
+	 * queued by ISRs before the microkernel is initialized.
+	 */
+
+	if (entry) {
+		cmd_entry_free = entry->next;
+	} else if (cmd_entries_used < CONFIG_COMMAND_STACK_SIZE) {
+		entry = &cmd_entries[cmd_entries_used++];
+	} else {
+		__ASSERT(0, "microkernel server command queue overflow\n");
+		_NanoFatalErrorHandler(_NANO_ERR_ALLOCATION_FAIL, &_default_esf);
+		return 0;
+	}
+
+	entry->cmd = cmd;
+	entry->next = NULL;
+
+	if (l->head) {
+		l->tail->next = entry;
+	} else {
+		l->head = entry;
+	}
+	l->tail = entry;
+
+	return 1;
+}
+
+/**
+ *
+ * @brief Queue a command from a fiber or an ISR
+ *
+ * The command is queued ahead of those queued by tasks. The waiting
+ * _k_server fiber is made ready, but is NOT scheduled to execute.
+ *
+ * @param cmd Command packet, or tagged event or semaphore
+ *
+ * @return N/A
+ */
+void _k_command_isr_put(uint32_t cmd)
+{
+	unsigned int imask = irq_lock();
+
+	if (cmd_put(cmd, KERNEL_LEVEL) && cmd_server) {
+		_nano_fiber_ready(cmd_server);
+		cmd_server = NULL;
+	}
+
+	irq_unlock(imask);
+}
+
+/**
+ *
+ * @brief Queue a command from the current task
+ *
+ * The command is queued behind those queued by fibers and ISRs, and the
+ * waiting _k_server fiber is scheduled to execute.
+ *
+ * @param cmd Command packet
+ *
+ * @return N/A
+ */
+void _k_command_task_put(uint32_t cmd)
+{
+	unsigned int imask = irq_lock();
+
+	if (cmd_put(cmd, TASK_LEVEL) && cmd_server) {
+		_nano_fiber_ready(cmd_server);
+		cmd_server = NULL;
+		_Swap(imask);
+		return;
+	}
+
+	irq_unlock(imask);
+}
+
+/* must be called with interrupts locked */
+static int cmd_get(uint32_t *cmd)
+{
+	struct cmd_level *l = &cmd_levels[KERNEL_LEVEL];
+	struct cmd_entry *entry;
+
+	if (!l->head) {
+		l = &cmd_levels[TASK_LEVEL];
+		if (!l->head) {
+			return 0;
+		}
+	}
+
+	entry = l->head;
+	l->head = entry->next;
+
+	*cmd = entry->cmd;
+	entry->next = cmd_entry_free;
+	cmd_entry_free = entry;
+
+	return 1;
+}
+
+/**
+ *
+ * @brief Dequeue the next command
+ *
+ * This routine is only called by _k_server, which processes every queued
+ * command before it switches to another task: the command handlers take the
+ * requesting task to be the current one.
+ *
+ * @param cmd Container for the command
+ *
+ * @return 1 if a command was dequeued; 0 otherwise
+ */
+int _k_command_get(uint32_t *cmd)
+{
+	unsigned int imask = irq_lock();
+	int rc = cmd_get(cmd);
+
+	irq_unlock(imask);
+	return rc;
+}
+
+/**
+ *
+ * @brief Wait for a command
+ *
+ * This routine is only called by _k_server, which it blocks until a command
+ * has been queued.
+ *
+ * @param cmd Container for the command
+ *
+ * @return N/A
+ */
+void _k_command_wait(uint32_t *cmd)
+{
+	unsigned int imask = irq_lock();
+
+	while (!cmd_get(cmd)) {
+		cmd_server = _nanokernel.current;
+		_Swap(imask);
+		imask = irq_lock();
+	}
+
+	irq_unlock(imask);
+}
@@ -116,7 +116,7 @@ void _k_event_test(struct k_args *A)
 					A->Time.timer = NULL;
 				} else {
 					A->Comm = _K_SVC_EVENT_TEST_TIMEOUT;
-					_k_timeout_alloc(A);
+					_k_timeout_alloc(A, A->Ctxt.task);
 				}
 #endif
 			} else {
@@ -133,9 +133,34 @@ void _k_event_test(struct k_args *A)
 int task_event_recv(kevent_t event, int32_t timeout)
 {
 	struct k_args A;
+#ifdef CONFIG_MICROKERNEL_FAST_PATH
+	struct _k_event_struct *E = (struct _k_event_struct *)event;
+	unsigned int key;
+#endif
 
 	ASSERT_EVENT_IS_VALID(event, __func__);
 
+#ifdef CONFIG_MICROKERNEL_FAST_PATH
+	key = irq_lock();
+
+	/*
+	 * Locking interrupts keeps the microkernel server fiber from running,
+	 * so an event that has already been signalled can be received directly.
+	 */
+
+	if (E->status) {
+		E->status = 0;
+		irq_unlock(key);
+		return RC_OK;
+	}
+
+	irq_unlock(key);
+
+	if (timeout == TICKS_NONE) {
+		return RC_FAIL;
+	}
+#endif
+
 	A.Comm = _K_SVC_EVENT_TEST;
 	A.args.e1.event = event;
 	A.Time.ticks = timeout;
@@ -203,9 +228,33 @@ void _k_event_signal(struct k_args *A)
 int task_event_send(kevent_t event)
 {
 	struct k_args A;
+#ifdef CONFIG_MICROKERNEL_FAST_PATH
+	struct _k_event_struct *E = (struct _k_event_struct *)event;
+	unsigned int key;
+#endif
 
 	ASSERT_EVENT_IS_VALID(event, __func__);
 
+#ifdef CONFIG_MICROKERNEL_FAST_PATH
+	key = irq_lock();
+
+	/*
+	 * Without a handler to run or a task to wake up, signalling the event
+	 * simply marks it as received.
+	 */
+
+	if ((E->func == NULL) && (E->waiter == NULL)) {
+		E->status = 1;
+#ifdef CONFIG_OBJECT_MONITOR
+		E->count++;
+#endif
+		irq_unlock(key);
+		return RC_OK;
+	}
+
+	irq_unlock(key);
+#endif
+
 	A.Comm = _K_SVC_EVENT_SIGNAL;
 	A.args.e1.event = event;
 	KERNEL_ENTRY(&A);
@@ -218,6 +267,5 @@ void isr_event_send(kevent_t event)
 {
 	ASSERT_EVENT_IS_VALID(event, __func__);
 
-	nano_isr_stack_push(&_k_command_stack,
-						(uint32_t)event | KERNEL_CMD_EVENT_TYPE);
+	_k_command_isr_push((uint32_t)event | KERNEL_CMD_EVENT_TYPE);
 }
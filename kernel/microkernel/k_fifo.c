@@ -30,6 +30,41 @@
 #include <toolchain.h>
 #include <sections.h>
 
+/**
+ *
+ * @brief Store the item of a FIFO enqueue request
+ *
+ * The item is copied to @a p, unless the FIFO is a by-reference one, in which
+ * case the pointer @a data is stored at @a p instead.
+ *
+ * @return N/A
+ */
+static inline void _k_fifo_item_put(struct _k_fifo_struct *Q, char *p,
+				    char *data)
+{
+	if (Q->by_ref) {
+		*(char **)p = data;
+	} else {
+		memcpy(p, data, OCTET_TO_SIZEOFUNIT(Q->element_size));
+	}
+}
+
+/**
+ *
+ * @brief Hand over an item from the ring buffer of a FIFO
+ *
+ * @return N/A
+ */
+static inline void _k_fifo_item_get(struct _k_fifo_struct *Q, char *p,
+				    char *q)
+{
+	if (Q->by_ref) {
+		*(char **)p = *(char **)q;
+	} else {
+		memcpy(p, q, OCTET_TO_SIZEOFUNIT(Q->element_size));
+	}
+}
+
 /**
  *
  * @brief Finish performing an incomplete FIFO enqueue request
@@ -92,7 +127,7 @@ void _k_fifo_enque_request(struct k_args *A)
 		if (W) {
 			Q->waiters = W->next;
 			p = W->args.q1.data;
-			memcpy(p, q, w);
+			_k_fifo_item_put(Q, p, q);
 
 #ifdef CONFIG_SYS_CLOCK_EXISTS
 			if (W->Time.timer) {
@@ -108,7 +143,7 @@ void _k_fifo_enque_request(struct k_args *A)
 #endif
 		else {
 			p = Q->enqueue_point;
-			memcpy(p, q, w);
+			_k_fifo_item_put(Q, p, q);
 			p = (char *)((int)p + w);
 			if (p == Q->end_point)
 				Q->enqueue_point = Q->base;
@@ -136,7 +171,7 @@ void _k_fifo_enque_request(struct k_args *A)
 				A->Time.timer = NULL;
 			else {
 				A->Comm = _K_SVC_FIFO_ENQUE_REPLY_TIMEOUT;
-				_k_timeout_alloc(A);
+				_k_timeout_alloc(A, A->Ctxt.task);
 			}
 #endif
 		} else {
@@ -218,7 +253,7 @@ void _k_fifo_deque_request(struct k_args *A)
 	n = Q->num_used;
 	if (n) {
 		q = Q->dequeue_point;
-		memcpy(p, q, w);
+		_k_fifo_item_get(Q, p, q);
 		q = (char *)((int)q + w);
 		if (q == Q->end_point)
 			Q->dequeue_point = Q->base;
@@ -232,7 +267,7 @@ void _k_fifo_deque_request(struct k_args *A)
 			p = Q->enqueue_point;
 			q = W->args.q1.data;
 			w = OCTET_TO_SIZEOFUNIT(Q->element_size);
-			memcpy(p, q, w);
+			_k_fifo_item_put(Q, p, q);
 			p = (char *)((int)p + w);
 			if (p == Q->end_point)
 				Q->enqueue_point = Q->base;
@@ -267,7 +302,7 @@ void _k_fifo_deque_request(struct k_args *A)
 				A->Time.timer = NULL;
 			else {
 				A->Comm = _K_SVC_FIFO_DEQUE_REPLY_TIMEOUT;
-				_k_timeout_alloc(A);
+				_k_timeout_alloc(A, A->Ctxt.task);
 			}
 #endif
 		} else {
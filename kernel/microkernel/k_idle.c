@@ -325,6 +325,9 @@ void _sys_power_save_idle_exit(int32_t ticks)
  *
  * @brief Obtain number of ticks until next timer expires
  *
+ * The end of the time slice of the idle task counts as a timer expiry, when
+ * another task shares its priority level.
+ *
  * Must be called with interrupts locked to prevent the timer queues from
  * changing.
  *
@@ -333,11 +336,21 @@ void _sys_power_save_idle_exit(int32_t ticks)
  */
 static inline int32_t _get_next_timer_expiry(void)
 {
+#ifdef CONFIG_MICROKERNEL_TIMER_WHEEL
+	uint32_t closest_deadline =
+		_nano_timeout_wheel_earliest(&_k_timer_wheel);
+#else
 	uint32_t closest_deadline = (uint32_t)TICKS_UNLIMITED;
 
 	if (_k_timer_list_head) {
 		closest_deadline = _k_timer_list_head->duration;
 	}
+#endif
+
+#if defined(CONFIG_TIMESLICING) && defined(CONFIG_TICKLESS_IDLE)
+	closest_deadline = min(closest_deadline,
+			       (uint32_t)_k_time_slice_ticks_left());
+#endif
 
 	return (int32_t)min(closest_deadline, _nano_get_earliest_deadline());
 }
@@ -37,6 +37,7 @@ char __noinit __stack _k_server_stack[CONFIG_MICROKERNEL_SERVER_STACK_SIZE];
 int _k_debug_halt;
 #endif
 
+#ifndef CONFIG_FIFO_COMMAND_QUEUE
 #ifdef CONFIG_INIT_STACKS
 static uint32_t _k_server_command_stack_storage
 						[CONFIG_COMMAND_STACK_SIZE] = {
@@ -49,6 +50,7 @@ static uint32_t __noinit _k_server_command_stack_storage
 struct nano_stack _k_command_stack = {NULL,
 				  _k_server_command_stack_storage,
 				  _k_server_command_stack_storage};
+#endif /* !CONFIG_FIFO_COMMAND_QUEUE */
 
 
 extern void _k_server(int unused1, int unused2);
@@ -85,6 +87,10 @@ void _main(void)
 	 */
 	_k_init_dynamic();
 
+#ifdef CONFIG_MICROKERNEL_TIMER_WHEEL
+	_nano_timeout_wheel_init(&_k_timer_wheel);
+#endif
+
 	task_fiber_start(_k_server_stack,
 			   CONFIG_MICROKERNEL_SERVER_STACK_SIZE,
 			   _k_server,
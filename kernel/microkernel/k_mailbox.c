@@ -194,6 +194,46 @@ static bool prepare_transfer(struct k_args *move,
 	return 0; /* == don't care actually */
 }
 
+/**
+ * @brief Hand the block posted by a sender over to a block receiver
+ *
+ * A receiver using task_mbox_block_get() takes ownership of the memory pool
+ * block posted by a sender using task_mbox_block_put(), provided that it
+ * comes from the pool the receiver asked for, so that no data is copied.
+ *
+ * The receiver passes that pool in the [tx_block] field of its message,
+ * which is otherwise unused when receiving, but which match() overwrites:
+ * it must be read before the match.
+ *
+ * A receiver that takes no data gets no block: the sender's block is left to
+ * be released when the send is acknowledged.
+ *
+ * @param reader the matched reader
+ * @param writer the matched writer
+ * @param rx_pool pool asked for by the reader, or 0
+ *
+ * @return true if the block was handed over, false otherwise
+ */
+static bool block_handover(struct k_args *reader, struct k_args *writer,
+			   kmemory_pool_t rx_pool)
+{
+	if ((rx_pool == 0) || (reader->args.m1.mess.size == 0) ||
+	    !ISASYNCMSG(&(writer->args.m1.mess)) ||
+	    (writer->args.m1.mess.tx_block.pool_id != rx_pool)) {
+		return false;
+	}
+
+	/* match() has already passed the block on to the reader */
+	prepare_transfer(NULL, reader, writer);
+
+	/* the block now belongs to the reader: do not release it */
+	writer->args.m1.mess.tx_block.pool_id = (uint32_t)(-1);
+
+	SENDARGS(reader);
+	SENDARGS(writer);
+	return true;
+}
+
 /**
  * @brief Do transfer
  *
@@ -309,6 +349,11 @@ void _k_mbox_send_request(struct k_args *Writer)
 
 	bAsync = ISASYNCMSG(&Writer->args.m1.mess);
 
+	if (bAsync && _k_command_packet_wait(Writer)) {
+		/* posted message held back until command packets are freed */
+		return;
+	}
+
 	struct k_task *sender = NULL;
 
 	/*
@@ -347,6 +392,9 @@ void _k_mbox_send_request(struct k_args *Writer)
 	     temp = CopyReader, CopyReader = CopyReader->next) {
 		uint32_t u32Size;
 
+		kmemory_pool_t rx_pool;
+
+		rx_pool = CopyReader->args.m1.mess.tx_block.pool_id;
 		u32Size = match(CopyReader, CopyWriter);
 
 		if (u32Size != (uint32_t)(-1)) {
@@ -382,6 +430,9 @@ void _k_mbox_send_request(struct k_args *Writer)
 				prepare_transfer(NULL, CopyReader, CopyWriter);
 				SENDARGS(CopyReader);
 				SENDARGS(CopyWriter);
+			} else if (block_handover(CopyReader, CopyWriter,
+						  rx_pool)) {
+				/* No data exchange--the block changes hands */
 			} else {
 				struct k_args *Moved_req;
 
@@ -436,7 +487,7 @@ void _k_mbox_send_request(struct k_args *Writer)
 			 * This is a wait with timeout operation.
 			 * Enlist a new timeout.
 			 */
-			_k_timeout_alloc(CopyWriter);
+			_k_timeout_alloc(CopyWriter, sender);
 		}
 #endif
 	} else {
@@ -535,11 +586,13 @@ void _k_mbox_receive_request(struct k_args *Reader)
 	struct k_args *CopyWriter;
 	struct k_args *temp;
 	struct k_args *CopyReader;
+	kmemory_pool_t rx_pool;
 
 	Reader->Ctxt.task = _k_current_task;
 	_k_state_bit_set(Reader->Ctxt.task, TF_RECV);
 
 	copy_packet(&CopyReader, Reader);
+	rx_pool = CopyReader->args.m1.mess.tx_block.pool_id;
 
 	/*
 	 * The [next] field can be changed later when added to the Reader's
@@ -589,6 +642,9 @@ void _k_mbox_receive_request(struct k_args *Reader)
 				prepare_transfer(NULL, CopyReader, CopyWriter);
 				SENDARGS(CopyReader);
 				SENDARGS(CopyWriter);
+			} else if (block_handover(CopyReader, CopyWriter,
+						  rx_pool)) {
+				/* No data exchange--the block changes hands */
 			} else {
 				struct k_args *Moved_req;
 
@@ -634,7 +690,7 @@ void _k_mbox_receive_request(struct k_args *Reader)
 			 * This is a wait with timeout operation.
 			 * Enlist a new timeout.
 			 */
-			_k_timeout_alloc(CopyReader);
+			_k_timeout_alloc(CopyReader, Reader->Ctxt.task);
 		}
 #endif
 	} else {
@@ -666,6 +722,7 @@ int task_mbox_get(kmbox_t mbox, struct k_msg *M, int32_t timeout)
 	A.Comm = _K_SVC_MBOX_RECEIVE_REQUEST;
 	A.Time.ticks = timeout;
 	A.args.m1.mess = *M;
+	A.args.m1.mess.tx_block.pool_id = 0; /* no block handover */
 
 	KERNEL_ENTRY(&A);
 	*M = A.args.m1.mess;
@@ -769,10 +826,47 @@ void _task_mbox_data_get(struct k_msg *M)
 }
 
 
+/**
+ * @brief Copy the data of a received message into a new block
+ *
+ * This is the 'normal' flow of task_mbox_data_block_get(), that allocates a
+ * block from the memory pool and copies the message data into it.
+ *
+ * @return RC_OK on success, or the failure of the block allocation
+ */
+static int data_block_copy(struct k_msg *M, struct k_block *block,
+			   kmemory_pool_t pool_id, int32_t timeout)
+{
+	int retval;
+
+	if (M->size != 0) {
+		retval = task_mem_pool_alloc(block, pool_id,
+					M->size, timeout);
+		if (retval != RC_OK) {
+			return retval;
+		}
+		M->rx_data = block->pointer_to_data;
+	} else {
+		block->pool_id = (kmemory_pool_t) -1;
+	}
+
+	/*
+	 * Invoke task_mbox_data_get() core without sanity checks, as they have
+	 * already been performed.
+	 */
+
+	struct k_args A;
+
+	A.args.m1.mess = *M;
+	A.Comm = _K_SVC_MBOX_RECEIVE_DATA;
+	KERNEL_ENTRY(&A);
+
+	return RC_OK; /* task_mbox_data_get() doesn't return anything */
+}
+
 int task_mbox_data_block_get(struct k_msg *M, struct k_block *block,
 			  kmemory_pool_t pool_id, int32_t timeout)
 {
-	int retval;
 	struct k_args *MoveD;
 
 	/* sanity checks: */
@@ -813,7 +907,6 @@ int task_mbox_data_block_get(struct k_msg *M, struct k_block *block,
 		__ASSERT_NO_MSG(Writer->next == NULL);
 
 		Writer->args.m1.mess.tx_block.pool_id = (uint32_t)(-1);
-		nano_task_stack_push(&_k_command_stack, (uint32_t)Writer);
 
 #ifdef ACTIV_ASSERTS
 		struct k_args *dummy;
@@ -827,36 +920,61 @@ int task_mbox_data_block_get(struct k_msg *M, struct k_block *block,
 		__ASSERT_NO_MSG(dummy == NULL);
 #endif
 
-		FREEARGS(MoveD); /* Clean up MOVED */
+		/*
+		 * Clean up MOVED before releasing the writer: the writer's
+		 * copy is freed by _k_server, which then resumes any
+		 * asynchronous send held back for want of command packets.
+		 */
+
+		_k_command_packet_task_free(MoveD);
+		_k_command_task_push(Writer);
 
 		return RC_OK;
 	}
 
-	/* 'normal' flow of task_mbox_data_block_get(): */
+	return data_block_copy(M, block, pool_id, timeout);
+}
 
-	if (M->size != 0) {
-		retval = task_mem_pool_alloc(block, pool_id,
-					M->size, timeout);
-		if (retval != RC_OK) {
-			return retval;
-		}
-		M->rx_data = block->pointer_to_data;
-	} else {
-		block->pool_id = (kmemory_pool_t) -1;
-	}
+int task_mbox_block_get(kmbox_t mbox, struct k_msg *M, struct k_block *block,
+			kmemory_pool_t pool_id, int32_t timeout)
+{
+	struct k_args A;
 
-	/*
-	 * Invoke task_mbox_data_get() core without sanity checks, as they have
-	 * already been performed.
-	 */
+	__ASSERT(pool_id != 0, "Invalid memory pool\n");
 
-	struct k_args A;
+	M->rx_task = _k_current_task->id;
+	M->rx_data = NULL;
+	M->mailbox = mbox;
+	M->extra.transfer = 0;
 
+	A.priority = _k_current_task->priority;
+	A.Comm = _K_SVC_MBOX_RECEIVE_REQUEST;
+	A.Time.ticks = timeout;
 	A.args.m1.mess = *M;
-	A.Comm = _K_SVC_MBOX_RECEIVE_DATA;
+	A.args.m1.mess.tx_block.pool_id = pool_id; /* see block_handover() */
+
 	KERNEL_ENTRY(&A);
+	*M = A.args.m1.mess;
+	if (A.Time.rcode != RC_OK) {
+		return A.Time.rcode;
+	}
 
-	return RC_OK; /* task_mbox_data_get() doesn't return anything */
+	if (M->extra.transfer == NULL) {
+		/* the sender's block was handed over, or there is no data */
+		if (M->size != 0) {
+			*block = M->tx_block;
+		} else {
+			block->pool_id = (kmemory_pool_t) -1;
+		}
+		return RC_OK;
+	}
+
+	/* the data was not sent in a block of the pool: copy it */
+	if (M->tx_block.pool_id == pool_id) {
+		/* sent from a buffer, which left the pool in [tx_block] */
+		M->tx_block.pool_id = 0;
+	}
+	return data_block_copy(M, block, pool_id, timeout);
 }
 
 /**
@@ -20,12 +20,93 @@
 
 #include <micro_private.h>
 #include <sections.h>
+#include <misc/__assert.h>
 
 #include <microkernel/memory_map.h>
 
 extern kmemory_map_t _k_mem_map_ptr_start[];
 extern kmemory_map_t _k_mem_map_ptr_end[];
 
+#ifdef CONFIG_MEM_MAP_LOCK_FREE
+
+/*
+ * The free blocks of a memory map form a LIFO list that is updated with
+ * atomic compare-and-swap operations, so that tasks, fibers and ISRs can
+ * allocate and free blocks directly. The first word of a free block holds the
+ * index plus one of the next free block, or zero for the last one. The head
+ * of the list, in the [free] field of the memory map, holds the index plus
+ * one of the first free block in its low 16 bits, and a tag in its high 16
+ * bits that every update of the head changes. The tag makes the update fail
+ * if the head block was allocated and freed again since the head was read,
+ * in which case the next free block read from it may be stale.
+ */
+
+#define FREE_INDEX_MASK 0xffff
+#define FREE_TAG_INC 0x10000
+
+/**
+ * @brief Take the first block off the free list of a memory map
+ *
+ * @return pointer to the block, or NULL if there is no free block
+ */
+static void *mem_map_block_get(struct _k_mem_map_struct *M)
+{
+	atomic_val_t head;
+	atomic_val_t new_head;
+	char *block;
+
+	do {
+		head = M->free;
+		if ((head & FREE_INDEX_MASK) == 0) {
+			return NULL;
+		}
+		block = M->base + ((head & FREE_INDEX_MASK) - 1) *
+			OCTET_TO_SIZEOFUNIT(M->element_size);
+		new_head = ((head + FREE_TAG_INC) & ~FREE_INDEX_MASK) |
+			*(int *)block;
+	} while (!atomic_cas(&M->free, head, new_head));
+
+#ifdef CONFIG_OBJECT_MONITOR
+	atomic_val_t used = atomic_inc(&M->num_used) + 1;
+	atomic_val_t high_watermark;
+
+	atomic_inc(&M->count);
+	do {
+		high_watermark = M->high_watermark;
+		if (high_watermark >= used) {
+			break;
+		}
+	} while (!atomic_cas(&M->high_watermark, high_watermark, used));
+#else
+	atomic_inc(&M->num_used);
+#endif
+
+	return block;
+}
+
+/**
+ * @brief Put a block back on the free list of a memory map
+ *
+ * @return N/A
+ */
+static void mem_map_block_put(struct _k_mem_map_struct *M, char *block)
+{
+	int index = (block - M->base) / OCTET_TO_SIZEOFUNIT(M->element_size);
+	atomic_val_t head;
+	atomic_val_t new_head;
+
+	do {
+		head = M->free;
+		*(int *)block = head & FREE_INDEX_MASK;
+		new_head = ((head + FREE_TAG_INC) & ~FREE_INDEX_MASK) |
+			(index + 1);
+	} while (!atomic_cas(&M->free, head, new_head));
+
+	atomic_dec(&M->num_used);
+}
+
+#endif /* CONFIG_MEM_MAP_LOCK_FREE */
+
 /**
  * @brief Initialize kernel memory map subsystem
  *
@@ -50,12 +131,23 @@ void _k_mem_map_init(void)
 		p = M->base;
 		q = NULL;
 
+#ifdef CONFIG_MEM_MAP_LOCK_FREE
+		__ASSERT(M->Nelms <= FREE_INDEX_MASK,
+			 "too many blocks in a lock-free memory map\n");
+
+		for (j = 0; j < M->Nelms; j++) {
+			*(int *)p = j;
+			p += w;
+		}
+		M->free = M->Nelms;
+#else
 		for (j = 0; j < M->Nelms; j++) {
 			*(char **)p = q;
 			q = p;
 			p += w;
 		}
 		M->free = q;
+#endif
 		M->num_used = 0;
 		M->high_watermark = 0;
 		M->count = 0;
@@ -81,6 +173,13 @@ void _k_mem_map_alloc(struct k_args *A)
 	struct _k_mem_map_struct *M =
 	    (struct _k_mem_map_struct *)(A->args.a1.mmap);
 
+#ifdef CONFIG_MEM_MAP_LOCK_FREE
+	*(A->args.a1.mptr) = mem_map_block_get(M);
+	if (*(A->args.a1.mptr) != NULL) {
+		A->Time.rcode = RC_OK;
+		return;
+	}
+#else
 	if (M->free != NULL) {
 		*(A->args.a1.mptr) = M->free;
 		M->free = *(char **)(M->free);
@@ -95,6 +194,7 @@ void _k_mem_map_alloc(struct k_args *A)
 		A->Time.rcode = RC_OK;
 		return;
 	}
+#endif
 
 	*(A->args.a1.mptr) = NULL;
 
@@ -108,8 +208,16 @@ void _k_mem_map_alloc(struct k_args *A)
 			A->Time.timer = NULL;
 		else {
 			A->Comm = _K_SVC_MEM_MAP_ALLOC_TIMEOUT;
-			_k_timeout_alloc(A);
+			_k_timeout_alloc(A, A->Ctxt.task);
 		}
+#endif
+#ifdef CONFIG_MEM_MAP_LOCK_FREE
+		/*
+		 * A block freed after the free list was found empty, but
+		 * before the task was listed as a waiter, has not been handed
+		 * to any waiter by the task, fiber or ISR that freed it.
+		 */
+		_k_mem_map_waiters_serve(M);
 #endif
 	} else
 		A->Time.rcode = RC_FAIL;
@@ -119,6 +227,17 @@ int task_mem_map_alloc(kmemory_map_t mmap, void **mptr, int32_t timeout)
 {
 	struct k_args A;
 
+#ifdef CONFIG_MEM_MAP_LOCK_FREE
+	*mptr = mem_map_block_get((struct _k_mem_map_struct *)mmap);
+	if (*mptr != NULL) {
+		return RC_OK;
+	}
+
+	if (timeout == TICKS_NONE) {
+		return RC_FAIL;
+	}
+#endif
+
 	A.Comm = _K_SVC_MEM_MAP_ALLOC;
 	A.Time.ticks = timeout;
 	A.args.a1.mmap = mmap;
@@ -132,6 +251,52 @@ int task_mem_map_alloc(kmemory_map_t mmap, void **mptr, int32_t timeout)
  *
  * Give block to a waiting task, if there is one.
  */
+#ifdef CONFIG_MEM_MAP_LOCK_FREE
+void _k_mem_map_dealloc(struct k_args *A)
+{
+	struct _k_mem_map_struct *M =
+	    (struct _k_mem_map_struct *)(A->args.a1.mmap);
+
+	mem_map_block_put(M, *(A->args.a1.mptr));
+	*(A->args.a1.mptr) = NULL;
+
+	_k_mem_map_waiters_serve(M);
+}
+
+/**
+ * @brief Hand free blocks of a memory map to its waiting tasks
+ *
+ * This routine, called by _k_server(), gives free blocks to the tasks waiting
+ * on the memory map, in order of priority, for as long as there are both.
+ *
+ * @param M Memory map
+ * @return N/A
+ */
+void _k_mem_map_waiters_serve(struct _k_mem_map_struct *M)
+{
+	struct k_args *X;
+	void *block;
+
+	while ((X = M->waiters) != NULL) {
+		block = mem_map_block_get(M);
+		if (block == NULL) {
+			return;
+		}
+
+		M->waiters = X->next;
+		*(X->args.a1.mptr) = block;
+
+#ifdef CONFIG_SYS_CLOCK_EXISTS
+		if (X->Time.timer) {
+			_k_timeout_free(X->Time.timer);
+			X->Comm = _K_SVC_NOP;
+		}
+#endif
+		X->Time.rcode = RC_OK;
+		_k_state_bit_reset(X->Ctxt.task, TF_ALLO);
+	}
+}
+#else
 void _k_mem_map_dealloc(struct k_args *A)
 {
 	struct _k_mem_map_struct *M =
@@ -165,17 +330,59 @@ void _k_mem_map_dealloc(struct k_args *A)
 	}
 	M->num_used--;
 }
+#endif /* CONFIG_MEM_MAP_LOCK_FREE */
 
 void _task_mem_map_free(kmemory_map_t mmap, void **mptr)
 {
+#ifdef CONFIG_MEM_MAP_LOCK_FREE
+	struct _k_mem_map_struct *M = (struct _k_mem_map_struct *)mmap;
+
+	mem_map_block_put(M, *mptr);
+	*mptr = NULL;
+
+	/*
+	 * The block is freed before checking for waiters, so that a task
+	 * listed as a waiter after this check gets it from _k_mem_map_alloc().
+	 */
+
+	if (M->waiters != NULL) {
+		_k_command_task_push((uint32_t)M | KERNEL_CMD_MEM_MAP_TYPE);
+	}
+#else
 	struct k_args A;
 
 	A.Comm = _K_SVC_MEM_MAP_DEALLOC;
 	A.args.a1.mmap = mmap;
 	A.args.a1.mptr = mptr;
 	KERNEL_ENTRY(&A);
+#endif
 }
 
+#ifdef CONFIG_MEM_MAP_LOCK_FREE
+FUNC_ALIAS(isr_mem_map_alloc, fiber_mem_map_alloc, int);
+
+int isr_mem_map_alloc(kmemory_map_t mmap, void **mptr)
+{
+	*mptr = mem_map_block_get((struct _k_mem_map_struct *)mmap);
+
+	return (*mptr != NULL) ? RC_OK : RC_FAIL;
+}
+
+FUNC_ALIAS(isr_mem_map_free, fiber_mem_map_free, void);
+
+void isr_mem_map_free(kmemory_map_t mmap, void **mptr)
+{
+	struct _k_mem_map_struct *M = (struct _k_mem_map_struct *)mmap;
+
+	mem_map_block_put(M, *mptr);
+	*mptr = NULL;
+
+	if (M->waiters != NULL) {
+		_k_command_isr_push((uint32_t)M | KERNEL_CMD_MEM_MAP_TYPE);
+	}
+}
+#endif
+
 int task_mem_map_used_get(kmemory_map_t mmap)
 {
 	struct _k_mem_map_struct *M = (struct _k_mem_map_struct *)mmap;
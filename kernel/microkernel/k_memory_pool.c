@@ -19,13 +19,36 @@
 #include <toolchain.h>
 #include <sections.h>
 
-/* Auto-Defrag settings */
+/*
+ * Memory pools are managed as quad buddy systems. Each block of fragmentation
+ * level <n> (level 0 holding the largest blocks) is made of four blocks of
+ * level <n + 1>, its "quartet", and block <i> of a level starts at offset
+ * <i> * <block size> of the pool buffer, so that the quartet of block <i> is
+ * made of blocks <4i> to <4i + 3> of the next level.
+ *
+ * Each level keeps a bitmap of its free blocks. A block that is allocated, or
+ * that is split into a quartet, is not free. When a block is freed and the
+ * other blocks of its quartet are free as well, the quartet is merged back
+ * into its parent block, and so on up the levels; allocating or freeing a
+ * block therefore takes a bounded number of steps per level.
+ */
+
+static inline int block_is_free(struct pool_block *L, int i)
+{
+	return L->free_bitmap[i >> 5] & (1 << (i & 0x1F));
+}
 
-#define AD_NONE 0
-#define AD_BEFORE_SEARCH4BIGGERBLOCK 1
-#define AD_AFTER_SEARCH4BIGGERBLOCK 2
+static inline void block_free_mark(struct pool_block *L, int i)
+{
+	L->free_bitmap[i >> 5] |= (1 << (i & 0x1F));
+	L->nr_free++;
+}
 
-#define AUTODEFRAG AD_AFTER_SEARCH4BIGGERBLOCK
+static inline void block_used_mark(struct pool_block *L, int i)
+{
+	L->free_bitmap[i >> 5] &= ~(1 << (i & 0x1F));
+	L->nr_free--;
+}
 
 /**
  *
@@ -39,347 +62,185 @@ void _k_mem_pool_init(void)
 {
 	int i, j, k;
 	struct pool_struct *P;
-	char *memptr;
+	struct pool_block *L;
 
-	/* for all pools initialise largest blocks */
 	for (i = 0, P = _k_mem_pool_list; i < _k_mem_pool_count; i++, P++) {
-		int remaining = P->nr_of_maxblocks;
-		int t = 0;
-
-		/* initialise block-arrays */
 		for (k = 0; k < P->nr_of_frags; k++) {
-			P->frag_tab[k].count = 0;
-			for (j = 0; j < P->frag_tab[k].nr_of_entries; j++) {
-				P->frag_tab[k].blocktable[j].mem_blocks = NULL;
-				P->frag_tab[k].blocktable[j].mem_status =
-					0xF; /* all blocks in use */
+			L = &P->frag_tab[k];
+			L->count = 0;
+			L->nr_free = 0;
+			for (j = 0; j < L->nr_of_entries; j++) {
+				L->free_bitmap[j] = 0; /* all blocks in use */
 			}
 		}
 
-		memptr = P->bufblock;
-
-		while (remaining >= 4) { /* while not all blocks allocated */
-			/* - put pointer in table - */
-			P->frag_tab[0].blocktable[t].mem_blocks = memptr;
-			P->frag_tab[0].blocktable[t].mem_status =
-				0; /* all blocks initial free */
-
-			t++; /* next entry in table  */
-			remaining = remaining - 4;
-			memptr +=
-				OCTET_TO_SIZEOFUNIT(P->frag_tab[0].block_size) *
-				4;
-		}
-
-		if (remaining != 0) {
-
-			/* - put pointer in table - */
-			P->frag_tab[0].blocktable[t].mem_blocks = memptr;
-			P->frag_tab[0].blocktable[t].mem_status =
-				(0xF << remaining) &
-				0xF; /* mark unaccessible blocks as used */
+		/* all blocks of the largest size are initially free */
+		for (j = 0; j < P->nr_of_maxblocks; j++) {
+			block_free_mark(&P->frag_tab[0], j);
 		}
 	}
 }
 
 /**
  *
- * @brief ???
- *
- * marks ptr as free block in the given list [MYSTERIOUS LEGACY COMMENT]
+ * @brief Get the fragmentation level of a block size
  *
- * @return N/A
+ * @return index in fragtable of the smallest blocks that can hold <size>
+ * bytes, or -1 if <size> exceeds the largest block size
  */
-static void search_bp(char *ptr, struct pool_struct *P, int index)
+static int block_level_get(struct pool_struct *P, int size)
 {
-	int i = 0, j, block_found = 0;
-
-	while ((P->frag_tab[index].blocktable[i].mem_blocks != NULL) &&
-	       (!block_found)) {
-		for (j = 0; j < 4; j++) {
-			if (ptr ==
-			    ((P->frag_tab[index].blocktable[i].mem_blocks) +
-			     (OCTET_TO_SIZEOFUNIT(
-				     j * P->frag_tab[index].block_size)))) {
-				/* then we've found the right pointer */
-				block_found = 1;
-
-				/* so free it */
-				P->frag_tab[index].blocktable[i].mem_status =
-					P->frag_tab[index]
-						.blocktable[i]
-						.mem_status &
-					(~(1 << j));
-			}
-		}
-		i++;
+	int block_size = P->minblock_size;
+	int level = P->nr_of_frags - 1;
+
+	while (size > block_size) {
+		block_size = block_size << 2; /* try one larger */
+		level--;
 	}
+
+	return level;
 }
 
 /**
  *
- * @brief Defragmentation algorithm for memory pool
+ * @brief Allocate a block of a given fragmentation level
  *
- * @return N/A
+ * The smallest free block of this or a larger size is taken, and split down
+ * to the requested size if it is larger, the other three blocks of each
+ * quartet it is split into becoming free.
+ *
+ * @return pointer to allocated block, or NULL if none available
  */
-static void defrag(struct pool_struct *P,
-				  int ifraglevel_start,
-				  int ifraglevel_stop)
+static char *block_alloc(struct pool_struct *P, int level)
 {
-	int i, j, k;
+	struct pool_block *L;
+	int n = level;
+	int i, j;
 
-	j = ifraglevel_start;
-
-	while (j > ifraglevel_stop) {
-		i = 0;
-		while (P->frag_tab[j].blocktable[i].mem_blocks != NULL) {
-			if ((P->frag_tab[j].blocktable[i].mem_status & 0xF) ==
-			    0) { /* blocks for defragmenting */
-				search_bp(
-					P->frag_tab[j].blocktable[i].mem_blocks,
-					P,
-					j - 1);
-
-				/* remove blocks & compact list */
-				k = i;
-				while ((P->frag_tab[j]
-						.blocktable[k]
-						.mem_blocks != NULL) &&
-				       (k <
-					(P->frag_tab[j].nr_of_entries - 1))) {
-					P->frag_tab[j]
-						.blocktable[k]
-						.mem_blocks =
-						P->frag_tab[j]
-							.blocktable[k + 1]
-							.mem_blocks;
-					P->frag_tab[j]
-						.blocktable[k]
-						.mem_status =
-						P->frag_tab[j]
-							.blocktable[k + 1]
-							.mem_status;
-					k++;
-				}
-				P->frag_tab[j].blocktable[k].mem_blocks = NULL;
-				P->frag_tab[j].blocktable[k].mem_status = 0;
-			} else {
-				i++; /* take next block */
-			}
+	if (level < 0) {
+		return NULL; /* block too large */
+	}
+
+	while (P->frag_tab[n].nr_free == 0) {
+		if (n == 0) {
+			return NULL; /* no more free blocks in pool */
 		}
-		j--;
+		n--;
+	}
+
+	L = &P->frag_tab[n];
+	for (j = 0; L->free_bitmap[j] == 0; j++) {
 	}
+	i = (j << 5) + find_lsb_set(L->free_bitmap[j]) - 1;
+	block_used_mark(L, i);
+
+	while (n < level) {
+		n++;
+		i <<= 2;
+		for (j = 1; j < 4; j++) {
+			block_free_mark(&P->frag_tab[n], i + j);
+		}
+	}
+
+#ifdef CONFIG_OBJECT_MONITOR
+	P->frag_tab[level].count++;
+#endif
+
+	return P->bufblock +
+	       OCTET_TO_SIZEOFUNIT(i * P->frag_tab[level].block_size);
 }
 
 /**
  *
- * @brief Perform defragment memory pool request
+ * @brief Free a block of a given fragmentation level
+ *
+ * The block is merged with the other blocks of its quartet if they are all
+ * free, and so on up the levels. Pointers that do not designate a block in
+ * use of that level are ignored.
  *
  * @return N/A
  */
-void _k_defrag(struct k_args *A)
+static void block_free(struct pool_struct *P, int level, char *ptr)
 {
-	struct pool_struct *P = _k_mem_pool_list + OBJ_INDEX(A->args.p1.pool_id);
-
-	defrag(P,
-	       P->nr_of_frags - 1, /* start from smallest blocks */
-	       0		   /* and defragment till fragment level 0 */
-	       );
-
-	/* reschedule waiters */
-
-	if (
-		    P->waiters) {
-		struct k_args *NewGet;
-
-		/*
-		 * get new command packet that calls the function
-		 * that reallocate blocks for the waiting tasks
-		 */
-		GETARGS(NewGet);
-		*NewGet = *A;
-		NewGet->Comm = _K_SVC_BLOCK_WAITERS_GET;
-		TO_ALIST(&_k_command_stack, NewGet); /*push on command stack */
+	struct pool_block *L = &P->frag_tab[level];
+	int offset = ptr - P->bufblock;
+	int i = offset / OCTET_TO_SIZEOFUNIT(L->block_size);
+	uint32_t quartet;
+
+	if ((offset < 0) ||
+	    (offset != i * OCTET_TO_SIZEOFUNIT(L->block_size)) ||
+	    (i >= (P->nr_of_maxblocks << (2 * level))) ||
+	    block_is_free(L, i)) {
+		return;
 	}
-}
 
+	block_free_mark(L, i);
 
-void task_mem_pool_defragment(kmemory_pool_t Pid)
-{
-	struct k_args A;
+	while (level > 0) {
+		quartet = 0xF << (i & 0x1C);
+		if ((L->free_bitmap[i >> 5] & quartet) != quartet) {
+			break;
+		}
 
-	A.Comm = _K_SVC_DEFRAG;
-	A.args.p1.pool_id = Pid;
-	KERNEL_ENTRY(&A);
+		/* merge the quartet into its parent block */
+		L->free_bitmap[i >> 5] &= ~quartet;
+		L->nr_free -= 4;
+
+		level--;
+		L = &P->frag_tab[level];
+		i >>= 2;
+		block_free_mark(L, i);
+	}
 }
 
 /**
  *
- * @brief Allocate block using specified fragmentation level
- *
- * This routine attempts to allocate a free block. [NEED TO EXPAND THIS]
+ * @brief Queue a retry of the requests waiting for blocks of a pool
  *
- * @return pointer to allocated block, or NULL if none available
+ * @return N/A
  */
-static char *search_block_on_frag_level(struct pool_block *pfraglevelinfo,
-						    int *piblockindex)
+static void block_waiters_resched(struct k_args *A)
 {
-	int i, status, end_of_list;
-	char *found;
-
-	i = 0;
-	end_of_list = 0;
-	found = NULL;
-
-	while (!end_of_list) {/* search list */
-
-		if (pfraglevelinfo->blocktable[i].mem_blocks == NULL) {
-			end_of_list = 1;
-		} else {
-			status = pfraglevelinfo->blocktable[i].mem_status;
-			if (!(status & 1)) {
-				found = pfraglevelinfo->blocktable[i]
-						.mem_blocks;
-				pfraglevelinfo->blocktable[i].mem_status |=
-					1; /* set status used */
-#ifdef CONFIG_OBJECT_MONITOR
-				pfraglevelinfo->count++;
-#endif
-				break;
-			} else if (!(status & 2)) {
-				found = pfraglevelinfo->blocktable[i]
-						.mem_blocks +
-					(OCTET_TO_SIZEOFUNIT(
-						pfraglevelinfo->block_size));
-				pfraglevelinfo->blocktable[i].mem_status |=
-					2; /* set status used */
-#ifdef CONFIG_OBJECT_MONITOR
-				pfraglevelinfo->count++;
-#endif
-				break;
-			} else if (!(status & 4)) {
-				found = pfraglevelinfo->blocktable[i]
-						.mem_blocks +
-					(OCTET_TO_SIZEOFUNIT(
-						2 *
-						pfraglevelinfo->block_size));
-				pfraglevelinfo->blocktable[i].mem_status |=
-					4; /* set status used */
-#ifdef CONFIG_OBJECT_MONITOR
-				pfraglevelinfo->count++;
-#endif
-				break;
-			} else if (!(status & 8)) {
-				found = pfraglevelinfo->blocktable[i]
-						.mem_blocks +
-					(OCTET_TO_SIZEOFUNIT(
-						3 *
-						pfraglevelinfo->block_size));
-				pfraglevelinfo->blocktable[i].mem_status |=
-					8; /* set status used */
-#ifdef CONFIG_OBJECT_MONITOR
-				pfraglevelinfo->count++;
-#endif
-				break;
-			}
-
-			i++;
-			if (i >= pfraglevelinfo->nr_of_entries) {
-				end_of_list = 1;
-			}
-		}
-	} /* while (...) */
-
-	*piblockindex = i;
-	return found;
+	struct k_args *NewGet;
+
+	/*
+	 * get new command packet that calls the function
+	 * that reallocate blocks for the waiting tasks
+	 */
+	GETARGS(NewGet);
+	*NewGet = *A;
+	NewGet->Comm = _K_SVC_BLOCK_WAITERS_GET;
+	SENDARGS(NewGet); /*push on command stack */
 }
 
 /**
  *
- * @brief Recursively get a block, doing fragmentation if necessary
- *
- * @file
- * @brief Memory pool kernel services
- *
+ * @brief Perform defragment memory pool request
  *
- * not implemented: check if we go below the minimal number of blocks with
- * the maximum size
+ * Free blocks are merged as soon as they are freed, so there is nothing left
+ * to defragment; only the waiters are given another chance.
  *
- * @return pointer to allocated block, or NULL if none available
+ * @return N/A
  */
-static char *get_block_recusive(struct pool_struct *P, int index, int startindex)
+void _k_defrag(struct k_args *A)
 {
-	int i;
-	char *found, *larger_block;
-	struct pool_block *fr_table;
-
-	if (index < 0) {
-		return NULL; /* no more free blocks in pool */
-	}
-
-	fr_table = P->frag_tab;
-	i = 0;
-
-	/* let's inspect the fragmentation level <index> */
-	found = search_block_on_frag_level(&(fr_table[index]), &i);
-	if (found != NULL) {
-		return found;
-	}
-
-#if AUTODEFRAG == AD_BEFORE_SEARCH4BIGGERBLOCK
-	/* maybe a partial defrag will free up a block? */
-	if (index == startindex) { /* only for the original request */
-		defrag(P,
-		       P->nr_of_frags - 1, /* start from the smallest blocks */
-		       startindex); /* but only until the requested blocksize
-				     * (fragmentation level) !!
-				     */
-
-		found = search_block_on_frag_level(&(fr_table[index]), &i);
-		if (found != NULL) {
-			return found;
-		}
-	}
-	/* partial defrag did not release a block of level <index> */
-#endif
+	struct pool_struct *P = _k_mem_pool_list + OBJ_INDEX(A->args.p1.pool_id);
 
-	/* end of list and i is index of first empty entry in blocktable */
-	{
-		/* get a block of one size larger */
-		larger_block = get_block_recusive(
-			P, index - 1, startindex);
-	}
+	/* reschedule waiters */
 
-	if (larger_block != NULL) {
-		/* insert 4 found blocks and mark one block as used */
-		fr_table[index].blocktable[i].mem_blocks = larger_block;
-		fr_table[index].blocktable[i].mem_status = 1;
-#ifdef CONFIG_OBJECT_MONITOR
-		fr_table[index].count++;
-#endif
-		return larger_block; /* return marked block */
+	if (P->waiters) {
+		block_waiters_resched(A);
 	}
+}
 
-	/* trying to get a larger block did not succeed */
-
-#if AUTODEFRAG == AD_AFTER_SEARCH4BIGGERBLOCK
-	/* maybe a partial defrag will free up a block? */
-	if (index == startindex) { /* only for the original request */
-		defrag(P,
-		       P->nr_of_frags - 1, /* start from the smallest blocks */
-		       startindex); /* but only until the requested blocksize
-				     * (fragmentation level) !!
-				     */
 
-		found = search_block_on_frag_level(&(fr_table[index]), &i);
-		if (found != NULL) {
-			return found;
-		}
-	}
-   /* partial defrag did not release a block of level <index> */
-#endif
+void task_mem_pool_defragment(kmemory_pool_t Pid)
+{
+	struct k_args A;
 
-	return NULL; /* now we have to report failure: no block available */
+	A.Comm = _K_SVC_DEFRAG;
+	A.args.p1.pool_id = Pid;
+	KERNEL_ENTRY(&A);
 }
 
 /**
@@ -398,7 +259,6 @@ void _k_block_waiters_get(struct k_args *A)
 	struct pool_struct *P = _k_mem_pool_list + OBJ_INDEX(A->args.p1.pool_id);
 	char *found_block;
 	struct k_args *curr_task, *prev_task;
-	int start_size, offset;
 
 	curr_task = P->waiters;
 	/* forw is first field in struct */
@@ -407,17 +267,9 @@ void _k_block_waiters_get(struct k_args *A)
 	/* loop all waiters */
 	while (curr_task != NULL) {
 
-		/* calculate size & offset */
-		start_size = P->minblock_size;
-		offset = P->nr_of_frags - 1;
-		while (curr_task->args.p1.req_size > start_size) {
-			start_size = start_size << 2; /* try one larger */
-			offset--;
-		}
-
 		/* allocate block */
-		found_block = get_block_recusive(
-			P, offset, offset); /* allocate and fragment blocks */
+		found_block = block_alloc(P,
+				block_level_get(P, curr_task->args.p1.req_size));
 
 		/* if success : remove task from list and reschedule */
 		if (found_block != NULL) {
@@ -477,23 +329,7 @@ void _k_mem_pool_block_get(struct k_args *A)
 	struct pool_struct *P = _k_mem_pool_list + OBJ_INDEX(A->args.p1.pool_id);
 	char *found_block;
 
-	int start_size;
-	int offset;
-
-	/* calculate start size */
-	start_size = P->minblock_size;
-	offset = P->nr_of_frags - 1;
-
-	while (A->args.p1.req_size > start_size) {
-		start_size = start_size << 2; /*try one larger */
-		offset--;
-	}
-
-	/* startsize==the available size that can contain the requeste block size */
-	/* offset: index in fragtable of the minimal blocksize */
-
-	found_block =
-		get_block_recusive(P, offset, offset); /* allocate and fragment blocks */
+	found_block = block_alloc(P, block_level_get(P, A->args.p1.req_size));
 
 	if (found_block != NULL) {
 		A->args.p1.rep_poolptr = found_block;
@@ -518,7 +354,7 @@ void _k_mem_pool_block_get(struct k_args *A)
 			A->Time.timer = NULL;
 		} else {
 			A->Comm = _K_SVC_MEM_POOL_BLOCK_GET_TIMEOUT_HANDLE;
-			_k_timeout_alloc(A);
+			_k_timeout_alloc(A, A->Ctxt.task);
 		}
 #endif
 	} else {
@@ -565,70 +401,27 @@ int task_mem_pool_alloc(struct k_block *blockptr, kmemory_pool_t pool_id,
  *
  * @brief Perform return memory pool block request
  *
- * Marks a block belonging to a pool as free; if there are waiters that can use
- * the the block it is passed to a waiting task.
+ * Marks a block belonging to a pool as free, merging it with its buddies; if
+ * there are waiters that can use the block it is passed to a waiting task.
  *
  * @return N/A
  */
 void _k_mem_pool_block_release(struct k_args *A)
 {
-	struct pool_struct *P;
-	struct pool_block *block;
-	struct block_stat *blockstat;
-	int Pid;
-	int start_size, offset;
-	int i, j;
-
-	Pid = A->args.p1.pool_id;
-
-
-	P = _k_mem_pool_list + OBJ_INDEX(Pid);
+	struct pool_struct *P = _k_mem_pool_list + OBJ_INDEX(A->args.p1.pool_id);
+	int level = block_level_get(P, A->args.p1.req_size);
 
-	/* calculate size */
-	start_size = P->minblock_size;
-	offset = P->nr_of_frags - 1;
+	if (level >= 0) {
+		block_free(P, level, A->args.p1.rep_poolptr);
 
-	while (A->args.p1.req_size > start_size) {
-		start_size = start_size << 2; /* try one larger */
-		offset--;
+		/* waiters? */
+		if (P->waiters != NULL) {
+			block_waiters_resched(A);
+		}
 	}
 
-	/* startsize==the available size that contains the requested block size */
-	/* offset: index in fragtable of the block */
-
-	j = 0;
-	block = P->frag_tab + offset;
-
-	while ((j < block->nr_of_entries) &&
-	       ((blockstat = block->blocktable + j)->mem_blocks != 0)) {
-		for (i = 0; i < 4; i++) {
-			if (A->args.p1.rep_poolptr ==
-			    (blockstat->mem_blocks +
-			     (OCTET_TO_SIZEOFUNIT(i * block->block_size)))) {
-				/* we've found the right pointer, so free it */
-				blockstat->mem_status &= ~(1 << i);
-
-				/* waiters? */
-				if (P->waiters != NULL) {
-					struct k_args *NewGet;
-					/*
-					 * get new command packet that calls
-					 * the function that reallocate blocks
-					 * for the waiting tasks
-					 */
-					GETARGS(NewGet);
-					*NewGet = *A;
-					NewGet->Comm = _K_SVC_BLOCK_WAITERS_GET;
-					/* push on command stack */
-					TO_ALIST(&_k_command_stack, NewGet);
-				}
-				if (A->alloc) {
-					FREEARGS(A);
-				}
-				return;
-			}
-		}
-		j++;
+	if (A->alloc) {
+		FREEARGS(A);
 	}
 }
 
@@ -223,7 +223,7 @@ void _k_mutex_lock_request(struct k_args *A /* pointer to mutex lock
 				 * the request time out.
 				 */
 				A->Comm = _K_SVC_MUTEX_LOCK_REPLY_TIMEOUT;
-				_k_timeout_alloc(A);
+				_k_timeout_alloc(A, A->Ctxt.task);
 			}
 #endif
 			if (A->priority < Mutex->current_owner_priority) {
@@ -265,6 +265,42 @@ int task_mutex_lock(kmutex_t mutex, int32_t timeout)
 {
 	struct k_args A; /* argument packet */
 
+#ifdef CONFIG_MICROKERNEL_FAST_PATH
+	struct _k_mutex_struct *Mutex = (struct _k_mutex_struct *)mutex;
+	unsigned int key = irq_lock();
+
+	/*
+	 * Locking interrupts keeps the microkernel server fiber from running,
+	 * so a mutex that is unowned, or already owned by the requesting task,
+	 * can be locked directly: see _k_mutex_lock_request().
+	 */
+
+	if (Mutex->level == 0 || Mutex->owner == _k_current_task->id) {
+#ifdef CONFIG_OBJECT_MONITOR
+		Mutex->count++;
+#endif
+		Mutex->owner = _k_current_task->id;
+		Mutex->current_owner_priority = _k_current_task->priority;
+		if (Mutex->level == 0) {
+			Mutex->original_owner_priority =
+				Mutex->current_owner_priority;
+		}
+		Mutex->level++;
+		irq_unlock(key);
+		return RC_OK;
+	}
+
+	if (timeout == TICKS_NONE) {
+#ifdef CONFIG_OBJECT_MONITOR
+		Mutex->num_conflicts++;
+#endif
+		irq_unlock(key);
+		return RC_FAIL;
+	}
+
+	irq_unlock(key);
+#endif
+
 	A.Comm = _K_SVC_MUTEX_LOCK_REQUEST;
 	A.Time.ticks = timeout;
 	A.args.l1.mutex = mutex;
@@ -377,6 +413,39 @@ void _task_mutex_unlock(kmutex_t mutex)
 {
 	struct k_args A; /* argument packet */
 
+#ifdef CONFIG_MICROKERNEL_FAST_PATH
+	struct _k_mutex_struct *Mutex = (struct _k_mutex_struct *)mutex;
+	unsigned int key = irq_lock();
+
+	/*
+	 * A nested lock, or the last lock of a mutex that no task is waiting
+	 * for and that did not boost the priority of its owner, can be
+	 * released directly: see _k_mutex_unlock().
+	 */
+
+	if (Mutex->owner == _k_current_task->id) {
+		if (Mutex->level > 1) {
+			Mutex->level--;
+			irq_unlock(key);
+			return;
+		}
+
+		if ((Mutex->waiters == NULL) &&
+		    (Mutex->current_owner_priority ==
+		     Mutex->original_owner_priority)) {
+#ifdef CONFIG_OBJECT_MONITOR
+			Mutex->count++;
+#endif
+			Mutex->owner = ANYTASK;
+			Mutex->level = 0;
+			irq_unlock(key);
+			return;
+		}
+	}
+
+	irq_unlock(key);
+#endif
+
 	A.Comm = _K_SVC_MUTEX_UNLOCK;
 	A.args.l1.mutex = mutex;
 	A.args.l1.task = _k_current_task->id;
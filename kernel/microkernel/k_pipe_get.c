@@ -147,7 +147,7 @@ void _k_pipe_get_request(struct k_args *RequestOrig)
 		} else
 #endif
 			/* enlist a new timer into the timeout chain */
-			_k_timeout_alloc(RequestProc);
+			_k_timeout_alloc(RequestProc, RequestOrig->Ctxt.task);
 
 		return;
 	}
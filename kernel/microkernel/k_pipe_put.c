@@ -44,6 +44,11 @@ void _k_pipe_put_request(struct k_args *RequestOrig)
 		bAsync = false;
 	}
 
+	if (bAsync && _k_command_packet_wait(RequestOrig)) {
+		/* posted data held back until command packets are freed */
+		return;
+	}
+
 	if (!bAsync) {
 		/* First save the pointer to the task's TCB for rescheduling later */
 		RequestOrig->Ctxt.task = _k_current_task;
@@ -167,7 +172,7 @@ void _k_pipe_put_request(struct k_args *RequestOrig)
 		} else
 #endif
 			/* enlist a new timer into the timeout chain */
-			_k_timeout_alloc(RequestProc);
+			_k_timeout_alloc(RequestProc, RequestOrig->Ctxt.task);
 
 		return;
 	}
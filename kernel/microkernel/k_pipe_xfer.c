@@ -23,6 +23,7 @@
 #include <sections.h>
 #include <misc/__assert.h>
 #include <misc/util.h>
+#include <string.h>
 
 #define FORCE_XFER_ON_STALL
 
@@ -33,7 +34,8 @@
  * - non-optimal:
  * from single requester to multiple requesters : basic function is
  * pipe_read_write() - copies remaining data into buffer; better would be to
- * possibly copy the remaining data to the next requester (if there is one)
+ * possibly copy the remaining data to the next requester (if there is one),
+ * which is what pipe_handoff() does when CONFIG_PIPE_DIRECT_HANDOFF is set
  */
 
 
@@ -578,6 +580,105 @@ static void pipe_xfer_status_update(struct k_args *pActor,
 	}
 }
 
+#ifdef CONFIG_PIPE_DIRECT_HANDOFF
+/**
+ * @brief Acknowledge a direct handoff to one of its participants
+ *
+ * The acknowledgement is processed like the one of a writer to reader
+ * movedata request, which replies to the participant once it is terminated
+ * and resumes the processing of the pipe.
+ *
+ * @return N/A
+ */
+static void pipe_handoff_ack(struct _k_pipe_struct *pipe_ptr,
+			     struct k_args *writer_ptr,
+			     struct k_args *reader_ptr,
+			     kpriority_t priority, int size)
+{
+	struct k_args *pAck;
+
+	GETARGS(pAck);
+	pAck->next = NULL;
+	pAck->Comm = _K_SVC_PIPE_MOVEDATA_ACK;
+	pAck->priority = priority;
+	pAck->args.pipe_xfer_ack.pipe_ptr = pipe_ptr;
+	pAck->args.pipe_xfer_ack.xfer_type = XFER_W2R;
+	pAck->args.pipe_xfer_ack.writer_ptr = writer_ptr;
+	pAck->args.pipe_xfer_ack.reader_ptr = reader_ptr;
+	pAck->args.pipe_xfer_ack.id = -1;
+	pAck->args.pipe_xfer_ack.size = size;
+	SENDARGS(pAck);
+}
+
+/**
+ * @brief Hand the buffered data and the writer's data to a reader
+ *
+ * The data available in the pipe buffer, which wraps around at most once,
+ * and then the data of the writer are copied straight into the reader in a
+ * single scatter copy. The data of the writer that does not fit in the
+ * reader is left to the next reader, or to the pipe buffer if there is
+ * none. Must not be called while data is being copied into the pipe buffer,
+ * as it would deliver the data of the writer ahead of it.
+ *
+ * @return N/A
+ */
+static void pipe_handoff(struct _k_pipe_struct *pipe_ptr,
+			 struct k_args *writer_ptr, struct k_args *reader_ptr)
+{
+	struct _pipe_xfer_req_arg *pipe_write_req =
+		&writer_ptr->args.pipe_xfer_req;
+	struct _pipe_xfer_req_arg *pipe_read_req =
+		&reader_ptr->args.pipe_xfer_req;
+	kpriority_t priority = move_priority_compute(writer_ptr, reader_ptr);
+	char *destination = (char *)(pipe_read_req->data_ptr) +
+		OCTET_TO_SIZEOFUNIT(pipe_read_req->xferred_size);
+	int space = pipe_read_req->total_size - pipe_read_req->xferred_size;
+	int buffered = 0;
+	int direct = 0;
+	unsigned char *read_ptr;
+	int size;
+	int i;
+
+	__ASSERT_NO_MSG(pipe_ptr->desc.num_pending_writes == 0);
+
+	for (i = 0; i < 2; i++) {
+		size = min(pipe_ptr->desc.available_data_count,
+			   space - buffered);
+		if ((size == 0) ||
+		    (BuffDeQ(&pipe_ptr->desc, size, &read_ptr) == 0)) {
+			break;
+		}
+		memcpy(destination + OCTET_TO_SIZEOFUNIT(buffered), read_ptr,
+		       OCTET_TO_SIZEOFUNIT(size));
+		buffered += size;
+	}
+
+	/* the writer's data must not overtake data left in the buffer */
+	if ((pipe_ptr->desc.available_data_count == 0) &&
+	    (pipe_ptr->desc.available_data_post_wrap_around == 0)) {
+		direct = min(space - buffered, pipe_write_req->total_size -
+			     pipe_write_req->xferred_size);
+		memcpy(destination + OCTET_TO_SIZEOFUNIT(buffered),
+		       (char *)(pipe_write_req->data_ptr) +
+		       OCTET_TO_SIZEOFUNIT(pipe_write_req->xferred_size),
+		       OCTET_TO_SIZEOFUNIT(direct));
+	}
+
+	if (buffered + direct == 0) {
+		return;
+	}
+
+	pipe_xfer_status_update(reader_ptr, pipe_read_req, buffered + direct);
+	pipe_handoff_ack(pipe_ptr, NULL, reader_ptr, priority,
+			 buffered + direct);
+
+	if (direct != 0) {
+		pipe_xfer_status_update(writer_ptr, pipe_write_req, direct);
+		pipe_handoff_ack(pipe_ptr, writer_ptr, NULL, priority, direct);
+	}
+}
+#endif /* CONFIG_PIPE_DIRECT_HANDOFF */
+
 /**
  * @brief Read and/or write from/to the pipe
  *
@@ -614,6 +715,13 @@ static void pipe_read_write(struct _k_pipe_struct *pipe_ptr,
 	__ASSERT_NO_MSG((pipe_ptr->readers == pNewReader) ||
 			(pipe_ptr->readers == NULL) || (pNewReader == NULL));
 
+#ifdef CONFIG_PIPE_DIRECT_HANDOFF
+	if (pipe_ptr->desc.num_pending_writes == 0) {
+		pipe_handoff(pipe_ptr, writer_ptr, reader_ptr);
+		return;
+	}
+#endif
+
 	/* Preparation */
 	pipe_write_req = &writer_ptr->args.pipe_xfer_req;
 	pipe_read_req = &reader_ptr->args.pipe_xfer_req;
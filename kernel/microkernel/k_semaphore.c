@@ -313,7 +313,7 @@ void _k_sem_group_wait_any(struct k_args *A)
 			A->Time.timer = NULL;
 		} else {
 			A->Comm = _K_SVC_SEM_GROUP_WAIT_TIMEOUT;
-			_k_timeout_alloc(A);
+			_k_timeout_alloc(A, A->Ctxt.task);
 		}
 	}
 #endif
@@ -340,7 +340,7 @@ void _k_sem_wait_request(struct k_args *A)
 			A->Time.timer = NULL;
 		} else {
 			A->Comm = _K_SVC_SEM_WAIT_REPLY_TIMEOUT;
-			_k_timeout_alloc(A);
+			_k_timeout_alloc(A, A->Ctxt.task);
 		}
 #endif
 		return;
@@ -353,6 +353,28 @@ int task_sem_take(ksem_t sema, int32_t timeout)
 {
 	struct k_args A;
 
+#ifdef CONFIG_MICROKERNEL_FAST_PATH
+	struct _k_sem_struct *S = (struct _k_sem_struct *)sema;
+	unsigned int key = irq_lock();
+
+	/*
+	 * Locking interrupts keeps the microkernel server fiber from running,
+	 * so the semaphore can be taken directly if it is available.
+	 */
+
+	if (S->level) {
+		S->level--;
+		irq_unlock(key);
+		return RC_OK;
+	}
+
+	irq_unlock(key);
+
+	if (timeout == TICKS_NONE) {
+		return RC_FAIL;
+	}
+#endif
+
 	A.Comm = _K_SVC_SEM_WAIT_REQUEST;
 	A.Time.ticks = timeout;
 	A.args.s1.sema = sema;
@@ -393,6 +415,24 @@ void task_sem_give(ksem_t sema)
 {
 	struct k_args A;
 
+#ifdef CONFIG_MICROKERNEL_FAST_PATH
+	struct _k_sem_struct *S = (struct _k_sem_struct *)sema;
+	unsigned int key = irq_lock();
+
+	/* no task to wake up: simply update the semaphore */
+
+	if (S->waiters == NULL) {
+#ifdef CONFIG_OBJECT_MONITOR
+		S->count++;
+#endif
+		S->level++;
+		irq_unlock(key);
+		return;
+	}
+
+	irq_unlock(key);
+#endif
+
 	A.Comm = _K_SVC_SEM_SIGNAL;
 	A.args.s1.sema = sema;
 	KERNEL_ENTRY(&A);
@@ -411,8 +451,7 @@ FUNC_ALIAS(isr_sem_give, fiber_sem_give, void);
 
 void isr_sem_give(ksem_t sema)
 {
-	nano_isr_stack_push(&_k_command_stack,
-						(uint32_t)sema | KERNEL_CMD_SEMAPHORE_TYPE);
+	_k_command_isr_push((uint32_t)sema | KERNEL_CMD_SEMAPHORE_TYPE);
 }
 
 void _k_sem_reset(struct k_args *A)
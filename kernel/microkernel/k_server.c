@@ -79,6 +79,12 @@ static struct k_task *next_task_select(void)
  * stack and then sets up the next task that is ready to run. Next it
  * goes to wait on further inputs on the command stack.
  *
+ * When CONFIG_FIFO_COMMAND_QUEUE is enabled, the commands are taken from the
+ * FIFO command queue instead, those queued by fibers and ISRs first. All the
+ * queued commands are processed before the next task is set up in either
+ * case, since the command handlers take the requesting task to be the
+ * current one.
+ *
  * @return Does not return.
  */
 FUNC_NORETURN void _k_server(int unused1, int unused2)
@@ -95,8 +101,12 @@ FUNC_NORETURN void _k_server(int unused1, int unused2)
 	_nanokernel.current->flags |= ESSENTIAL;
 
 	while (1) { /* forever */
+#ifdef CONFIG_FIFO_COMMAND_QUEUE
+		_k_command_wait((uint32_t *)&pArgs); /* will schedule */
+#else
 		(void) nano_fiber_stack_pop(&_k_command_stack, (uint32_t *)&pArgs,
 				TICKS_UNLIMITED); /* will schedule */
+#endif
 		do {
 			int cmd_type = (int)pArgs & KERNEL_CMD_TYPE_MASK;
 
@@ -122,6 +132,17 @@ FUNC_NORETURN void _k_server(int unused1, int unused2)
 				kevent_t event = (int)pArgs & ~KERNEL_CMD_TYPE_MASK;
 
 				_k_do_event_signal(event);
+#ifdef CONFIG_MEM_MAP_LOCK_FREE
+			} else if (cmd_type == KERNEL_CMD_MEM_MAP_TYPE) {
+
+				/* hand freed memory map blocks to waiters */
+
+				struct _k_mem_map_struct *map =
+					(struct _k_mem_map_struct *)
+					((int)pArgs & ~KERNEL_CMD_TYPE_MASK);
+
+				_k_mem_map_waiters_serve(map);
+#endif
 			} else { /* cmd_type == KERNEL_CMD_SEMAPHORE_TYPE */
 
 				/* give semaphore */
@@ -142,8 +163,12 @@ FUNC_NORETURN void _k_server(int unused1, int unused2)
 			if (_nanokernel.fiber) {
 				fiber_yield();
 			}
+#ifdef CONFIG_FIFO_COMMAND_QUEUE
+		} while (_k_command_get((uint32_t *)&pArgs));
+#else
 		} while (nano_fiber_stack_pop(&_k_command_stack, (uint32_t *)&pArgs,
 					TICKS_NONE));
+#endif
 
 		pNextTask = next_task_select();
 
@@ -162,6 +187,10 @@ FUNC_NORETURN void _k_server(int unused1, int unused2)
 			}
 #endif
 
+#ifdef CONFIG_TIMESLICE_FAIR
+			_k_time_slice_switch();
+#endif
+
 			_k_current_task = pNextTask;
 			_nanokernel.task = (struct tcs *)pNextTask->workspace;
 
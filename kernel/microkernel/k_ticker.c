@@ -30,12 +30,24 @@
 #include <microkernel/ticks.h>
 #include <toolchain.h>
 #include <sections.h>
+#include <misc/__assert.h>
+#include <misc/util.h>
 
 #ifdef CONFIG_TIMESLICING
+#ifdef CONFIG_TIMESLICE_FAIR
+static uint32_t slice_start; /* cycle at which the current task was charged */
+#else
 static int32_t slice_count = (int32_t)0;
+static struct k_task *slice_task; /* task whose ticks are counted */
+#endif
 static int32_t slice_time = (int32_t)CONFIG_TIMESLICE_SIZE;
 static kpriority_t slice_prio =
 	(kpriority_t)CONFIG_TIMESLICE_PRIORITY;
+#ifdef CONFIG_TIMESLICE_PER_PRIORITY
+/* time slice size of each priority level, -1 if not set */
+static int32_t slice_prio_time[CONFIG_NUM_TASK_PRIORITIES] = {
+	[0 ... CONFIG_NUM_TASK_PRIORITIES - 1] = -1 };
+#endif
 #endif /* CONFIG_TIMESLICING */
 
 #ifdef CONFIG_TICKLESS_IDLE
@@ -65,6 +77,130 @@ static inline int _TlDebugUpdate(int32_t ticks)
 #define _TlDebugUpdate(ticks) 1
 #endif
 
+#ifdef CONFIG_TIMESLICING
+
+/**
+ * @internal
+ * @brief Get the time slice size of a priority level
+ *
+ * @param prio Task priority
+ *
+ * @return time slice size in ticks, 0 if the priority level is not sliced
+ */
+static inline int32_t _TimeSliceSizeGet(kpriority_t prio)
+{
+#ifdef CONFIG_TIMESLICE_PER_PRIORITY
+	if (slice_prio_time[prio] >= 0) {
+		return slice_prio_time[prio];
+	}
+#endif
+	return (prio >= slice_prio) ? slice_time : 0;
+}
+
+#ifdef CONFIG_TIMESLICE_FAIR
+
+/**
+ * @internal
+ * @brief Get the length of a time slice in cycles
+ *
+ * @param size Time slice size in ticks
+ *
+ * @return time slice length in cycles, saturated to 32 bits
+ */
+static inline uint32_t _TimeSliceCycles(int32_t size)
+{
+	uint64_t cycles = (uint64_t)size *
+			  (uint64_t)sys_clock_hw_cycles_per_tick;
+
+	return (cycles > (uint32_t)-1) ? (uint32_t)-1 : (uint32_t)cycles;
+}
+
+/**
+ * @internal
+ * @brief Charge the current task for the cycles it executed
+ *
+ * The count saturates rather than wraps, so that the slice of a task
+ * cannot restart when it is as long as the 32-bit cycle count allows.
+ *
+ * @return cycles executed by the current task in its time slice
+ */
+static inline uint32_t _TimeSliceCharge(void)
+{
+	uint32_t now = sys_cycle_get_32();
+	uint32_t used = _k_current_task->slice_used + (now - slice_start);
+
+	if (used < _k_current_task->slice_used) {
+		used = (uint32_t)-1;
+	}
+	_k_current_task->slice_used = used;
+	slice_start = now;
+
+	return used;
+}
+
+/**
+ *
+ * @brief Time slice logic of a task switch
+ *
+ * This routine, called by _k_server() before switching tasks, charges the
+ * task being switched out for the cycles it executed. The remainder of its
+ * time slice is left for when it is switched in again.
+ *
+ * @return N/A
+ */
+void _k_time_slice_switch(void)
+{
+	_TimeSliceCharge();
+}
+
+#endif /* CONFIG_TIMESLICE_FAIR */
+
+#ifdef CONFIG_TICKLESS_IDLE
+
+/**
+ *
+ * @brief Get the ticks left in the time slice of the current task
+ *
+ * This routine is called by the idle task, with interrupts locked, before it
+ * stops the periodic tick. The slice only expires when another task of the
+ * same priority is ready to take over, so that a task sharing the priority
+ * level of the idle task is not starved while the tick is stopped.
+ *
+ * @return ticks before the slice expires, or TICKS_UNLIMITED if it cannot
+ */
+int32_t _k_time_slice_ticks_left(void)
+{
+	int32_t size = _TimeSliceSizeGet(_k_current_task->priority);
+#ifdef CONFIG_TIMESLICE_FAIR
+	uint32_t slice = _TimeSliceCycles(size);
+	uint32_t used;
+#endif
+
+	if (!size || !_k_current_task->next) {
+		return TICKS_UNLIMITED;
+	}
+
+#ifdef CONFIG_TIMESLICE_FAIR
+	used = _TimeSliceCharge();
+	if (used >= slice) {
+		return 1;
+	}
+
+	return (int32_t)((slice - used + sys_clock_hw_cycles_per_tick - 1) /
+			 sys_clock_hw_cycles_per_tick);
+#else
+	if (slice_task != _k_current_task) {
+		return size;
+	}
+
+	return max(size - slice_count, 1);
+#endif
+}
+
+#endif /* CONFIG_TICKLESS_IDLE */
+
+#endif /* CONFIG_TIMESLICING */
+
 /**
  * @internal
  * @brief Tick handler time slice logic
@@ -72,20 +208,43 @@ static inline int _TlDebugUpdate(int32_t ticks)
  * This routine checks to see if it is time for the current task
  * to relinquish control, and yields CPU if so.
  *
+ * The elapsed ticks are all counted, as several of them are announced at
+ * once after the kernel has been idle without a periodic tick. With fair time
+ * slicing, the cycles executed by the current task are counted instead, so
+ * that its ticks need not be announced one by one either.
+ *
+ * @param ticks Number of elapsed ticks
+ *
  * @return N/A
  *
  */
-static inline void _TimeSliceUpdate(void)
+static inline void _TimeSliceUpdate(int32_t ticks)
 {
 #ifdef CONFIG_TIMESLICING
-	int yield = slice_time && (_k_current_task->priority >= slice_prio) &&
-		    (++slice_count >= slice_time);
-	if (yield) {
+	int32_t size = _TimeSliceSizeGet(_k_current_task->priority);
+
+#ifdef CONFIG_TIMESLICE_FAIR
+	ARG_UNUSED(ticks);
+
+	if (size &&
+	    (_TimeSliceCharge() >= _TimeSliceCycles(size))) {
+		_k_current_task->slice_used = 0;
+		_k_task_yield(NULL);
+	}
+#else
+	/* a task switched in since the last tick starts a new slice */
+	if (slice_task != _k_current_task) {
+		slice_task = _k_current_task;
+		slice_count = 0;
+	}
+
+	if (size && ((slice_count += ticks) >= size)) {
 		slice_count = 0;
 		_k_task_yield(NULL);
 	}
+#endif
 #else
-/* do nothing */
+	ARG_UNUSED(ticks);
 #endif /* CONFIG_TIMESLICING */
 }
 
@@ -138,7 +297,7 @@ int _k_ticker(int event)
 	_k_workload_monitor_update();
 
 	if (_TlDebugUpdate(ticks)) {
-		_TimeSliceUpdate();
+		_TimeSliceUpdate(ticks);
 		_k_timer_list_update(ticks);
 		_nano_sys_clock_tick_announce(ticks);
 	}
@@ -154,4 +313,17 @@ void sys_scheduler_time_slice_set(int32_t t, kpriority_t p)
 	slice_prio = p;
 }
 
+#ifdef CONFIG_TIMESLICE_PER_PRIORITY
+
+void sys_scheduler_time_slice_prio_set(kpriority_t p, int32_t t)
+{
+	__ASSERT(p < CONFIG_NUM_TASK_PRIORITIES, "Invalid priority %u", p);
+
+	if (p < CONFIG_NUM_TASK_PRIORITIES) {
+		slice_prio_time[p] = t;
+	}
+}
+
+#endif /* CONFIG_TIMESLICE_PER_PRIORITY */
+
 #endif /* CONFIG_TIMESLICING */
@@ -26,6 +26,38 @@
 
 extern struct k_timer _k_timer_blocks[];
 
+#ifdef CONFIG_MICROKERNEL_TIMER_WHEEL
+
+/*
+ * The timers are kept on a timing wheel, which is only accessed by _k_server()
+ * and by the idle task with interrupts locked. Their duration is no longer
+ * counted down: it is only set to -1 when a timer is not running.
+ */
+struct _nano_timeout_wheel _k_timer_wheel;
+
+/**
+ * @brief Insert a timer into the timer queue
+ * @param T Timer
+ * @return N/A
+ */
+void _k_timer_enlist(struct k_timer *T)
+{
+	_nano_timeout_wheel_add(&_k_timer_wheel, &T->timeout, T->duration);
+}
+
+/**
+ * @brief Remove a timer from the timer queue
+ * @param T Timer
+ * @return N/A
+ */
+void _k_timer_delist(struct k_timer *T)
+{
+	_nano_timeout_wheel_remove(&_k_timer_wheel, &T->timeout);
+	T->duration = -1;
+}
+
+#else
+
 struct k_timer  *_k_timer_list_head;
 struct k_timer  *_k_timer_list_tail;
 
@@ -81,18 +113,47 @@ void _k_timer_delist(struct k_timer *T)
 	T->duration = -1;
 }
 
+#endif /* CONFIG_MICROKERNEL_TIMER_WHEEL */
+
+/**
+ * @brief Get the timer of a timed request
+ *
+ * With the timing wheel, each task embeds the timer of its timed requests,
+ * of which it has at most one at a time; otherwise a timer is allocated from
+ * the timer pool.
+ *
+ * @param task Task that made the request
+ *
+ * @return timer
+ */
+static inline struct k_timer *_k_timeout_get(struct k_task *task)
+{
+	struct k_timer *T;
+
+#ifdef CONFIG_MICROKERNEL_TIMER_WHEEL
+	T = &task->timeout;
+
+	/* the task may have been aborted while its timer was running */
+	_nano_timeout_wheel_remove(&_k_timer_wheel, &T->timeout);
+#else
+	GETTIMER(T);
+#endif
+
+	return T;
+}
+
 /**
  * @brief Allocate timer used for command packet timeout
  *
  * Allocates timer for command packet and inserts it into the timer queue.
  * @param P Arguments
+ * @param task Task that made the request, as recorded in its packet
  * @return N/A
  */
-void _k_timeout_alloc(struct k_args *P)
+void _k_timeout_alloc(struct k_args *P, struct k_task *task)
 {
-	struct k_timer *T;
+	struct k_timer *T = _k_timeout_get(task);
 
-	GETTIMER(T);
 	T->duration = P->Time.ticks;
 	T->period = 0;
 	T->args = P;
@@ -117,7 +178,7 @@ void _k_timeout_cancel(struct k_args *A)
 
 	if (T->duration != -1) {
 		_k_timer_delist(T);
-		TO_ALIST(&_k_command_stack, A);
+		SENDARGS(A);
 	}
 }
 
@@ -135,6 +196,45 @@ void _k_timeout_free(struct k_timer *T)
 	FREETIMER(T);
 }
 
+#ifdef CONFIG_MICROKERNEL_TIMER_WHEEL
+
+/**
+ * @brief Handle an expired timer
+ *
+ * Restarts a periodic timer, then sends the command packet of the timer.
+ *
+ * @param t Timeout of the timer
+ * @return N/A
+ */
+static void _k_timer_expired(struct _nano_timeout *t)
+{
+	struct k_timer *T = CONTAINER_OF(t, struct k_timer, timeout);
+
+	if (T->period) {
+		T->duration = T->period;
+		_k_timer_enlist(T);
+	} else {
+		T->duration = -1;
+	}
+	SENDARGS(T->args);
+}
+
+/**
+ * @brief Handle expired timers
+ *
+ * Advance the timing wheel and activate each task whose timer has now
+ * expired. Only the wheel slots of the elapsed ticks are visited.
+ *
+ * @param ticks Number of ticks
+ * @return N/A
+ */
+void _k_timer_list_update(int ticks)
+{
+	_nano_timeout_wheel_announce(&_k_timer_wheel, ticks, _k_timer_expired);
+}
+
+#else
+
 /**
  * @brief Handle expired timers
  *
@@ -176,12 +276,14 @@ void _k_timer_list_update(int ticks)
 		} else {
 			T->duration = -1;
 		}
-		TO_ALIST(&_k_command_stack, T->args);
+		SENDARGS(T->args);
 
 		ticks = 0; /* don't decrement duration for subsequent timer(s) */
 	}
 }
 
+#endif /* CONFIG_MICROKERNEL_TIMER_WHEEL */
+
 /**
  * @brief Handle timer allocation request
  *
@@ -233,7 +335,7 @@ void _k_timer_dealloc(struct k_args *P)
 	if (T->duration != -1)
 		_k_timer_delist(T);
 
-	FREETIMER(T);
+	FREEPOOLTIMER(T);
 	FREEARGS(A);
 }
 
@@ -365,17 +467,18 @@ void _k_task_sleep(struct k_args *P)
 		return;
 	}
 
-	GETTIMER(T);
+	P->Comm = _K_SVC_TASK_WAKEUP;
+	P->Ctxt.task = _k_current_task;
+
+	T = _k_timeout_get(P->Ctxt.task);
 	T->duration = P->Time.ticks;
 	T->period = 0;
 	T->args = P;
 
-	P->Comm = _K_SVC_TASK_WAKEUP;
-	P->Ctxt.task = _k_current_task;
 	P->Time.timer = T;
 
 	_k_timer_enlist(T);
-	_k_state_bit_set(_k_current_task, TF_TIME);
+	_k_state_bit_set(P->Ctxt.task, TF_TIME);
 }
 
 
@@ -51,35 +51,14 @@ void nano_cpu_set_idle(int32_t ticks)
 
 int32_t _sys_idle_ticks_threshold = CONFIG_TICKLESS_IDLE_THRESH;
 
-#if defined(CONFIG_NANO_TIMEOUTS)
-static inline int32_t get_next_timeout_expiry(void)
+static inline int is_tickless_idle(int32_t ticks)
 {
-	return _nano_get_earliest_timeouts_deadline();
-}
-#else
-#define get_next_timeout_expiry(void) TICKS_UNLIMITED
-#endif
-
-/**
-*
-* @brief - obtain number of ticks until next timer expires
-*
-* Must be called with interrupts locked to prevent the timer queues from
-* changing.
-*
-* @return Number of ticks until next timer expires.
-*
-*/
-
-static inline int32_t get_next_timer_expiry(void)
-{
-	return _nano_timer_list ? _nano_timer_list->ticks : TICKS_UNLIMITED;
+	return (ticks == TICKS_UNLIMITED) || (ticks >= _sys_idle_ticks_threshold);
 }
 
 static inline int was_in_tickless_idle(void)
 {
-	return	(_nanokernel.idle == TICKS_UNLIMITED) ||
-			(_nanokernel.idle >= _sys_idle_ticks_threshold);
+	return is_tickless_idle(_nanokernel.idle);
 }
 
 static inline int must_enter_tickless_idle(void)
@@ -88,14 +67,28 @@ static inline int must_enter_tickless_idle(void)
 	return was_in_tickless_idle();
 }
 
+/*
+ * Obtain number of ticks until next timer or timeout expires
+ *
+ * Must be called with interrupts locked to prevent the timer queues from
+ * changing.
+ */
 static inline int32_t get_next_tick_expiry(void)
 {
-	int32_t timers = get_next_timer_expiry();
-	int32_t timeouts = get_next_timeout_expiry();
-
-	return (int32_t)min((uint32_t)timers, (uint32_t)timeouts);
+	return (int32_t)_nano_get_earliest_deadline();
 }
 
+/**
+ *
+ * @brief Power management policy when the nanokernel begins idling
+ *
+ * This routine is invoked by the architecture's idle routines with interrupts
+ * locked, right before the CPU is put in low-power mode. If no timeout is due
+ * before the tickless idle threshold, it stops the periodic system clock
+ * interrupts until the earliest timeout is due.
+ *
+ * @return N/A
+ */
 void _power_save_idle(void)
 {
 	_nanokernel.idle = get_next_tick_expiry();
@@ -105,6 +98,17 @@ void _power_save_idle(void)
 	}
 }
 
+/**
+ *
+ * @brief Power management policy when the nanokernel stops idling
+ *
+ * This routine is invoked with interrupts locked by the interrupt entry code
+ * of the architectures that do not clear the idle state themselves. The timer
+ * driver announces the ticks that have elapsed while idling, and resumes the
+ * periodic system clock interrupts.
+ *
+ * @return N/A
+ */
 void _power_save_idle_exit(void)
 {
 	if (was_in_tickless_idle()) {
@@ -114,3 +118,30 @@ void _power_save_idle_exit(void)
 }
 
 #endif /* CONFIG_NANOKERNEL && CONFIG_TICKLESS_IDLE */
+
+#if defined(CONFIG_NANOKERNEL) && defined(CONFIG_ADVANCED_POWER_MANAGEMENT)
+
+/**
+ *
+ * @brief Power management policy when the nanokernel stops idling
+ *
+ * This routine is invoked with interrupts locked by the interrupt entry code
+ * of the architectures that clear the idle state themselves, and pass the
+ * number of ticks the kernel was idling for.
+ *
+ * @param ticks the number of ticks the kernel was idling for
+ *
+ * @return N/A
+ */
+void _sys_power_save_idle_exit(int32_t ticks)
+{
+#ifdef CONFIG_TICKLESS_IDLE
+	if (is_tickless_idle(ticks)) {
+		_timer_idle_exit();
+	}
+#else
+	ARG_UNUSED(ticks);
+#endif /* CONFIG_TICKLESS_IDLE */
+}
+
+#endif /* CONFIG_NANOKERNEL && CONFIG_ADVANCED_POWER_MANAGEMENT */
@@ -1,5 +1,5 @@
 /** @file
- * @brief timeout queue for fibers on nanokernel objects
+ * @brief timeout queue for fibers and nanokernel timers
  *
  * This file is meant to be included by nanokernel/include/wait_q.h only
  */
@@ -29,66 +29,127 @@
 extern "C" {
 #endif
 
-/* initialize the nano timeouts part of TCS when enabled in the kernel */
+/*
+ * The timeout queue holds both the fiber timeouts and the entries of other
+ * kernel objects, such as nanokernel timers, that embed a struct
+ * _nano_timeout. The former have no expiry function and are handled here;
+ * the latter have their expiry function invoked from the tick announcement.
+ */
 
-static inline void _nano_timeout_tcs_init(struct tcs *tcs)
+#ifdef CONFIG_NANO_TIMEOUT_WHEEL
+
+#include <timeout_wheel.h>
+
+extern struct _nano_timeout_wheel _nano_timeouts_wheel;
+
+static inline void _nano_timeout_q_init(void)
+{
+	_nano_timeout_wheel_init(&_nano_timeouts_wheel);
+}
+
+/* initialize a timeout, to be expired by calling func (NULL for a fiber) */
+static inline void _nano_timeout_init(struct _nano_timeout *t,
+				      _nano_timeout_func_t func)
+{
+	_nano_timeout_wheel_entry_init(t);
+	t->func = func;
+}
+
+/* arm a timeout that is not already armed */
+static inline void _nano_timeout_enqueue(struct _nano_timeout *t,
+					 int32_t ticks)
+{
+	_nano_timeout_wheel_add(&_nano_timeouts_wheel, t, ticks);
+}
+
+/* disarm a timeout, if armed */
+static inline void _nano_timeout_dequeue(struct _nano_timeout *t)
+{
+	_nano_timeout_wheel_remove(&_nano_timeouts_wheel, t);
+}
+
+/* number of ticks before a timeout expires, 0 if not armed */
+static inline int32_t _nano_timeout_remaining(struct _nano_timeout *t)
+{
+	return _nano_timeout_wheel_remaining(&_nano_timeouts_wheel, t);
+}
+
+/* number of ticks before the closest expiry, (uint32_t)TICKS_UNLIMITED if none */
+static inline uint32_t _nano_timeout_q_earliest(void)
+{
+	return _nano_timeout_wheel_earliest(&_nano_timeouts_wheel);
+}
+
+#else
+
+static inline void _nano_timeout_q_init(void)
+{
+	sys_dlist_init(&_nanokernel.timeout_q);
+}
+
+/* initialize a timeout, to be expired by calling func (NULL for a fiber) */
+static inline void _nano_timeout_init(struct _nano_timeout *t,
+				      _nano_timeout_func_t func)
 {
 	/*
 	 * Must be initialized here and when dequeueing a timeout so that code
 	 * not dealing with timeouts does not have to handle this, such as when
 	 * waiting forever on a semaphore.
 	 */
-	tcs->nano_timeout.delta_ticks_from_prev = -1;
+	t->delta_ticks_from_prev = -1;
+	t->func = func;
 
 	/*
 	 * These are initialized when enqueing on the timeout queue:
 	 *
-	 *   tcs->nano_timeout.node.next
-	 *   tcs->nano_timeout.node.prev
-	 *   tcs->nano_timeout.wait_q
+	 *   t->node.next
+	 *   t->node.prev
 	 */
 }
 
 /*
- * Handle one expired timeout.
- * This removes the fiber from the timeout queue head, and also removes it
- * from the wait queue it is on if waiting for an object. In that case, it
- * also sets the return value to 0/NULL.
+ * callback for sys_dlist_insert_at():
+ *
+ * Returns 1 if the timeout to insert is lower or equal than the next timeout
+ * in the queue, signifying that it should be inserted before the next.
+ * Returns 0 if it is greater.
+ *
+ * If it is greater, the timeout to insert is decremented by the next timeout,
+ * since the timeout queue is a delta queue.  If it lower or equal, decrement
+ * the timeout of the insert point to update its delta queue value, since the
+ * current timeout will be inserted before it.
  */
-
-static inline struct _nano_timeout *_nano_timeout_handle_one_timeout(
-	sys_dlist_t *timeout_q)
+static int _nano_timeout_insert_point_test(sys_dnode_t *test, void *timeout)
 {
-	struct _nano_timeout *t = (void *)sys_dlist_get(timeout_q);
-	struct tcs *tcs = CONTAINER_OF(t, struct tcs, nano_timeout);
+	struct _nano_timeout *t = (void *)test;
+	int32_t *timeout_to_insert = timeout;
 
-	if (tcs->nano_timeout.wait_q) {
-		_nano_timeout_remove_tcs_from_wait_q(tcs);
-		fiberRtnValueSet(tcs, (unsigned int)0);
+	if (*timeout_to_insert > t->delta_ticks_from_prev) {
+		*timeout_to_insert -= t->delta_ticks_from_prev;
+		return 0;
 	}
-	_nano_fiber_ready(tcs);
-	t->delta_ticks_from_prev = -1;
 
-	return (struct _nano_timeout *)sys_dlist_peek_head(timeout_q);
+	t->delta_ticks_from_prev -= *timeout_to_insert;
+	return 1;
 }
 
-/* loop over all expired timeouts and handle them one by one */
-static inline void _nano_timeout_handle_timeouts(void)
+/*
+ * Arm a timeout that is not already armed. A timeout of less than one tick
+ * expires on the next tick.
+ */
+static inline void _nano_timeout_enqueue(struct _nano_timeout *t,
+					 int32_t ticks)
 {
-	sys_dlist_t *timeout_q = &_nanokernel.timeout_q;
-	struct _nano_timeout *next;
-
-	next = (struct _nano_timeout *)sys_dlist_peek_head(timeout_q);
-	while (next && next->delta_ticks_from_prev == 0) {
-		next = _nano_timeout_handle_one_timeout(timeout_q);
-	}
+	t->delta_ticks_from_prev = max(ticks, 1);
+	sys_dlist_insert_at(&_nanokernel.timeout_q, (void *)t,
+			    _nano_timeout_insert_point_test,
+			    &t->delta_ticks_from_prev);
 }
 
-/* abort a timeout for a specific fiber */
-static inline void _nano_timeout_abort(struct tcs *tcs)
+/* disarm a timeout, if armed */
+static inline void _nano_timeout_dequeue(struct _nano_timeout *t)
 {
 	sys_dlist_t *timeout_q = &_nanokernel.timeout_q;
-	struct _nano_timeout *t = &tcs->nano_timeout;
 
 	if (-1 == t->delta_ticks_from_prev) {
 		return;
@@ -104,30 +165,108 @@ static inline void _nano_timeout_abort(struct tcs *tcs)
 	t->delta_ticks_from_prev = -1;
 }
 
+/* number of ticks before a timeout expires, 0 if not armed */
+static inline int32_t _nano_timeout_remaining(struct _nano_timeout *t)
+{
+	sys_dlist_t *timeout_q = &_nanokernel.timeout_q;
+	sys_dnode_t *node = &t->node;
+	int32_t remaining;
+
+	if (-1 == t->delta_ticks_from_prev) {
+		return 0;
+	}
+
+	/* sum up the deltas of the timeouts expiring up to this one */
+	remaining = t->delta_ticks_from_prev;
+	while (!sys_dlist_is_head(timeout_q, node)) {
+		node = node->prev;
+		remaining += ((struct _nano_timeout *)node)->delta_ticks_from_prev;
+	}
+
+	return remaining;
+}
+
+/* number of ticks before the closest expiry, (uint32_t)TICKS_UNLIMITED if none */
+static inline uint32_t _nano_timeout_q_earliest(void)
+{
+	sys_dlist_t *q = &_nanokernel.timeout_q;
+	struct _nano_timeout *t = (struct _nano_timeout *)sys_dlist_peek_head(q);
+
+	return t ? (uint32_t)t->delta_ticks_from_prev
+		 : (uint32_t)TICKS_UNLIMITED;
+}
+
+#endif /* CONFIG_NANO_TIMEOUT_WHEEL */
+
 /*
- * callback for sys_dlist_insert_at():
- *
- * Returns 1 if the timeout to insert is lower or equal than the next timeout
- * in the queue, signifying that it should be inserted before the next.
- * Returns 0 if it is greater.
- *
- * If it is greater, the timeout to insert is decremented by the next timeout,
- * since the timeout queue is a delta queue.  If it lower or equal, decrement
- * the timeout of the insert point to update its delta queue value, since the
- * current timeout will be inserted before it.
+ * Handle one expired timeout.
+ * The timeout has already been disarmed. If it belongs to a fiber, this
+ * removes the fiber from the wait queue it is on if waiting for an object. In
+ * that case, it also sets the return value to 0/NULL. Otherwise, the expiry
+ * function of the timeout is invoked.
  */
-static int _nano_timeout_insert_point_test(sys_dnode_t *test, void *timeout)
+static inline void _nano_timeout_handle_one_timeout(struct _nano_timeout *t)
 {
-	struct _nano_timeout *t = (void *)test;
-	int32_t *timeout_to_insert = timeout;
+#ifdef CONFIG_NANO_TIMEOUTS
+	if (!t->func) {
+		struct tcs *tcs = CONTAINER_OF(t, struct tcs, nano_timeout);
 
-	if (*timeout_to_insert > t->delta_ticks_from_prev) {
-		*timeout_to_insert -= t->delta_ticks_from_prev;
-		return 0;
+		if (tcs->nano_timeout.wait_q) {
+			_nano_timeout_remove_tcs_from_wait_q(tcs);
+			fiberRtnValueSet(tcs, (unsigned int)0);
+		}
+		_nano_fiber_ready(tcs);
+		return;
 	}
+#endif
 
-	t->delta_ticks_from_prev -= *timeout_to_insert;
-	return 1;
+	t->func(t);
+}
+
+#ifdef CONFIG_NANO_TIMEOUT_WHEEL
+
+/* advance the timeout wheel and handle all expired timeouts */
+static inline void _nano_timeout_handle_timeouts(int32_t ticks)
+{
+	_nano_timeout_wheel_announce(&_nano_timeouts_wheel, ticks,
+				     _nano_timeout_handle_one_timeout);
+}
+
+#else
+
+/* loop over all expired timeouts and handle them one by one */
+static inline void _nano_timeout_handle_timeouts(int32_t ticks)
+{
+	sys_dlist_t *timeout_q = &_nanokernel.timeout_q;
+	struct _nano_timeout *next;
+
+	next = (struct _nano_timeout *)sys_dlist_peek_head(timeout_q);
+	if (next) {
+		next->delta_ticks_from_prev -= ticks;
+	}
+	while (next && next->delta_ticks_from_prev == 0) {
+		struct _nano_timeout *t = (void *)sys_dlist_get(timeout_q);
+
+		t->delta_ticks_from_prev = -1;
+		_nano_timeout_handle_one_timeout(t);
+		next = (struct _nano_timeout *)sys_dlist_peek_head(timeout_q);
+	}
+}
+
+#endif /* CONFIG_NANO_TIMEOUT_WHEEL */
+
+#ifdef CONFIG_NANO_TIMEOUTS
+
+/* initialize the nano timeouts part of TCS when enabled in the kernel */
+static inline void _nano_timeout_tcs_init(struct tcs *tcs)
+{
+	_nano_timeout_init(&tcs->nano_timeout, NULL);
+}
+
+/* abort a timeout for a specific fiber */
+static inline void _nano_timeout_abort(struct tcs *tcs)
+{
+	_nano_timeout_dequeue(&tcs->nano_timeout);
 }
 
 /* put a fiber on the timeout queue and record its wait queue */
@@ -135,27 +274,26 @@ static inline void _nano_timeout_add(struct tcs *tcs,
 				     struct _nano_queue *wait_q,
 				     int32_t timeout)
 {
-	sys_dlist_t *timeout_q = &_nanokernel.timeout_q;
-	struct _nano_timeout *t = &tcs->nano_timeout;
-
-	t->delta_ticks_from_prev = timeout;
-	t->wait_q = wait_q;
-	sys_dlist_insert_at(timeout_q, (void *)t,
-						_nano_timeout_insert_point_test,
-						&t->delta_ticks_from_prev);
+	tcs->nano_timeout.wait_q = wait_q;
+	_nano_timeout_enqueue(&tcs->nano_timeout, timeout);
 }
 
-/* find the closest deadline in the timeout queue */
+/* find the closest deadline in the timeout queue, including the task's */
 static inline uint32_t _nano_get_earliest_timeouts_deadline(void)
 {
-	sys_dlist_t *q = &_nanokernel.timeout_q;
-	struct _nano_timeout *t = (struct _nano_timeout *)sys_dlist_peek_head(q);
+	return min(_nano_timeout_q_earliest(),
+		   (uint32_t)_nanokernel.task_timeout);
+}
 
-	return t ? min((uint32_t)t->delta_ticks_from_prev,
-					(uint32_t)_nanokernel.task_timeout)
-			 : (uint32_t)_nanokernel.task_timeout;
+#else
+
+static inline uint32_t _nano_get_earliest_timeouts_deadline(void)
+{
+	return _nano_timeout_q_earliest();
 }
 
+#endif /* CONFIG_NANO_TIMEOUTS */
+
 #ifdef __cplusplus
 }
 #endif
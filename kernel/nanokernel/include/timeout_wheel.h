@@ -0,0 +1,82 @@
+/** @file
+ * @brief hashed timing wheel for nanokernel timeouts and timers
+ *
+ * A timing wheel keeps each armed timeout on the slot indexed by its absolute
+ * expiry tick, modulo the number of slots, sorted by expiry. Arming a timeout
+ * only walks the timeouts of its slot that expire no later than it, and
+ * cancelling one takes constant time unless it holds the closest expiry of
+ * the wheel. An announced tick only visits the slots that come due, and the
+ * closest expiry is known without searching.
+ */
+
+/*
+ * Copyright (c) 2016 Wind River Systems, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _kernel_nanokernel_include_timeout_wheel__h_
+#define _kernel_nanokernel_include_timeout_wheel__h_
+
+#include <nanokernel.h>
+#include <misc/dlist.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if (CONFIG_NANO_TIMEOUT_WHEEL_SLOTS & (CONFIG_NANO_TIMEOUT_WHEEL_SLOTS - 1))
+#error CONFIG_NANO_TIMEOUT_WHEEL_SLOTS must be a power of two
+#endif
+
+struct _nano_timeout_wheel {
+	uint32_t now;	/* tick up to which the wheel has been advanced */
+	uint32_t earliest;	/* closest expiry, if num_armed is not 0 */
+	uint32_t num_armed;	/* timeouts on the slots */
+	sys_dlist_t slots[CONFIG_NANO_TIMEOUT_WHEEL_SLOTS];
+};
+
+extern void _nano_timeout_wheel_init(struct _nano_timeout_wheel *wheel);
+extern void _nano_timeout_wheel_add(struct _nano_timeout_wheel *wheel,
+				    struct _nano_timeout *t, int32_t ticks);
+extern void _nano_timeout_wheel_announce(struct _nano_timeout_wheel *wheel,
+					 int32_t ticks,
+					 _nano_timeout_func_t expired);
+extern void _nano_timeout_wheel_remove(struct _nano_timeout_wheel *wheel,
+				       struct _nano_timeout *t);
+extern uint32_t _nano_timeout_wheel_earliest(struct _nano_timeout_wheel *wheel);
+
+/* a timeout that is not armed has its node unlinked */
+static inline void _nano_timeout_wheel_entry_init(struct _nano_timeout *t)
+{
+	t->node.next = NULL;
+}
+
+static inline int _nano_timeout_wheel_is_armed(struct _nano_timeout *t)
+{
+	return t->node.next != NULL;
+}
+
+/* number of ticks before an armed timeout expires, 0 if not armed */
+static inline int32_t _nano_timeout_wheel_remaining(
+	struct _nano_timeout_wheel *wheel, struct _nano_timeout *t)
+{
+	return _nano_timeout_wheel_is_armed(t) ?
+		(int32_t)(t->expiry - wheel->now) : 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _kernel_nanokernel_include_timeout_wheel__h_ */
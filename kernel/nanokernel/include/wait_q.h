@@ -67,12 +67,36 @@ static inline struct tcs *_nano_wait_q_remove(struct _nano_queue *wait_q)
 	return wait_q->head ? _nano_wait_q_remove_no_check(wait_q) : NULL;
 }
 
+#ifdef CONFIG_NANO_PRIO_WAIT_QUEUES
+/*
+ * Put current fiber on specified wait queue, following any waiting fiber of
+ * higher or equal priority. The queue is kept NULL-terminated so that it can
+ * be walked.
+ */
+static inline void _nano_wait_q_put(struct _nano_queue *wait_q)
+{
+	struct tcs *tcs = _nanokernel.current;
+	struct tcs *prev = (struct tcs *)&wait_q->head;
+
+	while (prev->link && (prev->link->prio <= tcs->prio)) {
+		prev = prev->link;
+	}
+
+	tcs->link = prev->link;
+	prev->link = tcs;
+
+	if (!tcs->link) {
+		wait_q->tail = tcs;
+	}
+}
+#else
 /* put current fiber on specified wait queue */
 static inline void _nano_wait_q_put(struct _nano_queue *wait_q)
 {
 	((struct tcs *)wait_q->tail)->link = _nanokernel.current;
 	wait_q->tail = _nanokernel.current;
 }
+#endif /* CONFIG_NANO_PRIO_WAIT_QUEUES */
 
 #ifdef CONFIG_NANO_TIMEOUTS
 static inline void _nano_timeout_remove_tcs_from_wait_q(struct tcs *tcs)
@@ -97,8 +121,15 @@ static inline void _nano_timeout_remove_tcs_from_wait_q(struct tcs *tcs)
 		}
 	}
 }
+#endif
+
+#if defined(CONFIG_NANO_TIMEOUTS) || defined(CONFIG_NANO_TIMERS)
 #include <timeout_q.h>
+#else
+	#define _nano_get_earliest_timeouts_deadline() ((uint32_t)TICKS_UNLIMITED)
+#endif
 
+#ifdef CONFIG_NANO_TIMEOUTS
 	#define _NANO_TIMEOUT_TICK_GET()  sys_tick_get()
 
 	#define _NANO_TIMEOUT_ADD(pq, ticks)                                 \
@@ -109,14 +140,18 @@ static inline void _nano_timeout_remove_tcs_from_wait_q(struct tcs *tcs)
 		} while (0)
 	#define _NANO_TIMEOUT_SET_TASK_TIMEOUT(ticks) \
 		_nanokernel.task_timeout = (ticks)
+	/* ticks left before the tick @limit of a task polling with @ticks */
+	#define _NANO_TIMEOUT_TICKS_LEFT(ticks, limit, cur_ticks)  \
+		(((ticks) == TICKS_UNLIMITED) ? TICKS_UNLIMITED :    \
+		 (int32_t)((limit) - (cur_ticks)))
 #else
 	#define _nano_timeout_tcs_init(tcs) do { } while ((0))
 	#define _nano_timeout_abort(tcs) do { } while ((0))
-	#define _nano_get_earliest_timeouts_deadline() ((uint32_t)TICKS_UNLIMITED)
 
 	#define _NANO_TIMEOUT_TICK_GET()  0
 	#define _NANO_TIMEOUT_ADD(pq, ticks) do { } while (0)
 	#define _NANO_TIMEOUT_SET_TASK_TIMEOUT(ticks) do { } while ((0))
+	#define _NANO_TIMEOUT_TICKS_LEFT(ticks, limit, cur_ticks) (ticks)
 #endif
 
 #ifdef __cplusplus
@@ -159,6 +159,58 @@ void *sys_thread_custom_data_get(void)
 
 #endif /* CONFIG_THREAD_CUSTOM_DATA */
 
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+
+/* cycle count at which the current thread was switched in */
+static uint32_t _thread_runtime_stamp;
+
+/**
+ *
+ * @brief Account the run time of the outgoing thread
+ *
+ * This routine is invoked by _Swap() on every context switch, with interrupts
+ * locked, before the incoming thread is selected. It charges the cycles
+ * elapsed since the previous context switch to the outgoing thread.
+ *
+ * @return N/A
+ */
+void _sys_thread_runtime_switch(void)
+{
+	uint32_t now = sys_cycle_get_32();
+
+	_nanokernel.current->runtime += now - _thread_runtime_stamp;
+	_thread_runtime_stamp = now;
+}
+
+/**
+ *
+ * @brief Get the run time of a thread
+ *
+ * This routine returns the number of hardware clock cycles during which the
+ * specified task or fiber has been running, including the cycles elapsed
+ * since it was last switched in if it is the current thread. Time spent in
+ * ISRs is charged to the thread that they interrupted.
+ *
+ * @param thread thread to query
+ *
+ * @return run time, in hardware clock cycles
+ */
+uint64_t sys_thread_runtime_get(nano_thread_id_t thread)
+{
+	unsigned int key = irq_lock();
+	uint64_t runtime = thread->runtime;
+
+	if (thread == _nanokernel.current) {
+		runtime += sys_cycle_get_32() - _thread_runtime_stamp;
+	}
+
+	irq_unlock(key);
+
+	return runtime;
+}
+
+#endif /* CONFIG_THREAD_RUNTIME_STATS */
+
 #if defined(CONFIG_THREAD_MONITOR)
 /**
  *
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2016 Wind River Systems, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file
+ * @brief Nanokernel earliest deadline first fiber scheduling
+ *
+ * This module provides the routines that let a fiber be scheduled by earliest
+ * deadline first. The ordering of such fibers in the list of runnable fibers
+ * is done by _nano_fiber_ready().
+ */
+
+#include <nano_private.h>
+#include <nano_internal.h>
+#include <toolchain.h>
+#include <sections.h>
+#include <wait_q.h>
+
+void fiber_deadline_set(int32_t period, int32_t deadline)
+{
+	struct tcs *tcs = _nanokernel.current;
+	unsigned int key;
+
+	key = irq_lock();
+
+	tcs->prio = CONFIG_NANO_FIBER_EDF_PRIO;
+	tcs->edf.period = period;
+	tcs->edf.rel_deadline = max(deadline, 1);
+	tcs->edf.release = sys_tick_get_32();
+	tcs->edf.deadline = tcs->edf.release + tcs->edf.rel_deadline;
+
+	irq_unlock(key);
+}
+
+int fiber_period_wait(void)
+{
+	struct tcs *tcs = _nanokernel.current;
+	int32_t delay;
+	int missed;
+	unsigned int key;
+
+	key = irq_lock();
+
+	missed = (int32_t)(sys_tick_get_32() - tcs->edf.deadline) > 0;
+
+	/*
+	 * A job that overran its period leaves the next one released at once,
+	 * with a deadline that may already be behind.
+	 */
+
+	tcs->edf.release += tcs->edf.period;
+	tcs->edf.deadline = tcs->edf.release + tcs->edf.rel_deadline;
+	delay = (int32_t)(tcs->edf.release - sys_tick_get_32());
+
+	if (delay > 0) {
+		_nano_timeout_add(tcs, NULL, delay);
+	} else {
+		_nano_fiber_ready(tcs);
+	}
+	_Swap(key);
+
+	return missed;
+}
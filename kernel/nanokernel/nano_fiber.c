@@ -28,6 +28,174 @@
 #include <toolchain.h>
 #include <sections.h>
 
+#ifdef CONFIG_NANO_FIBER_EDF
+/**
+ *
+ * @brief Check if a fiber is to be queued behind another one
+ *
+ * Fibers are ordered by priority. Among the fibers of the priority reserved
+ * for earliest deadline first scheduling, those that have a deadline are
+ * ordered by deadline, and precede those that have none. Fibers of equal
+ * rank are ordered first-in first-out.
+ *
+ * @return 1 if @a tcs is to be queued behind @a other, 0 otherwise
+ */
+static inline int _fiber_ready_follows(struct tcs *tcs, struct tcs *other)
+{
+	if ((tcs->prio != other->prio) ||
+	    (tcs->prio != CONFIG_NANO_FIBER_EDF_PRIO)) {
+		return tcs->prio >= other->prio;
+	}
+
+	if (tcs->edf.rel_deadline == 0) {
+		return 1;
+	}
+
+	return (other->edf.rel_deadline != 0) &&
+	       ((int32_t)(tcs->edf.deadline - other->edf.deadline) >= 0);
+}
+#else
+#define _fiber_ready_follows(tcs, other) ((tcs)->prio >= (other)->prio)
+#endif /* CONFIG_NANO_FIBER_EDF */
+
+#ifdef CONFIG_NANO_FIBER_PRIO_QUEUES
+
+#define FIBER_PRIO_LAST (CONFIG_NUM_FIBER_PRIORITIES - 1)
+#define FIBER_PRIO_WORDS ((CONFIG_NUM_FIBER_PRIORITIES + 31) >> 5)
+
+/*
+ * Multi-level ready queue bookkeeping.
+ *
+ * The runnable fibers remain chained through _nanokernel.fiber in priority
+ * order, since the architecture-specific _Swap() and interrupt exit code
+ * dequeue the next fiber directly from the head of that list. Each priority
+ * level additionally tracks the last fiber queued at that level, and a bitmap
+ * records which levels are non-empty, so that the insertion point of a fiber
+ * is found without walking the list.
+ *
+ * Fibers are only ever dequeued from the head of the list, so a level whose
+ * fibers have all been dequeued is always numerically lower than the level of
+ * the current head; such stale levels are pruned from the bitmap before each
+ * insertion.
+ *
+ * Priorities numerically greater than or equal to FIBER_PRIO_LAST share the
+ * last level, within which fibers are kept sorted by their actual priority.
+ * The level of the earliest deadline first priority is kept sorted by
+ * deadline. The insertion point within these two levels is found by walking
+ * them.
+ */
+static struct {
+	uint32_t bitmap[FIBER_PRIO_WORDS];
+	struct tcs *tail[CONFIG_NUM_FIBER_PRIORITIES];
+} ready_q;
+
+static inline int _fiber_prio_level(int prio)
+{
+	return ((unsigned int)prio < FIBER_PRIO_LAST) ? prio : FIBER_PRIO_LAST;
+}
+
+#ifdef CONFIG_NANO_FIBER_EDF
+#define _fiber_level_is_sorted(level) \
+	(((level) == FIBER_PRIO_LAST) || \
+	 ((level) == _fiber_prio_level(CONFIG_NANO_FIBER_EDF_PRIO)))
+#else
+#define _fiber_level_is_sorted(level) ((level) == FIBER_PRIO_LAST)
+#endif
+
+/**
+ *
+ * @brief Discard the levels whose fibers have all been dequeued
+ *
+ * @return N/A
+ */
+static inline void _fiber_ready_q_prune(void)
+{
+	struct tcs *head = _nanokernel.fiber;
+	int level;
+	int word;
+
+	level = head ? _fiber_prio_level(head->prio) :
+		       CONFIG_NUM_FIBER_PRIORITIES;
+
+	for (word = 0; word < (level >> 5); word++) {
+		ready_q.bitmap[word] = 0;
+	}
+
+	if (level & 0x1F) {
+		ready_q.bitmap[level >> 5] &= ~((1U << (level & 0x1F)) - 1);
+	}
+}
+
+/**
+ *
+ * @brief Find the fiber preceding the first fiber of the specified level
+ *
+ * @param level priority level
+ *
+ * @return last fiber of the closest non-empty higher priority level, or the
+ * list head if there is no such level
+ */
+static inline struct tcs *_fiber_ready_q_pred(int level)
+{
+	int word = level >> 5;
+	uint32_t bits = ready_q.bitmap[word] & ((1U << (level & 0x1F)) - 1);
+
+	while (bits == 0) {
+		if (--word < 0) {
+			return (struct tcs *)&_nanokernel.fiber;
+		}
+		bits = ready_q.bitmap[word];
+	}
+
+	return ready_q.tail[(word << 5) + find_msb_set(bits) - 1];
+}
+
+/**
+ *
+ * @brief Add a fiber to the list of runnable fibers
+ *
+ * The list of runnable fibers is maintained via a single linked list
+ * in priority order. Numerically lower priorities represent higher priority
+ * fibers. The insertion point is located through the per-level ready queue
+ * bookkeeping, in constant time.
+ *
+ * Interrupts must already be locked to ensure list cannot change
+ * while this routine is executing!
+ *
+ * @return N/A
+ */
+void _nano_fiber_ready(struct tcs *tcs)
+{
+	int level = _fiber_prio_level(tcs->prio);
+	uint32_t bit = 1U << (level & 0x1F);
+	struct tcs *pQ;
+
+	_fiber_ready_q_prune();
+
+	if (_fiber_level_is_sorted(level)) {
+		pQ = _fiber_ready_q_pred(level);
+		while (pQ->link && _fiber_ready_follows(tcs, pQ->link)) {
+			pQ = pQ->link;
+		}
+	} else if (ready_q.bitmap[level >> 5] & bit) {
+		pQ = ready_q.tail[level];
+	} else {
+		pQ = _fiber_ready_q_pred(level);
+	}
+
+	/* Insert fiber, following any equal priority fibers */
+
+	tcs->link = pQ->link;
+	pQ->link = tcs;
+
+	if (!(ready_q.bitmap[level >> 5] & bit) || (pQ == ready_q.tail[level])) {
+		ready_q.tail[level] = tcs;
+	}
+	ready_q.bitmap[level >> 5] |= bit;
+}
+
+#else
+
 /**
  *
  * @brief Add a fiber to the list of runnable fibers
@@ -50,7 +218,7 @@ void _nano_fiber_ready(struct tcs *tcs)
 	 * higher priority is located.
 	 */
 
-	while (pQ->link && (tcs->prio >= pQ->link->prio)) {
+	while (pQ->link && _fiber_ready_follows(tcs, pQ->link)) {
 		pQ = pQ->link;
 	}
 
@@ -60,6 +228,7 @@ void _nano_fiber_ready(struct tcs *tcs)
 	pQ->link = tcs;
 }
 
+#endif /* CONFIG_NANO_FIBER_PRIO_QUEUES */
 
 /* currently the fiber and task implementations are identical */
 
@@ -24,6 +24,7 @@
  *
  * nano_fifo_init
  * nano_fiber_fifo_put, nano_task_fifo_put, nano_isr_fifo_put
+ * nano_fiber_fifo_put_list, nano_task_fifo_put_list, nano_isr_fifo_put_list
  * nano_fiber_fifo_get, nano_task_fifo_get, nano_isr_fifo_get
  * nano_fifo_get
  */
@@ -158,6 +159,110 @@ void nano_fifo_put(struct nano_fifo *fifo, void *data)
 	func[sys_execution_context_type_get()](fifo, data);
 }
 
+FUNC_ALIAS(_fifo_put_list_non_preemptible, nano_isr_fifo_put_list, void);
+FUNC_ALIAS(_fifo_put_list_non_preemptible, nano_fiber_fifo_put_list, void);
+
+/**
+ *
+ * @brief Internal routine to append a list of elements to a fifo
+ *
+ * The elements are handed to the waiting fibers first, in order, and the
+ * remaining ones are linked to the end of the fifo as a whole. Must be called
+ * with interrupts locked.
+ *
+ * @return 1 if a fiber was made ready, 0 otherwise
+ */
+static inline int put_list(struct nano_fifo *fifo, void *head, void *tail)
+{
+	int readied = 0;
+	void *data = head;
+	void *next;
+	int num_data;
+
+	while (fifo->stat < 0) {
+		struct tcs *tcs = _nano_wait_q_remove_no_check(&fifo->wait_q);
+
+		next = *(void **)data;
+		fifo->stat++;
+		_nano_timeout_abort(tcs);
+		fiberRtnValueSet(tcs, (unsigned int)data);
+		readied = 1;
+
+		if (data == tail) {
+			return readied;
+		}
+		data = next;
+	}
+
+	for (num_data = 1, next = data; next != tail; num_data++) {
+		next = *(void **)next;
+	}
+
+	*(void **)fifo->data_q.tail = data;
+	fifo->data_q.tail = tail;
+	*(int *)tail = 0;
+	fifo->stat += num_data;
+
+	return readied;
+}
+
+/**
+ *
+ * @brief Append a list of elements to a fifo (no context switch)
+ *
+ * This routine adds a list of elements to the end of a fifo object; it may be
+ * called from either a fiber or an ISR context. The fibers pending on the
+ * fifo object that receive an element will be made ready, but will NOT be
+ * scheduled to execute.
+ *
+ * @param fifo FIFO on which to interact.
+ * @param head First element of the list.
+ * @param tail Last element of the list.
+ *
+ * @return N/A
+ *
+ * INTERNAL
+ * This function is capable of supporting invocations from both a fiber and an
+ * ISR context.  However, the nano_isr_fifo_put_list and
+ * nano_fiber_fifo_put_list aliases are created to support any required
+ * implementation differences in the future without introducing a source code
+ * migration issue.
+ */
+void _fifo_put_list_non_preemptible(struct nano_fifo *fifo, void *head,
+				    void *tail)
+{
+	unsigned int imask;
+
+	imask = irq_lock();
+	put_list(fifo, head, tail);
+	irq_unlock(imask);
+}
+
+void nano_task_fifo_put_list(struct nano_fifo *fifo, void *head, void *tail)
+{
+	unsigned int imask;
+
+	imask = irq_lock();
+
+	if (put_list(fifo, head, tail)) {
+		_Swap(imask);
+		return;
+	}
+
+	irq_unlock(imask);
+}
+
+void nano_fifo_put_list(struct nano_fifo *fifo, void *head, void *tail)
+{
+	static void (*func[3])(struct nano_fifo *fifo, void *head, void *tail) = {
+		nano_isr_fifo_put_list,
+		nano_fiber_fifo_put_list,
+		nano_task_fifo_put_list
+	};
+
+	func[sys_execution_context_type_get()](fifo, head, tail);
+}
+
 /**
  *
  * @brief Internal routine to remove data from a fifo
@@ -236,7 +341,9 @@ void *nano_task_fifo_get(struct nano_fifo *fifo, int32_t timeout_in_ticks)
 
 		if (timeout_in_ticks != TICKS_NONE) {
 
-			_NANO_TIMEOUT_SET_TASK_TIMEOUT(timeout_in_ticks);
+			_NANO_TIMEOUT_SET_TASK_TIMEOUT(
+				_NANO_TIMEOUT_TICKS_LEFT(timeout_in_ticks,
+							 limit, cur_ticks));
 
 			/* see explanation in nano_stack.c:nano_task_stack_pop() */
 			nano_cpu_atomic_idle(key);
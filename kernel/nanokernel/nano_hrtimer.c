@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2016 Wind River Systems, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file
+ * @brief High resolution timers
+ *
+ * This module implements timers whose expiry is expressed in hardware clock
+ * cycles rather than in system clock ticks. The armed timers are kept sorted
+ * by absolute expiry cycle, and the system timer driver is asked to raise an
+ * interrupt at the expiry of the first one, independently of the system clock
+ * tick. Expired timers are handled in the context of that interrupt.
+ */
+
+#include <nano_private.h>
+#include <misc/dlist.h>
+#include <drivers/system_timer.h>
+
+/* armed high resolution timers, sorted by expiry */
+static sys_dlist_t _hrtimer_queue = {
+	{ &_hrtimer_queue }, { &_hrtimer_queue }
+};
+
+static inline int _hrtimer_is_armed(struct sys_hrtimer *timer)
+{
+	return timer->node.next != NULL;
+}
+
+/* program the timer driver for the first armed timer, if any */
+static void _hrtimer_deadline_update(void)
+{
+	struct sys_hrtimer *first =
+		(struct sys_hrtimer *)sys_dlist_peek_head(&_hrtimer_queue);
+
+	if (first) {
+		_timer_hr_deadline_set(first->expiry);
+	} else {
+		_timer_hr_deadline_cancel();
+	}
+}
+
+/* must be called with interrupts locked */
+static void _hrtimer_remove(struct sys_hrtimer *timer)
+{
+	sys_dlist_remove(&timer->node);
+	timer->node.next = NULL;
+}
+
+/* must be called with interrupts locked */
+static void _hrtimer_insert(struct sys_hrtimer *timer)
+{
+	sys_dnode_t *pos;
+
+	/*
+	 * Expiries are compared by their signed difference so that the
+	 * ordering survives the wrap-around of the cycle counter, provided
+	 * that no two timers expire more than 2^31 cycles apart.
+	 */
+
+	for (pos = sys_dlist_peek_head(&_hrtimer_queue); pos;
+	     pos = sys_dlist_peek_next(&_hrtimer_queue, pos)) {
+		struct sys_hrtimer *t = (struct sys_hrtimer *)pos;
+
+		if ((int32_t)(t->expiry - timer->expiry) > 0) {
+			break;
+		}
+	}
+
+	sys_dlist_insert_before(&_hrtimer_queue, pos, &timer->node);
+}
+
+void sys_hrtimer_init(struct sys_hrtimer *timer, sys_hrtimer_func_t func)
+{
+	timer->node.next = NULL;
+	timer->func = func;
+}
+
+void sys_hrtimer_start(struct sys_hrtimer *timer, uint32_t cycles)
+{
+	unsigned int key = irq_lock();
+
+	if (_hrtimer_is_armed(timer)) {
+		_hrtimer_remove(timer);
+	}
+
+	timer->expiry = sys_cycle_get_32() + cycles;
+	_hrtimer_insert(timer);
+
+	if (sys_dlist_is_head(&_hrtimer_queue, &timer->node)) {
+		_timer_hr_deadline_set(timer->expiry);
+	}
+
+	irq_unlock(key);
+}
+
+void sys_hrtimer_stop(struct sys_hrtimer *timer)
+{
+	unsigned int key = irq_lock();
+
+	if (_hrtimer_is_armed(timer)) {
+		int was_first = sys_dlist_is_head(&_hrtimer_queue,
+						  &timer->node);
+
+		_hrtimer_remove(timer);
+
+		if (was_first) {
+			_hrtimer_deadline_update();
+		}
+	}
+
+	irq_unlock(key);
+}
+
+int sys_hrtimer_is_running(struct sys_hrtimer *timer)
+{
+	return _hrtimer_is_armed(timer);
+}
+
+/**
+ *
+ * @brief Handle the high resolution timer interrupt
+ *
+ * This routine is invoked by the system timer driver, in ISR context, when
+ * the deadline it was last given is reached. The timers that are due are
+ * disarmed and their expiry functions invoked, in expiry order, after which
+ * the driver is given the deadline of the next armed timer.
+ *
+ * The cycle counter is read again after each expiry function, so that timers
+ * that come due while they run are handled without another interrupt.
+ *
+ * @return N/A
+ */
+void _sys_hrtimer_announce(void)
+{
+	unsigned int key = irq_lock();
+	struct sys_hrtimer *timer;
+
+	while ((timer = (struct sys_hrtimer *)
+			sys_dlist_peek_head(&_hrtimer_queue)) != NULL) {
+		if ((int32_t)(timer->expiry - sys_cycle_get_32()) > 0) {
+			break;
+		}
+
+		_hrtimer_remove(timer);
+
+		irq_unlock(key);
+		timer->func(timer);
+		key = irq_lock();
+	}
+
+	_hrtimer_deadline_update();
+
+	irq_unlock(key);
+}
@@ -82,11 +82,11 @@ char __noinit __stack main_task_stack[CONFIG_MAIN_STACK_SIZE];
 
 char __noinit _interrupt_stack[CONFIG_ISR_STACK_SIZE];
 
-#ifdef CONFIG_NANO_TIMEOUTS
-	#include <misc/dlist.h>
+#if defined(CONFIG_NANO_TIMEOUTS) || defined(CONFIG_NANO_TIMERS)
+	#include <wait_q.h>
 	#define initialize_nano_timeouts() do { \
-		sys_dlist_init(&_nanokernel.timeout_q); \
-		_nanokernel.task_timeout = TICKS_UNLIMITED; \
+		_nano_timeout_q_init(); \
+		_NANO_TIMEOUT_SET_TASK_TIMEOUT(TICKS_UNLIMITED); \
 	} while ((0))
 #else
 	#define initialize_nano_timeouts() do { } while ((0))
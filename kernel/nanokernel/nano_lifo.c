@@ -163,7 +163,9 @@ void *nano_task_lifo_get(struct nano_lifo *lifo, int32_t timeout_in_ticks)
 
 		if (timeout_in_ticks != TICKS_NONE) {
 
-			_NANO_TIMEOUT_SET_TASK_TIMEOUT(timeout_in_ticks);
+			_NANO_TIMEOUT_SET_TASK_TIMEOUT(
+				_NANO_TIMEOUT_TICKS_LEFT(timeout_in_ticks,
+							 limit, cur_ticks));
 
 			/* see explanation in nano_stack.c:nano_task_stack_pop() */
 			nano_cpu_atomic_idle(imask);
@@ -24,6 +24,7 @@
  *
  * nano_sem_init
  * nano_fiber_sem_give, nano_task_sem_give, nano_isr_sem_give
+ * nano_fiber_sem_give_n, nano_task_sem_give_n, nano_isr_sem_give_n
  * nano_fiber_sem_take, nano_task_sem_take, nano_isr_sem_take
  * nano_sem_take
  *
@@ -121,6 +122,73 @@ void nano_sem_give(struct nano_sem *sem)
 	func[sys_execution_context_type_get()](sem);
 }
 
+FUNC_ALIAS(_sem_give_n_non_preemptible, nano_isr_sem_give_n, void);
+FUNC_ALIAS(_sem_give_n_non_preemptible, nano_fiber_sem_give_n, void);
+
+/**
+ * INTERNAL
+ * Wake up to @a count of the fibers pending on the semaphore and add the
+ * remaining count to the semaphore. Must be called with interrupts locked.
+ * Returns 1 if a fiber was made ready, 0 otherwise.
+ */
+static inline int sem_give_n(struct nano_sem *sem, int count)
+{
+	struct tcs *tcs;
+	int readied = 0;
+
+	while ((count > 0) && (tcs = _nano_wait_q_remove(&sem->wait_q))) {
+		_nano_timeout_abort(tcs);
+		set_sem_available(tcs);
+		readied = 1;
+		count--;
+	}
+
+	sem->nsig += count;
+
+	return readied;
+}
+
+/**
+ * INTERNAL
+ * This function is capable of supporting invocations from both a fiber and an
+ * ISR context.  However, the nano_isr_sem_give_n and nano_fiber_sem_give_n
+ * aliases are created to support any required implementation differences in
+ * the future without introducing a source code migration issue.
+ */
+void _sem_give_n_non_preemptible(struct nano_sem *sem, int count)
+{
+	unsigned int imask;
+
+	imask = irq_lock();
+	sem_give_n(sem, count);
+	irq_unlock(imask);
+}
+
+void nano_task_sem_give_n(struct nano_sem *sem, int count)
+{
+	unsigned int imask;
+
+	imask = irq_lock();
+
+	if (sem_give_n(sem, count)) {
+		_Swap(imask);
+		return;
+	}
+
+	irq_unlock(imask);
+}
+
+void nano_sem_give_n(struct nano_sem *sem, int count)
+{
+	static void (*func[3])(struct nano_sem *sem, int count) = {
+		nano_isr_sem_give_n,
+		nano_fiber_sem_give_n,
+		nano_task_sem_give_n
+	};
+
+	func[sys_execution_context_type_get()](sem, count);
+}
+
 FUNC_ALIAS(_sem_take, nano_isr_sem_take, int);
 FUNC_ALIAS(_sem_take, nano_fiber_sem_take, int);
 
@@ -175,7 +243,9 @@ int nano_task_sem_take(struct nano_sem *sem, int32_t timeout_in_ticks)
 
 		if (timeout_in_ticks != TICKS_NONE) {
 
-			_NANO_TIMEOUT_SET_TASK_TIMEOUT(timeout_in_ticks);
+			_NANO_TIMEOUT_SET_TASK_TIMEOUT(
+				_NANO_TIMEOUT_TICKS_LEFT(timeout_in_ticks,
+							 limit, cur_ticks));
 
 			/* see explanation in nano_stack.c:nano_task_stack_pop() */
 			nano_cpu_atomic_idle(key);
@@ -52,7 +52,7 @@ void task_sleep(int32_t timeout_in_ticks)
 	limit = cur_ticks + timeout_in_ticks;
 
 	while (cur_ticks < limit) {
-		_NANO_TIMEOUT_SET_TASK_TIMEOUT(timeout_in_ticks);
+		_NANO_TIMEOUT_SET_TASK_TIMEOUT((int32_t)(limit - cur_ticks));
 		nano_cpu_atomic_idle(key);
 
 		key = irq_lock();
@@ -47,6 +47,46 @@ int32_t _sys_idle_elapsed_ticks = 1;
 
 int64_t _sys_clock_tick_count;
 
+#ifndef CONFIG_CMPXCHG8B
+/*
+ * Generation of _sys_clock_tick_count, incremented each time the tick count
+ * is updated. The update is done with interrupts locked: on a uniprocessor
+ * system it cannot be interrupted by a reader, so a reader that sees the
+ * same generation before and after reading the tick count got a consistent
+ * value.
+ */
+static volatile uint32_t _sys_clock_tick_gen;
+#endif
+
+/**
+ *
+ * @brief Read the 64-bit system tick count without locking interrupts
+ *
+ * Some architectures (x86) do not read 64-bit variables atomically, and
+ * the tick count can be updated by the timer interrupt half-way through the
+ * read. Rather than locking interrupts around the read, which adds to the
+ * worst-case interrupt latency, this either reads it with a single atomic
+ * instruction, or retries the read until no update happened during it.
+ *
+ * @return the current system tick count
+ */
+static ALWAYS_INLINE int64_t _sys_clock_tick_count_read(void)
+{
+#ifdef CONFIG_CMPXCHG8B
+	return _do_read_atomic_64(&_sys_clock_tick_count);
+#else
+	uint32_t gen;
+	int64_t count;
+
+	do {
+		gen = _sys_clock_tick_gen;
+		count = *(volatile int64_t *)&_sys_clock_tick_count;
+	} while (gen != _sys_clock_tick_gen);
+
+	return count;
+#endif
+}
+
 /**
  *
  * @brief Return the lower part of the current system tick count
@@ -68,18 +108,7 @@ uint32_t sys_tick_get_32(void)
  */
 int64_t sys_tick_get(void)
 {
-	int64_t tmp_sys_clock_tick_count;
-	/*
-	 * Lock the interrupts when reading _sys_clock_tick_count 64-bit variable.
-	 * Some architectures (x86) do not handle 64-bit atomically, so
-	 * we have to lock the timer interrupt that causes change of
-	 * _sys_clock_tick_count
-	 */
-	unsigned int imask = irq_lock();
-
-	tmp_sys_clock_tick_count = _sys_clock_tick_count;
-	irq_unlock(imask);
-	return tmp_sys_clock_tick_count;
+	return _sys_clock_tick_count_read();
 }
 
 /**
@@ -113,18 +142,8 @@ int64_t sys_tick_get(void)
 static ALWAYS_INLINE int64_t _nano_tick_delta(int64_t *reftime)
 {
 	int64_t  delta;
-	int64_t  saved;
-
-	/*
-	 * Lock the interrupts when reading _sys_clock_tick_count 64-bit variable.
-	 * Some architectures (x86) do not handle 64-bit atomically, so
-	 * we have to lock the timer interrupt that causes change of
-	 * _sys_clock_tick_count
-	 */
-	unsigned int imask = irq_lock();
-
-	saved = _sys_clock_tick_count;
-	irq_unlock(imask);
+	int64_t  saved = _sys_clock_tick_count_read();
+
 	delta = saved - (*reftime);
 	*reftime = saved;
 
@@ -150,45 +169,16 @@ uint32_t sys_tick_delta_32(int64_t *reftime)
 
 /* handle the expired timeouts in the nano timeout queue */
 
-#ifdef CONFIG_NANO_TIMEOUTS
-#include <wait_q.h>
-
+#if defined(CONFIG_NANO_TIMEOUTS) || defined(CONFIG_NANO_TIMERS)
 static inline void handle_expired_nano_timeouts(int32_t ticks)
 {
-	struct _nano_timeout *head =
-		(struct _nano_timeout *)sys_dlist_peek_head(&_nanokernel.timeout_q);
-
-	_nanokernel.task_timeout = TICKS_UNLIMITED;
-	if (head) {
-		head->delta_ticks_from_prev -= ticks;
-		_nano_timeout_handle_timeouts();
-	}
+	_NANO_TIMEOUT_SET_TASK_TIMEOUT(TICKS_UNLIMITED);
+	_nano_timeout_handle_timeouts(ticks);
 }
 #else
 	#define handle_expired_nano_timeouts(ticks) do { } while ((0))
 #endif
 
-/* handle the expired nano timers in the nano timers queue */
-#ifdef CONFIG_NANO_TIMERS
-#include <sys_clock.h>
-static inline void handle_expired_nano_timers(int ticks)
-{
-	if (_nano_timer_list) {
-		_nano_timer_list->ticks -= ticks;
-
-		while (_nano_timer_list && (!_nano_timer_list->ticks)) {
-			struct nano_timer *expired = _nano_timer_list;
-			struct nano_lifo *lifo = &expired->lifo;
-
-			_nano_timer_list = expired->link;
-			nano_isr_lifo_put(lifo, expired->userData);
-		}
-	}
-}
-#else
-	#define handle_expired_nano_timers(ticks) do { } while ((0))
-#endif
-
 /**
  *
  * @brief Announce a tick to the nanokernel
@@ -205,30 +195,18 @@ void _nano_sys_clock_tick_announce(int32_t ticks)
 
 	key = irq_lock();
 	_sys_clock_tick_count += ticks;
+#ifndef CONFIG_CMPXCHG8B
+	_sys_clock_tick_gen++;
+#endif
 	handle_expired_nano_timeouts(ticks);
-	handle_expired_nano_timers(ticks);
 	irq_unlock(key);
 }
 
-/* get closest nano timers deadline expiry, (uint32_t)TICKS_UNLIMITED if none */
-#ifdef CONFIG_NANO_TIMERS
-static inline uint32_t _nano_get_earliest_timers_deadline(void)
-{
-	return _nano_timer_list ? _nano_timer_list->ticks : TICKS_UNLIMITED;
-}
-#else
-static inline uint32_t _nano_get_earliest_timers_deadline(void)
-{
-	return TICKS_UNLIMITED;
-}
-#endif
-
 /*
  * Get closest nano timeouts/timers deadline expiry, (uint32_t)TICKS_UNLIMITED
  * if none.
  */
 uint32_t _nano_get_earliest_deadline(void)
 {
-	return min(_nano_get_earliest_timeouts_deadline(),
-				_nano_get_earliest_timers_deadline());
+	return _nano_get_earliest_timeouts_deadline();
 }
@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2016 Wind River Systems, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file
+ * @brief Hashed timing wheel
+ *
+ * This module implements the timing wheel used as the nanokernel timeout
+ * queue when CONFIG_NANO_TIMEOUT_WHEEL is enabled, and as the microkernel
+ * timer queue when CONFIG_MICROKERNEL_TIMER_WHEEL is enabled.
+ *
+ * Each armed timeout records its absolute expiry tick and is inserted in the
+ * slot of that tick, modulo the number of slots. Each slot is kept sorted by
+ * expiry, so that timeouts that expire more than one revolution of the wheel
+ * away follow the nearer ones, and only the head of a slot can be due. The
+ * wheel also tracks its closest expiry, which is only searched for again when
+ * the timeout holding it expires or is disarmed.
+ *
+ * The timeouts moved off the slots by an announcement, while they wait to be
+ * handled, expire no later than the tick up to which the wheel has been
+ * advanced; those still on the slots expire after it. All routines must be
+ * called with interrupts locked.
+ */
+
+#include <nano_private.h>
+#include <misc/util.h>
+#include <timeout_wheel.h>
+
+#define SLOT_MASK (CONFIG_NANO_TIMEOUT_WHEEL_SLOTS - 1)
+
+/* timing wheel holding the fiber timeouts and the nanokernel timers */
+struct _nano_timeout_wheel _nano_timeouts_wheel;
+
+/**
+ *
+ * @brief Initialize a timing wheel
+ *
+ * @param wheel timing wheel
+ *
+ * @return N/A
+ */
+void _nano_timeout_wheel_init(struct _nano_timeout_wheel *wheel)
+{
+	int i;
+
+	wheel->now = 0;
+	wheel->earliest = 0;
+	wheel->num_armed = 0;
+
+	for (i = 0; i < CONFIG_NANO_TIMEOUT_WHEEL_SLOTS; i++) {
+		sys_dlist_init(&wheel->slots[i]);
+	}
+}
+
+/*
+ * callback for sys_dlist_insert_at():
+ *
+ * Returns 1 if the timeout in the slot expires after the one to insert,
+ * signifying that it should be inserted before it, so that the timeouts
+ * expiring on the same tick stay in the order they were armed.
+ */
+static int _nano_timeout_wheel_insert_point_test(sys_dnode_t *test,
+						 void *expiry)
+{
+	struct _nano_timeout *t = (struct _nano_timeout *)test;
+
+	return (int32_t)(t->expiry - *(uint32_t *)expiry) > 0;
+}
+
+/**
+ *
+ * @brief Search a timing wheel for its closest expiry
+ *
+ * The slots are visited in expiry order starting with the tick following
+ * @a base, and only their heads are considered, so that the search stops as
+ * soon as a timeout expiring within one revolution is found.
+ *
+ * @param wheel timing wheel, with at least one timeout on its slots
+ * @param base tick before which no timeout on the slots expires
+ *
+ * @return N/A
+ */
+static void _nano_timeout_wheel_earliest_update(
+	struct _nano_timeout_wheel *wheel, uint32_t base)
+{
+	uint32_t earliest = (uint32_t)TICKS_UNLIMITED;
+	uint32_t distance;
+
+	for (distance = 1;
+	     (distance <= CONFIG_NANO_TIMEOUT_WHEEL_SLOTS) &&
+	     (distance < earliest);
+	     distance++) {
+		sys_dlist_t *list = &wheel->slots[(base + distance) & SLOT_MASK];
+		struct _nano_timeout *t =
+			(struct _nano_timeout *)sys_dlist_peek_head(list);
+
+		if (t) {
+			earliest = min(earliest, t->expiry - base);
+		}
+	}
+
+	wheel->earliest = base + earliest;
+}
+
+/**
+ *
+ * @brief Arm a timeout on a timing wheel
+ *
+ * The timeout must not already be armed. A timeout of less than one tick
+ * expires on the next tick. The timeout is inserted after those of its slot
+ * that expire no later than it.
+ *
+ * @param wheel timing wheel
+ * @param t timeout to arm
+ * @param ticks number of ticks before expiry
+ *
+ * @return N/A
+ */
+void _nano_timeout_wheel_add(struct _nano_timeout_wheel *wheel,
+			     struct _nano_timeout *t, int32_t ticks)
+{
+	t->expiry = wheel->now + max(ticks, 1);
+	sys_dlist_insert_at(&wheel->slots[t->expiry & SLOT_MASK], &t->node,
+			    _nano_timeout_wheel_insert_point_test, &t->expiry);
+
+	if ((wheel->num_armed++ == 0) ||
+	    ((int32_t)(t->expiry - wheel->earliest) < 0)) {
+		wheel->earliest = t->expiry;
+	}
+}
+
+/**
+ *
+ * @brief Disarm a timeout, if armed
+ *
+ * @param wheel timing wheel
+ * @param t timeout to disarm
+ *
+ * @return N/A
+ */
+void _nano_timeout_wheel_remove(struct _nano_timeout_wheel *wheel,
+				struct _nano_timeout *t)
+{
+	if (!_nano_timeout_wheel_is_armed(t)) {
+		return;
+	}
+
+	sys_dlist_remove(&t->node);
+	_nano_timeout_wheel_entry_init(t);
+
+	/* a due timeout waiting to be handled is no longer counted */
+	if ((int32_t)(t->expiry - wheel->now) <= 0) {
+		return;
+	}
+
+	if ((--wheel->num_armed > 0) && (t->expiry == wheel->earliest)) {
+		_nano_timeout_wheel_earliest_update(wheel, t->expiry - 1);
+	}
+}
+
+/**
+ *
+ * @brief Advance a timing wheel
+ *
+ * The timeouts that are due are disarmed and handed to @a expired, in expiry
+ * order; those expiring on the same tick are handed in the order they were
+ * armed. Only the slots holding the closest expiry are visited. A timeout
+ * that is aborted by the handling of another one that expires on the same
+ * announcement is not handed to @a expired.
+ *
+ * @param wheel timing wheel
+ * @param ticks number of elapsed ticks
+ * @param expired routine handling an expired timeout
+ *
+ * @return N/A
+ */
+void _nano_timeout_wheel_announce(struct _nano_timeout_wheel *wheel,
+				  int32_t ticks, _nano_timeout_func_t expired)
+{
+	sys_dlist_t due;
+	sys_dnode_t *node;
+
+	wheel->now += ticks;
+
+	if ((wheel->num_armed == 0) ||
+	    ((int32_t)(wheel->earliest - wheel->now) > 0)) {
+		return;
+	}
+
+	sys_dlist_init(&due);
+
+	do {
+		uint32_t tick = wheel->earliest;
+		sys_dlist_t *list = &wheel->slots[tick & SLOT_MASK];
+		struct _nano_timeout *t;
+
+		while (((t = (struct _nano_timeout *)sys_dlist_peek_head(list))
+			!= NULL) && (t->expiry == tick)) {
+			sys_dlist_remove(&t->node);
+			sys_dlist_append(&due, &t->node);
+			wheel->num_armed--;
+		}
+
+		if (wheel->num_armed > 0) {
+			_nano_timeout_wheel_earliest_update(wheel, tick);
+		}
+	} while ((wheel->num_armed > 0) &&
+		 ((int32_t)(wheel->earliest - wheel->now) <= 0));
+
+	/*
+	 * Due timeouts remain armed until handled, so that they can still be
+	 * aborted from the handling of the ones preceding them.
+	 */
+
+	while ((node = sys_dlist_get(&due)) != NULL) {
+		struct _nano_timeout *t = (struct _nano_timeout *)node;
+
+		_nano_timeout_wheel_entry_init(t);
+		expired(t);
+	}
+}
+
+/**
+ *
+ * @brief Find the closest expiry on a timing wheel
+ *
+ * @param wheel timing wheel
+ *
+ * @return number of ticks before the closest expiry, or
+ * (uint32_t)TICKS_UNLIMITED if no timeout is armed
+ */
+uint32_t _nano_timeout_wheel_earliest(struct _nano_timeout_wheel *wheel)
+{
+	if (wheel->num_armed == 0) {
+		return (uint32_t)TICKS_UNLIMITED;
+	}
+
+	return wheel->earliest - wheel->now;
+}
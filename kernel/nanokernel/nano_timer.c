@@ -17,12 +17,22 @@
  */
 
 #include <nano_private.h>
+#include <wait_q.h>
 
-struct nano_timer *_nano_timer_list;
+/*
+ * Expiry function of the nanokernel timers, invoked from the tick
+ * announcement with interrupts locked.
+ */
+static void _timer_expire(struct _nano_timeout *t)
+{
+	struct nano_timer *timer = CONTAINER_OF(t, struct nano_timer, timeout);
 
+	nano_isr_lifo_put(&timer->lifo, timer->userData);
+}
 
 void nano_timer_init(struct nano_timer *timer, void *data)
 {
+	_nano_timeout_init(&timer->timeout, _timer_expire);
 	nano_lifo_init(&timer->lifo);
 	timer->userData = data;
 	DEBUG_TRACING_OBJ_INIT(struct nano_timer *, timer, _track_list_nano_timer);
@@ -50,29 +60,11 @@ void _timer_start(struct nano_timer *timer, /* timer to start */
 				       )
 {
 	unsigned int imask;
-	struct nano_timer *cur;
-	struct nano_timer *prev = NULL;
-
-	timer->ticks = ticks;
 
 	imask = irq_lock();
 
-	cur = _nano_timer_list;
-
-	while (cur && (timer->ticks > cur->ticks)) {
-		timer->ticks -= cur->ticks;
-		prev = cur;
-		cur = cur->link;
-	}
-
-	timer->link = cur;
-	if (cur != NULL)
-		cur->ticks -= timer->ticks;
-
-	if (prev != NULL)
-		prev->link = timer;
-	else
-		_nano_timer_list = timer;
+	_nano_timeout_dequeue(&timer->timeout);
+	_nano_timeout_enqueue(&timer->timeout, ticks);
 
 	irq_unlock(imask);
 }
@@ -87,40 +79,34 @@ void _timer_start(struct nano_timer *timer, /* timer to start */
 static void _timer_stop(struct nano_timer *timer)
 {
 	unsigned int imask;
-	struct nano_timer *cur;
-	struct nano_timer *prev = NULL;
 
 	imask = irq_lock();
 
-	cur = _nano_timer_list;
+	/* the timer can't expire once it is removed from the timeout queue */
+	_nano_timeout_dequeue(&timer->timeout);
 
-	/* find prev */
-	while (cur && cur != timer) {
-		prev = cur;
-		cur = cur->link;
-	}
+	irq_unlock(imask);
+}
 
-	/* if found it, remove it */
-	if (cur) {
-		/* if it was first */
-		if (prev == NULL) {
-			_nano_timer_list = timer->link;
-			/* if not last */
-			if (_nano_timer_list)
-				_nano_timer_list->ticks += timer->ticks;
-		} else {
-			prev->link = timer->link;
-			/* if not last */
-			if (prev->link)
-				prev->link->ticks += timer->ticks;
-		}
-	}
+/**
+ * @brief Get the ticks remaining before a nanokernel timer expires
+ *
+ * @param timer Timer to query
+ * @return remaining ticks, or 0 if the timer is not running
+ */
+int32_t nano_timer_ticks_remain(struct nano_timer *timer)
+{
+	unsigned int imask;
+	int32_t remaining;
+
+	imask = irq_lock();
 
-	/* now the timer can't expire since it is removed from the list */
+	remaining = _nano_timeout_remaining(&timer->timeout);
 
 	irq_unlock(imask);
-}
 
+	return remaining;
+}
 
 FUNC_ALIAS(_timer_stop_non_preemptible, nano_isr_timer_stop, void);
 FUNC_ALIAS(_timer_stop_non_preemptible, nano_fiber_timer_stop, void);
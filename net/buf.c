@@ -60,9 +60,10 @@ struct net_buf *net_buf_get(struct nano_fifo *fifo, size_t reserve_head)
 		buf = nano_fifo_get(fifo, TICKS_UNLIMITED);
 	}
 
-	buf->ref  = 1;
-	buf->data = buf->__buf + reserve_head;
-	buf->len  = 0;
+	buf->ref   = 1;
+	buf->data  = buf->__buf + reserve_head;
+	buf->len   = 0;
+	buf->frags = NULL;
 
 	NET_BUF_DBG("buf %p fifo %p reserve %u\n", buf, fifo, reserve_head);
 
@@ -71,17 +72,26 @@ struct net_buf *net_buf_get(struct nano_fifo *fifo, size_t reserve_head)
 
 void net_buf_unref(struct net_buf *buf)
 {
-	NET_BUF_DBG("buf %p ref %u fifo %p\n", buf, buf->ref, buf->free);
-	NET_BUF_ASSERT(buf->ref > 0);
+	while (buf) {
+		struct net_buf *frags = buf->frags;
 
-	if (--buf->ref) {
-		return;
-	}
+		NET_BUF_DBG("buf %p ref %u fifo %p frags %p\n", buf, buf->ref,
+			    buf->free, buf->frags);
+		NET_BUF_ASSERT(buf->ref > 0);
+
+		if (--buf->ref) {
+			return;
+		}
+
+		buf->frags = NULL;
+
+		if (buf->destroy) {
+			buf->destroy(buf);
+		} else {
+			nano_fifo_put(buf->free, buf);
+		}
 
-	if (buf->destroy) {
-		buf->destroy(buf);
-	} else {
-		nano_fifo_put(buf->free, buf);
+		buf = frags;
 	}
 }
 
@@ -104,9 +114,178 @@ struct net_buf *net_buf_clone(struct net_buf *buf)
 	/* TODO: Add reference to the original buffer instead of copying it. */
 	memcpy(net_buf_add(clone, buf->len), buf->data, buf->len);
 
+	if (buf->frags) {
+		clone->frags = net_buf_ref(buf->frags);
+	}
+
 	return clone;
 }
 
+struct net_buf *net_buf_frag_last(struct net_buf *frags)
+{
+	while (frags->frags) {
+		frags = frags->frags;
+	}
+
+	return frags;
+}
+
+void net_buf_frag_insert(struct net_buf *parent, struct net_buf *frag)
+{
+	NET_BUF_DBG("parent %p frag %p\n", parent, frag);
+
+	net_buf_frag_last(frag)->frags = parent->frags;
+	parent->frags = frag;
+}
+
+struct net_buf *net_buf_frag_add(struct net_buf *head, struct net_buf *frag)
+{
+	if (!head) {
+		return frag;
+	}
+
+	net_buf_frag_insert(net_buf_frag_last(head), frag);
+
+	return head;
+}
+
+struct net_buf *net_buf_frag_del(struct net_buf *parent, struct net_buf *frag)
+{
+	struct net_buf *next = frag->frags;
+
+	NET_BUF_DBG("parent %p frag %p\n", parent, frag);
+
+	NET_BUF_ASSERT(!parent || parent->frags == frag);
+
+	if (parent) {
+		parent->frags = next;
+	}
+
+	frag->frags = NULL;
+	net_buf_unref(frag);
+
+	return next;
+}
+
+size_t net_buf_frags_len(struct net_buf *buf)
+{
+	size_t len = 0;
+
+	for (; buf; buf = buf->frags) {
+		len += buf->len;
+	}
+
+	return len;
+}
+
+size_t net_buf_frags_add_mem(struct net_buf *buf, struct nano_fifo *fifo,
+			     const void *mem, size_t len)
+{
+	struct net_buf *last = net_buf_frag_last(buf);
+	size_t added = 0;
+
+	NET_BUF_DBG("buf %p fifo %p len %u\n", buf, fifo, len);
+
+	while (added < len) {
+		size_t count = min(len - added, net_buf_tailroom(last));
+
+		if (!count) {
+			struct net_buf *frag = net_buf_get(fifo, 0);
+
+			if (!frag) {
+				break;
+			}
+
+			NET_BUF_ASSERT(frag->size > 0);
+
+			net_buf_frag_insert(last, frag);
+			last = frag;
+			continue;
+		}
+
+		memcpy(net_buf_add(last, count), (const uint8_t *)mem + added,
+		       count);
+		added += count;
+	}
+
+	return added;
+}
+
+struct net_buf *net_buf_frags_push(struct net_buf *buf,
+				   struct nano_fifo *fifo, size_t len)
+{
+	struct net_buf *frag;
+
+	NET_BUF_DBG("buf %p fifo %p len %u\n", buf, fifo, len);
+
+	if (net_buf_headroom(buf) >= len) {
+		net_buf_push(buf, len);
+		return buf;
+	}
+
+	frag = net_buf_get(fifo, 0);
+	if (!frag) {
+		return NULL;
+	}
+
+	NET_BUF_ASSERT(frag->size >= len);
+
+	/* leave all of the new fragment as headroom, then push into it */
+	frag->data = frag->__buf + frag->size;
+	net_buf_push(frag, len);
+	frag->frags = buf;
+
+	return frag;
+}
+
+void net_buf_frags_pull(struct net_buf *buf, size_t len)
+{
+	struct net_buf *parent = NULL;
+
+	NET_BUF_DBG("buf %p len %u\n", buf, len);
+
+	while (buf && len) {
+		size_t count = min(len, buf->len);
+
+		net_buf_pull(buf, count);
+		len -= count;
+
+		if (!buf->len && parent) {
+			buf = net_buf_frag_del(parent, buf);
+		} else {
+			parent = buf;
+			buf = buf->frags;
+		}
+	}
+
+	NET_BUF_ASSERT(!len);
+}
+
+size_t net_buf_linearize(void *dst, size_t dst_len, struct net_buf *src,
+			 size_t offset, size_t len)
+{
+	size_t copied = 0;
+
+	len = min(len, dst_len);
+
+	/* find the fragment holding the first byte to copy */
+	while (src && offset >= src->len) {
+		offset -= src->len;
+		src = src->frags;
+	}
+
+	while (src && copied < len) {
+		size_t count = min(len - copied, src->len - offset);
+
+		memcpy((uint8_t *)dst + copied, src->data + offset, count);
+		copied += count;
+		offset = 0;
+		src = src->frags;
+	}
+
+	return copied;
+}
+
 void *net_buf_add(struct net_buf *buf, size_t len)
 {
 	uint8_t *tail = net_buf_tail(buf);
@@ -194,4 +194,18 @@ typedef unsigned int uip_stats_t;
 #define UIP_CONF_LLH_LEN 14
 #endif
 
+#define UIP_CONF_UDP_CONNS CONFIG_NET_UDP_CONNS
+
+#ifdef CONFIG_NET_UDP_CONN_HASH
+#define UIP_CONF_UDP_CONN_HASH_SIZE CONFIG_NET_UDP_CONN_HASH_SIZE
+#endif
+
+#ifdef CONFIG_NET_MAX_ROUTES
+#define UIP_CONF_MAX_ROUTES CONFIG_NET_MAX_ROUTES
+#endif
+
+#ifdef CONFIG_NET_ROUTE_TRIE
+#define UIP_CONF_DS6_ROUTE_TRIE 1
+#endif
+
 #endif /* __CONTIKI_CONF_H__ */
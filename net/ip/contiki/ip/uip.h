@@ -821,7 +821,11 @@ struct uip_udp_conn *uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport);
  *
  * \hideinitializer
  */
+#if UIP_UDP_CONN_HASH_SIZE
+#define uip_udp_remove(conn) uip_udp_bind(conn, 0)
+#else /* UIP_UDP_CONN_HASH_SIZE */
 #define uip_udp_remove(conn) (conn)->lport = 0
+#endif /* UIP_UDP_CONN_HASH_SIZE */
 
 /**
  * Bind a UDP connection to a local port.
@@ -833,7 +837,11 @@ struct uip_udp_conn *uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport);
  *
  * \hideinitializer
  */
+#if UIP_UDP_CONN_HASH_SIZE
+void uip_udp_bind(struct uip_udp_conn *conn, uint16_t port);
+#else /* UIP_UDP_CONN_HASH_SIZE */
 #define uip_udp_bind(conn, port) (conn)->lport = port
+#endif /* UIP_UDP_CONN_HASH_SIZE */
 
 /**
  * Send a UDP datagram of length len on the current connection.
@@ -1364,6 +1372,11 @@ struct uip_udp_conn {
 
   /* buffer holding the data to this connection */
   struct net_buf *buf;
+
+#if UIP_UDP_CONN_HASH_SIZE
+  /* next connection of the same local port hash bucket */
+  struct uip_udp_conn *hash_next;
+#endif /* UIP_UDP_CONN_HASH_SIZE */
 };
 
 /**
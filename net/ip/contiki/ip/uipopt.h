@@ -365,6 +365,19 @@ void uip_log(char *msg);
 #define UIP_UDP_CONNS    10
 #endif /* UIP_CONF_UDP_CONNS */
 
+/**
+ * The number of buckets of the hash table the UDP connections are
+ * looked up in by local port, or 0 to look them up in a linear scan
+ * of all the UDP connections.
+ *
+ * \hideinitializer
+ */
+#ifdef UIP_CONF_UDP_CONN_HASH_SIZE
+#define UIP_UDP_CONN_HASH_SIZE (UIP_CONF_UDP_CONN_HASH_SIZE)
+#else /* UIP_CONF_UDP_CONN_HASH_SIZE */
+#define UIP_UDP_CONN_HASH_SIZE 0
+#endif /* UIP_CONF_UDP_CONN_HASH_SIZE */
+
 /**
  * The name of the function that should be called when UDP datagrams arrive.
  *
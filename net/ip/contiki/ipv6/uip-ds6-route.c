@@ -61,6 +61,30 @@ MEMB(neighborroutememb, struct uip_ds6_route_neighbor_route, UIP_DS6_ROUTE_NB);
 LIST(routelist);
 MEMB(routememb, uip_ds6_route_t, UIP_DS6_ROUTE_NB);
 
+#if UIP_DS6_ROUTE_TRIE
+/* The routes are also indexed by a binary trie of their prefixes with
+   path compression (a Patricia trie), so that a lookup takes a number
+   of steps bounded by the prefix length rather than by the number of
+   routes. A node holds either the prefix of a route, or the prefix at
+   which two branches diverge, so there are fewer than two nodes per
+   route. The children of a node are ordered by the bit that follows
+   its prefix. */
+struct route_trie_node {
+  struct route_trie_node *parent;
+  struct route_trie_node *child[2];
+  uip_ds6_route_t *route;
+  uip_ipaddr_t prefix;
+  uint8_t length;
+};
+MEMB(routetriememb, struct route_trie_node, 2 * UIP_DS6_ROUTE_NB);
+static struct route_trie_node *route_trie;
+
+/* The routelist is no longer reordered on each lookup: instead the
+   route found is stamped with this counter, and the least recently
+   used route is the one with the oldest stamp. */
+static uint32_t route_clock;
+#endif /* UIP_DS6_ROUTE_TRIE */
+
 /* Default routes are held on the defaultrouterlist and their
    structures are allocated from the defaultroutermemb memory block.*/
 LIST(defaultrouterlist);
@@ -78,6 +102,192 @@ static int num_routes = 0;
 
 static void rm_routelist_callback(nbr_table_item_t *ptr);
 /*---------------------------------------------------------------------------*/
+#if UIP_DS6_ROUTE_TRIE
+static uint8_t
+route_trie_bit(const uip_ipaddr_t *addr, uint8_t pos)
+{
+  return (addr->u8[pos >> 3] >> (7 - (pos & 7))) & 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Returns the number of leading bits, up to length, that a and b have
+   in common. */
+static uint8_t
+route_trie_common(const uip_ipaddr_t *a, const uip_ipaddr_t *b,
+                  uint8_t length)
+{
+  uint8_t i;
+  uint8_t n;
+  uint8_t diff;
+
+  for(i = 0; i < (length >> 3) && a->u8[i] == b->u8[i]; i++);
+
+  n = i << 3;
+  if(n >= length) {
+    return length;
+  }
+
+  for(diff = a->u8[i] ^ b->u8[i]; n < length && !(diff & 0x80); n++) {
+    diff <<= 1;
+  }
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+static struct route_trie_node *
+route_trie_node_new(const uip_ipaddr_t *prefix, uint8_t length,
+                    uip_ds6_route_t *route, struct route_trie_node *parent)
+{
+  struct route_trie_node *n;
+
+  n = memb_alloc(&routetriememb);
+  if(n != NULL) {
+    uip_ipaddr_copy(&n->prefix, prefix);
+    n->length = length;
+    n->route = route;
+    n->parent = parent;
+    n->child[0] = NULL;
+    n->child[1] = NULL;
+  }
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+static int
+route_trie_insert(uip_ds6_route_t *r)
+{
+  struct route_trie_node **link = &route_trie;
+  struct route_trie_node *parent = NULL;
+  struct route_trie_node *n;
+  struct route_trie_node *leaf;
+  struct route_trie_node *branch;
+  uint8_t common = 0;
+
+  /* Walk down while the prefix of the node is a prefix of the route */
+  while((n = *link) != NULL) {
+    common = route_trie_common(&n->prefix, &r->ipaddr,
+                               n->length < r->length ? n->length : r->length);
+    if(common < n->length) {
+      break;
+    }
+    if(n->length == r->length) {
+      /* The routes diverge right after the route prefix: the branch
+         node there takes the route. It cannot hold another route for
+         the same prefix, as uip_ds6_route_add() drops or keeps any
+         route matching the prefix before adding one. */
+      n->route = r;
+      return 1;
+    }
+    parent = n;
+    link = &n->child[route_trie_bit(&r->ipaddr, n->length)];
+  }
+
+  leaf = route_trie_node_new(&r->ipaddr, r->length, r, parent);
+  if(leaf == NULL) {
+    return 0;
+  }
+
+  if(n == NULL) {
+    *link = leaf;
+    return 1;
+  }
+
+  if(common == r->length) {
+    /* The route prefix is a prefix of that of n: insert it above n */
+    leaf->child[route_trie_bit(&n->prefix, common)] = n;
+    n->parent = leaf;
+    *link = leaf;
+    return 1;
+  }
+
+  /* The route and n diverge after common bits: branch there */
+  branch = route_trie_node_new(&r->ipaddr, common, NULL, parent);
+  if(branch == NULL) {
+    memb_free(&routetriememb, leaf);
+    return 0;
+  }
+  branch->child[route_trie_bit(&r->ipaddr, common)] = leaf;
+  branch->child[route_trie_bit(&n->prefix, common)] = n;
+  leaf->parent = branch;
+  n->parent = branch;
+  *link = branch;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+route_trie_remove(uip_ds6_route_t *r)
+{
+  struct route_trie_node *n = route_trie;
+  struct route_trie_node *parent;
+  struct route_trie_node *child;
+
+  while(n != NULL && n->length < r->length) {
+    n = n->child[route_trie_bit(&r->ipaddr, n->length)];
+  }
+
+  if(n == NULL || n->route != r) {
+    /* The route could not be inserted */
+    return;
+  }
+
+  /* Remove the node, and the branch above it if that is left with a
+     single child, so that every node without a route keeps two
+     children. */
+  n->route = NULL;
+  while(n != NULL && n->route == NULL &&
+        (n->child[0] == NULL || n->child[1] == NULL)) {
+    parent = n->parent;
+    child = n->child[0] != NULL ? n->child[0] : n->child[1];
+
+    if(child != NULL) {
+      child->parent = parent;
+    }
+    if(parent == NULL) {
+      route_trie = child;
+    } else {
+      parent->child[parent->child[1] == n] = child;
+    }
+    memb_free(&routetriememb, n);
+
+    if(child != NULL) {
+      break;
+    }
+    n = parent;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static uip_ds6_route_t *
+route_trie_lookup(const uip_ipaddr_t *addr)
+{
+  struct route_trie_node *n;
+  uip_ds6_route_t *found_route = NULL;
+
+  for(n = route_trie;
+      n != NULL &&
+        route_trie_common(&n->prefix, addr, n->length) == n->length;
+      n = n->child[route_trie_bit(addr, n->length)]) {
+    if(n->route != NULL) {
+      found_route = n->route;
+    }
+    if(n->length == 128) {
+      break;
+    }
+  }
+  return found_route;
+}
+/*---------------------------------------------------------------------------*/
+static uip_ds6_route_t *
+route_least_recently_used(void)
+{
+  uip_ds6_route_t *r;
+  uip_ds6_route_t *oldest = list_head(routelist);
+
+  for(r = oldest; r != NULL; r = list_item_next(r)) {
+    if((int32_t)(r->last_used - oldest->last_used) < 0) {
+      oldest = r;
+    }
+  }
+  return oldest;
+}
+#endif /* UIP_DS6_ROUTE_TRIE */
+/*---------------------------------------------------------------------------*/
 #if DEBUG != DEBUG_NONE
 static void
 assert_nbr_routes_list_sane(void)
@@ -148,6 +358,10 @@ uip_ds6_route_init(void)
 {
   memb_init(&routememb);
   list_init(routelist);
+#if UIP_DS6_ROUTE_TRIE
+  memb_init(&routetriememb);
+  route_trie = NULL;
+#endif /* UIP_DS6_ROUTE_TRIE */
   nbr_table_register(nbr_routes,
                      (nbr_table_callback *)rm_routelist_callback);
 
@@ -205,15 +419,20 @@ uip_ds6_route_num_routes(void)
 uip_ds6_route_t *
 uip_ds6_route_lookup(uip_ipaddr_t *addr)
 {
-  uip_ds6_route_t *r;
   uip_ds6_route_t *found_route;
+#if !UIP_DS6_ROUTE_TRIE
+  uip_ds6_route_t *r;
   uint8_t longestmatch;
+#endif /* !UIP_DS6_ROUTE_TRIE */
 
   PRINTF("uip-ds6-route: Looking up route for ");
   PRINT6ADDR(addr);
   PRINTF("\n");
 
 
+#if UIP_DS6_ROUTE_TRIE
+  found_route = route_trie_lookup(addr);
+#else /* UIP_DS6_ROUTE_TRIE */
   found_route = NULL;
   longestmatch = 0;
   for(r = uip_ds6_route_head();
@@ -229,6 +448,7 @@ uip_ds6_route_lookup(uip_ipaddr_t *addr)
       }
     }
   }
+#endif /* UIP_DS6_ROUTE_TRIE */
 
   if(found_route != NULL) {
     PRINTF("uip-ds6-route: Found route: ");
@@ -240,6 +460,11 @@ uip_ds6_route_lookup(uip_ipaddr_t *addr)
     PRINTF("uip-ds6-route: No route found\n");
   }
 
+#if UIP_DS6_ROUTE_TRIE
+  if(found_route != NULL) {
+    found_route->last_used = ++route_clock;
+  }
+#else /* UIP_DS6_ROUTE_TRIE */
   if(found_route != NULL && found_route != list_head(routelist)) {
     /* If we found a route, we put it at the start of the routeslist
        list. The list is ordered by how recently we looked them up:
@@ -249,6 +474,7 @@ uip_ds6_route_lookup(uip_ipaddr_t *addr)
     list_remove(routelist, found_route);
     list_push(routelist, found_route);
   }
+#endif /* UIP_DS6_ROUTE_TRIE */
 
   return found_route;
 }
@@ -301,7 +527,11 @@ uip_ds6_route_add(uip_ipaddr_t *ipaddr, uint8_t length,
          least recently used route is the first route on the list. */
       uip_ds6_route_t *oldest;
 
+#if UIP_DS6_ROUTE_TRIE
+      oldest = route_least_recently_used();
+#else /* UIP_DS6_ROUTE_TRIE */
       oldest = list_tail(routelist); /* uip_ds6_route_head(); */
+#endif /* UIP_DS6_ROUTE_TRIE */
       PRINTF("uip_ds6_route_add: dropping route to ");
       PRINT6ADDR(&oldest->ipaddr);
       PRINTF("\n");
@@ -372,6 +602,16 @@ uip_ds6_route_add(uip_ipaddr_t *ipaddr, uint8_t length,
   uip_ipaddr_copy(&(r->ipaddr), ipaddr);
   r->length = length;
 
+#if UIP_DS6_ROUTE_TRIE
+  r->last_used = ++route_clock;
+  if(!route_trie_insert(r)) {
+    /* This should not happen, as there are two trie nodes per route. */
+    PRINTF("uip_ds6_route_add: could not allocate route trie node\n");
+    uip_ds6_route_rm(r);
+    return NULL;
+  }
+#endif /* UIP_DS6_ROUTE_TRIE */
+
 #ifdef UIP_DS6_ROUTE_STATE_TYPE
   memset(&r->state, 0, sizeof(UIP_DS6_ROUTE_STATE_TYPE));
 #endif
@@ -409,6 +649,9 @@ uip_ds6_route_rm(uip_ds6_route_t *route)
 
     /* Remove the route from the route list */
     list_remove(routelist, route);
+#if UIP_DS6_ROUTE_TRIE
+    route_trie_remove(route);
+#endif /* UIP_DS6_ROUTE_TRIE */
 
     /* Find the corresponding neighbor_route and remove it. */
     for(neighbor_route = list_head(route->neighbor_routes->route_list);
@@ -279,6 +279,19 @@ static uint16_t tmp16;
 struct uip_udp_conn *uip_udp_conn;
 #endif
 struct uip_udp_conn uip_udp_conns[UIP_UDP_CONNS];
+
+#if UIP_UDP_CONN_HASH_SIZE
+#if UIP_UDP_CONN_HASH_SIZE & (UIP_UDP_CONN_HASH_SIZE - 1)
+#error "UIP_UDP_CONN_HASH_SIZE must be a power of two"
+#endif
+/* The UDP connections bound to a local port, hashed on that port. */
+static struct uip_udp_conn *udp_conn_hash[UIP_UDP_CONN_HASH_SIZE];
+
+/* Both bytes of the port are folded so that the bucket does not depend
+   on byte order. */
+#define UDP_CONN_BUCKET(port) \
+  (&udp_conn_hash[((port) ^ ((port) >> 8)) & (UIP_UDP_CONN_HASH_SIZE - 1)])
+#endif /* UIP_UDP_CONN_HASH_SIZE */
 #endif /* UIP_UDP */
 /** @} */
 
@@ -461,6 +474,9 @@ uip_init(void)
 
 #if UIP_UDP
   memset(&uip_udp_conns, 0, sizeof(uip_udp_conns));
+#if UIP_UDP_CONN_HASH_SIZE
+  memset(&udp_conn_hash, 0, sizeof(udp_conn_hash));
+#endif /* UIP_UDP_CONN_HASH_SIZE */
 #endif /* UIP_UDP */
 
 #if UIP_CONF_IPV6_MULTICAST
@@ -567,6 +583,91 @@ remove_ext_hdr(struct net_buf *buf)
 }
 /*---------------------------------------------------------------------------*/
 #if UIP_UDP
+#if UIP_UDP_CONN_HASH_SIZE
+void
+uip_udp_bind(struct uip_udp_conn *conn, uint16_t port)
+{
+  struct uip_udp_conn **p;
+
+  /* Unlink the connection from the bucket of its previous port. */
+  if(conn->lport != 0) {
+    for(p = UDP_CONN_BUCKET(conn->lport); *p != NULL; p = &(*p)->hash_next) {
+      if(*p == conn) {
+        *p = conn->hash_next;
+        break;
+      }
+    }
+  }
+
+  conn->lport = port;
+
+  if(port != 0) {
+    p = UDP_CONN_BUCKET(port);
+    conn->hash_next = *p;
+    *p = conn;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static struct uip_udp_conn *
+udp_conn_lookup(struct net_buf *buf)
+{
+  struct uip_udp_conn *conn;
+  struct uip_udp_conn *found = NULL;
+
+  /* Among the connections matching the datagram, one bound to the source
+     address of the datagram is preferred over one accepting any address,
+     and the first one in uip_udp_conns[] is chosen among equals. */
+  for(conn = *UDP_CONN_BUCKET(UIP_UDP_BUF(buf)->destport); conn != NULL;
+      conn = conn->hash_next) {
+    if(UIP_UDP_BUF(buf)->destport == conn->lport &&
+       (conn->rport == 0 ||
+        UIP_UDP_BUF(buf)->srcport == conn->rport)) {
+      if(uip_is_addr_unspecified(&conn->ripaddr)) {
+        if(found == NULL ||
+           (uip_is_addr_unspecified(&found->ripaddr) && conn < found)) {
+          found = conn;
+        }
+      } else if(uip_ipaddr_cmp(&UIP_IP_BUF(buf)->srcipaddr, &conn->ripaddr)) {
+        if(found == NULL || uip_is_addr_unspecified(&found->ripaddr) ||
+           conn < found) {
+          found = conn;
+        }
+      }
+    }
+  }
+
+  return found;
+}
+/*---------------------------------------------------------------------------*/
+static int
+udp_port_used(uint16_t port)
+{
+  struct uip_udp_conn *conn;
+
+  for(conn = *UDP_CONN_BUCKET(port); conn != NULL; conn = conn->hash_next) {
+    if(conn->lport == port) {
+      return 1;
+    }
+  }
+
+  return 0;
+}
+#else /* UIP_UDP_CONN_HASH_SIZE */
+static int
+udp_port_used(uint16_t port)
+{
+  uint8_t c;
+
+  for(c = 0; c < UIP_UDP_CONNS; ++c) {
+    if(uip_udp_conns[c].lport == port) {
+      return 1;
+    }
+  }
+
+  return 0;
+}
+#endif /* UIP_UDP_CONN_HASH_SIZE */
+/*---------------------------------------------------------------------------*/
 struct uip_udp_conn *
 uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport)
 {
@@ -581,10 +682,8 @@ uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport)
     lastport = 4096;
   }
   
-  for(c = 0; c < UIP_UDP_CONNS; ++c) {
-    if(uip_udp_conns[c].lport == uip_htons(lastport)) {
-      goto again;
-    }
+  if(udp_port_used(uip_htons(lastport))) {
+    goto again;
   }
 
   conn = 0;
@@ -599,7 +698,7 @@ uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport)
     return 0;
   }
   
-  conn->lport = UIP_HTONS(lastport);
+  uip_udp_bind(conn, UIP_HTONS(lastport));
   conn->rport = rport;
   if(ripaddr == NULL) {
     memset(&conn->ripaddr, 0, sizeof(uip_ipaddr_t));
@@ -956,7 +1055,9 @@ uip_process(struct net_buf *buf, uint8_t flag)
   register struct uip_conn *uip_connr = uip_conn;
 #endif /* UIP_TCP */
 #if UIP_UDP
+#if !UIP_UDP_CONN_HASH_SIZE
   int i;
+#endif /* !UIP_UDP_CONN_HASH_SIZE */
   if(flag == UIP_UDP_SEND_CONN) {
     goto udp_send;
   }
@@ -1525,6 +1626,12 @@ uip_process(struct net_buf *buf, uint8_t flag)
   }
 
   /* Demultiplex this UDP packet between the UDP "connections". */
+#if UIP_UDP_CONN_HASH_SIZE
+  uip_set_udp_conn(buf) = udp_conn_lookup(buf);
+  if(uip_udp_conn(buf) != NULL) {
+    goto udp_found;
+  }
+#else /* UIP_UDP_CONN_HASH_SIZE */
   for(i = 0; i < UIP_UDP_CONNS; i++) {
     /* If the local UDP port is non-zero, the connection is considered
        to be used. If so, the local port number is checked against the
@@ -1553,6 +1660,7 @@ uip_process(struct net_buf *buf, uint8_t flag)
       goto udp_found;
     }
   }
+#endif /* UIP_UDP_CONN_HASH_SIZE */
   uip_set_udp_conn(buf) = NULL;
   PRINTF("udp: no matching connection found\n");
   UIP_STAT(++uip_stat.udp.drop);
@@ -53,10 +53,73 @@
 #include "sys/process.h"
 
 static struct etimer *timerlist;
+/* Expired timers taken off timerlist, that the current poll has yet to
+   post to. */
+static struct etimer *expiredlist;
 static clock_time_t next_expiration;
 
+/* A single nano timer, armed for the earliest deadline of the timers
+   on timerlist, wakes up the fiber that runs them. */
+static struct nano_timer wakeup_timer;
+/* The timer queues its user data on expiry, linking it through its first
+   word, so it must not be NULL. */
+static void *wakeup_token[1];
+static clock_time_t wakeup_deadline;
+static bool wakeup_armed;
+static bool wakeup_init_done;
+
 PROCESS(etimer_process, "Event timer");
 /*---------------------------------------------------------------------------*/
+static bool
+list_remove(struct etimer **list, struct etimer *et)
+{
+  for(; *list != NULL; list = &(*list)->next) {
+    if(*list == et) {
+      *list = et->next;
+      et->next = NULL;
+      return true;
+    }
+  }
+  return false;
+}
+/*---------------------------------------------------------------------------*/
+static void
+wakeup_init(void)
+{
+  if(!wakeup_init_done) {
+    nano_timer_init(&wakeup_timer, wakeup_token);
+    wakeup_init_done = true;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+arm_wakeup(clock_time_t ticks)
+{
+  clock_time_t deadline = clock_time() + ticks;
+  unsigned int key;
+
+  wakeup_init();
+
+  if(wakeup_armed && wakeup_deadline == deadline) {
+    return;
+  }
+
+  /* An expiry the fiber has not waited for yet, because it was busy
+     running the timers, is dropped so that the token is never queued
+     twice. The deadline armed below covers it: timers that have already
+     expired are run on the next tick. Restarting the timer moves its
+     expiry without waking up the fiber that waits on it. */
+  key = irq_lock();
+  nano_timer_test(&wakeup_timer, TICKS_NONE);
+  nano_timer_start(&wakeup_timer, ticks);
+  irq_unlock(key);
+
+  wakeup_deadline = deadline;
+  wakeup_armed = true;
+
+  PRINTF("%s():%d wakeup in %d\n", __FUNCTION__, __LINE__, ticks);
+}
+/*---------------------------------------------------------------------------*/
 static void
 update_time(void)
 {
@@ -64,9 +127,12 @@ update_time(void)
   clock_time_t remaining;
 
   if (timerlist == NULL) {
+    /* The wakeup timer is left armed: the fiber then wakes up once for
+       nothing, rather than every time the last timer is stopped. */
     next_expiration = 0;
   } else {
     clock_time_t shortest = 0;
+    bool expired = false;
     for(t = timerlist; t != NULL; t = t->next) {
       remaining = timer_remaining(&t->timer);
       PRINTF("%s():%d etimer %p left %d shortest %d triggered %d\n",
@@ -75,16 +141,25 @@ update_time(void)
       if((shortest > remaining || shortest == 0) && remaining != 0) {
         shortest = remaining;
       }
+      if(remaining == 0) {
+        expired = true;
+      }
     }
     next_expiration = shortest;
     PRINTF("%s():%d next expiration %d\n", __FUNCTION__, __LINE__,
 	   next_expiration);
+
+    /* A timer that has expired but has not been run yet is run on the
+       next tick. */
+    arm_wakeup(expired ? 1 : shortest);
   }
 }
 /*---------------------------------------------------------------------------*/
 PROCESS_THREAD(etimer_process, ev, data, buf)
 {
   struct etimer *t;
+  struct etimer **list;
+  struct etimer **tail;
 
   PROCESS_BEGIN();
 
@@ -92,11 +167,33 @@ PROCESS_THREAD(etimer_process, ev, data, buf)
     PROCESS_YIELD();
 
     PRINTF("%s():%d timerlist %p\n", __FUNCTION__, __LINE__, timerlist);
-    for(t = timerlist; t != NULL; t = t->next) {
+
+    /* Detach the expired timers before posting to any of them, so that
+       each is run at most once per poll. A timer that its process sets
+       again, even as already expired, stays on timerlist for the next
+       poll, which update_time() schedules. */
+    list = &timerlist;
+    tail = &expiredlist;
+    while((t = *list) != NULL) {
       PRINTF("%s():%d timer %p remaining %d triggered %d\n",
 	     __FUNCTION__, __LINE__,
 	     t, timer_remaining(&t->timer), etimer_is_triggered(t));
-      if(etimer_expired(t) && !etimer_is_triggered(t)) {
+      if(etimer_expired(t)) {
+        *list = t->next;
+        t->next = NULL;
+        *tail = t;
+        tail = &t->next;
+      } else {
+        list = &t->next;
+      }
+    }
+
+    /* A timer set or stopped meanwhile leaves expiredlist. */
+    while((t = expiredlist) != NULL) {
+      expiredlist = t->next;
+      t->next = NULL;
+
+      if(!etimer_is_triggered(t)) {
         PRINTF("%s():%d timer %p expired, process %p\n",
 	       __FUNCTION__, __LINE__, t, t->p);
 
@@ -122,6 +219,14 @@ etimer_request_poll(void)
   return next_expiration;
 }
 /*---------------------------------------------------------------------------*/
+void
+etimer_wait(void)
+{
+  wakeup_init();
+
+  nano_fiber_timer_test(&wakeup_timer, TICKS_UNLIMITED);
+}
+/*---------------------------------------------------------------------------*/
 static void
 add_timer(struct etimer *timer)
 {
@@ -135,7 +240,9 @@ add_timer(struct etimer *timer)
     }
   }
 
-  /* Timer not on list. */
+  /* Timer not on list. One expired and waiting to be posted to is not
+     posted to anymore. */
+  list_remove(&expiredlist, timer);
   timer->next = timerlist;
   timerlist = timer;
 
@@ -210,6 +317,11 @@ etimer_stop(struct etimer *et)
 
   timer_stop(&et->timer);
 
+  /* An expired timer waiting to be posted to is not posted to anymore. */
+  if(list_remove(&expiredlist, et)) {
+    return;
+  }
+
   /* First check if et is the first event timer on the list. */
   if(et == timerlist) {
     timerlist = timerlist->next;
@@ -212,6 +212,18 @@ void etimer_stop(struct etimer *et);
  */
 clock_time_t etimer_request_poll(void);
 
+/**
+ * \brief      Wait for the next event timer to expire
+ *
+ *             This function blocks the calling fiber until the
+ *             earliest pending event timer expires, after which the
+ *             fiber calls etimer_request_poll() to run the expired
+ *             timers. Setting a timer to expire earlier moves the
+ *             wakeup accordingly. It may return early, for instance
+ *             once after the earliest timer was stopped.
+ */
+void etimer_wait(void);
+
 /**
  * \brief      Check if there are any non-expired event timers.
  * \return     True if there are active event timers, false if there are
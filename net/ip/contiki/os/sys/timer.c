@@ -174,7 +174,7 @@ timer_expired(struct timer *t)
 {
   do_init(t);
 
-  return t->nano_timer.ticks == 0;
+  return nano_timer_ticks_remain(&t->nano_timer) == 0;
 }
 /*---------------------------------------------------------------------------*/
 bool timer_is_triggered(struct timer *t)
@@ -200,7 +200,7 @@ void timer_set_triggered(struct timer *t)
 clock_time_t
 timer_remaining(struct timer *t)
 {
-  return t->nano_timer.ticks;
+  return nano_timer_ticks_remain(&t->nano_timer);
 }
 /*---------------------------------------------------------------------------*/
 bool timer_stop(struct timer *t)
@@ -644,59 +644,46 @@ static void net_rx_fiber(void)
 }
 
 /*
- * Run various Contiki timers. At the moment this is done via polling.
+ * Run various Contiki timers. The fiber sleeps until the earliest timer
+ * expires, rather than polling them.
  */
-#define DEFAULT_TIMER_WAKEUP 2
-#define MAX_TIMER_WAKEUP 2
-
 static void net_timer_fiber(void)
 {
-	clock_time_t next_wakeup;
-
 	NET_DBG("Starting net timer fiber\n");
 
 	while (1) {
-		/* Run various timers */
-		next_wakeup = etimer_request_poll();
-
-		if (next_wakeup == 0) {
-			/* There was no timers, wait a bit */
-			next_wakeup = DEFAULT_TIMER_WAKEUP;
-		} else {
-			if (next_wakeup > MAX_TIMER_WAKEUP) {
-				next_wakeup = MAX_TIMER_WAKEUP;
-			}
+		/* Run the expired timers */
+		etimer_request_poll();
 
 #ifdef CONFIG_INIT_STACKS
-			{
+		{
 #define PRINT_CYCLE (10 * sys_clock_hw_cycles_per_sec)
 
-				static clock_time_t next_print;
-				uint32_t cycle = clock_get_cycle();
+			static clock_time_t next_print;
+			uint32_t cycle = clock_get_cycle();
 
-				/* Print stack usage every 10 sec */
-				if (!next_print ||
-				    (next_print < cycle &&
-				     (!((cycle - next_print) > PRINT_CYCLE)))) {
-					clock_time_t new_print;
+			/* Print stack usage every 10 sec */
+			if (!next_print ||
+			    (next_print < cycle &&
+			     (!((cycle - next_print) > PRINT_CYCLE)))) {
+				clock_time_t new_print;
 
-					net_analyze_stack("timer fiber",
-							  timer_fiber_stack,
+				net_analyze_stack("timer fiber",
+						  timer_fiber_stack,
 						  sizeof(timer_fiber_stack));
-					new_print = cycle + PRINT_CYCLE;
-					if (new_print > cycle) {
-						next_print = new_print;
-					} else {
-						/* Overflow */
-						next_print = PRINT_CYCLE -
-							(0xffffffff - cycle);
-					}
+				new_print = cycle + PRINT_CYCLE;
+				if (new_print > cycle) {
+					next_print = new_print;
+				} else {
+					/* Overflow */
+					next_print = PRINT_CYCLE -
+						(0xffffffff - cycle);
 				}
 			}
-#endif
 		}
+#endif
 
-		fiber_sleep(next_wakeup);
+		etimer_wait();
 	}
 }
 
@@ -30,6 +30,7 @@ void queue_test(void)
 {
 	uint32_t et; /* elapsed time */
 	int i;
+	char *msg; /* message dequeued by reference */
 
 	PRINT_STRING(dashline, output_file);
 	et = BENCH_START();
@@ -71,6 +72,46 @@ void queue_test(void)
 	PRINT_F(output_file, FORMAT, "dequeue 4 bytes msg in FIFO",
 			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, NR_OF_FIFO_RUNS));
 
+	et = BENCH_START();
+	for (i = 0; i < NR_OF_FIFO_RUNS; i++) {
+		task_fifo_put(DEMOQX64, data_bench, TICKS_UNLIMITED);
+	}
+	et = TIME_STAMP_DELTA_GET(et);
+	check_result();
+
+	PRINT_F(output_file, FORMAT, "enqueue 64 bytes msg in FIFO",
+			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, NR_OF_FIFO_RUNS));
+
+	et = BENCH_START();
+	for (i = 0; i < NR_OF_FIFO_RUNS; i++) {
+		task_fifo_get(DEMOQX64, data_bench, TICKS_UNLIMITED);
+	}
+	et = TIME_STAMP_DELTA_GET(et);
+	check_result();
+
+	PRINT_F(output_file, FORMAT, "dequeue 64 bytes msg in FIFO",
+			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, NR_OF_FIFO_RUNS));
+
+	et = BENCH_START();
+	for (i = 0; i < NR_OF_FIFO_RUNS; i++) {
+		task_fifo_ref_put(DEMOQREF, data_bench, TICKS_UNLIMITED);
+	}
+	et = TIME_STAMP_DELTA_GET(et);
+	check_result();
+
+	PRINT_F(output_file, FORMAT, "enqueue 64 bytes msg by reference in FIFO",
+			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, NR_OF_FIFO_RUNS));
+
+	et = BENCH_START();
+	for (i = 0; i < NR_OF_FIFO_RUNS; i++) {
+		task_fifo_ref_get(DEMOQREF, &msg, TICKS_UNLIMITED);
+	}
+	et = TIME_STAMP_DELTA_GET(et);
+	check_result();
+
+	PRINT_F(output_file, FORMAT, "dequeue 64 bytes msg by reference in FIFO",
+			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, NR_OF_FIFO_RUNS));
+
 	task_sem_give(STARTRCV);
 
 	et = BENCH_START();
@@ -94,6 +135,28 @@ void queue_test(void)
 	PRINT_F(output_file, FORMAT,
 			"enqueue 4 bytes in FIFO to a waiting higher priority task",
 			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, NR_OF_FIFO_RUNS));
+
+	et = BENCH_START();
+	for (i = 0; i < NR_OF_FIFO_RUNS; i++) {
+		task_fifo_put(DEMOQX64, data_bench, TICKS_UNLIMITED);
+	}
+	et = TIME_STAMP_DELTA_GET(et);
+	check_result();
+
+	PRINT_F(output_file, FORMAT,
+			"enqueue 64 bytes in FIFO to a waiting higher priority task",
+			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, NR_OF_FIFO_RUNS));
+
+	et = BENCH_START();
+	for (i = 0; i < NR_OF_FIFO_RUNS; i++) {
+		task_fifo_ref_put(DEMOQREF, data_bench, TICKS_UNLIMITED);
+	}
+	et = TIME_STAMP_DELTA_GET(et);
+	check_result();
+
+	PRINT_F(output_file, FORMAT,
+			"enqueue 64 bytes by ref in FIFO to a waiting higher prio task",
+			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, NR_OF_FIFO_RUNS));
 }
 
 #endif /* FIFO_BENCH */
@@ -31,6 +31,7 @@
 void dequtask(void)
 {
 	int x, i;
+	char *msg;
 
 	for (i = 0; i < NR_OF_FIFO_RUNS; i++) {
 		task_fifo_get(DEMOQX1, &x, TICKS_UNLIMITED);
@@ -39,6 +40,14 @@ void dequtask(void)
 	for (i = 0; i < NR_OF_FIFO_RUNS; i++) {
 		task_fifo_get(DEMOQX4, &x, TICKS_UNLIMITED);
 	}
+
+	for (i = 0; i < NR_OF_FIFO_RUNS; i++) {
+		task_fifo_get(DEMOQX64, data_recv, TICKS_UNLIMITED);
+	}
+
+	for (i = 0; i < NR_OF_FIFO_RUNS; i++) {
+		task_fifo_ref_get(DEMOQREF, &msg, TICKS_UNLIMITED);
+	}
 }
 
 #endif /* FIFO_BENCH */
@@ -33,6 +33,12 @@ char data_bench[OCTET_TO_SIZEOFUNIT(MESSAGE_SIZE)];
 #ifdef PIPE_BENCH
 kpipe_t TestPipes[] = {PIPE_NOBUFF, PIPE_SMALLBUFF, PIPE_BIGBUFF};
 #endif
+#ifdef CONFIG_MICROKERNEL_FAST_PATH
+#define REQUEST_PATH "fast path"
+#else
+#define REQUEST_PATH "microkernel server"
+#endif
+
 const char dashline[] =
 	"|--------------------------------------"
 	"---------------------------------------|\n";
@@ -114,6 +120,9 @@ void BenchTask(void)
 					 "M E A S U R E M E N T S  |  nsec    |\n",
 					 output_file);
 		PRINT_STRING(dashline, output_file);
+		PRINT_F(output_file, "| uncontended semaphore, event and mutex "
+				"requests: %-27s|\n", REQUEST_PATH);
+		PRINT_STRING(dashline, output_file);
 		task_start(RECVTASK);
 		call_test();
 		queue_test();
@@ -55,11 +55,13 @@
 #define NR_OF_EVENT_RUNS  1000
 #define NR_OF_MBOX_RUNS 128
 #define NR_OF_PIPE_RUNS 256
+#define NR_OF_PIPE_PEERS 4
 #define SEMA_WAIT_TIME (5 * sys_clock_ticks_per_sec)
 /* global data */
 extern char Msg[MAX_MSG];
 extern char data_bench[OCTET_TO_SIZEOFUNIT(MESSAGE_SIZE)];
 extern kpipe_t TestPipes[];
+extern PeerInfo pipe_peer_info;
 extern FILE * output_file;
 extern const char dashline[];
 extern const char newline[];
@@ -21,6 +21,11 @@
 
 #ifdef MEMMAP_BENCH
 
+#ifdef CONFIG_MEM_MAP_LOCK_FREE
+#define MAP_PATH "lock-free"
+#else
+#define MAP_PATH "server"
+#endif
 
 /**
  *
@@ -43,8 +48,12 @@ void memorymap_test(void)
 	et = TIME_STAMP_DELTA_GET(et);
 	check_result();
 
-	PRINT_F(output_file, FORMAT, "average alloc and dealloc memory page",
+	PRINT_F(output_file, FORMAT,
+			"average alloc and dealloc memory page, " MAP_PATH,
 			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, (2 * NR_OF_MAP_RUNS)));
+	PRINT_F(output_file, FORMAT,
+			"average alloc and dealloc memory page (cycles)",
+			et / (2 * NR_OF_MAP_RUNS));
 }
 
 #endif /* MEMMAP_BENCH */
@@ -20,6 +20,69 @@
 
 #ifdef MEMPOOL_BENCH
 
+/* FILLPOOL is made of 64 blocks of 64 bytes */
+#define FILL_BLOCK_SIZE 64
+#define FILL_NR_OF_BLOCKS 64
+
+static struct k_block fill_blocks[FILL_NR_OF_BLOCKS];
+
+/**
+ *
+ * @brief Memory pool get/free test at a given fill level
+ *
+ * Every other block of the pool is allocated until the requested fill level
+ * is reached, so that the pool is fragmented, before a block is repeatedly
+ * allocated and freed.
+ *
+ * @param percent Fill level of the pool, in percent
+ *
+ * @return N/A
+ */
+static void mempool_fill_test(int percent)
+{
+	uint32_t et; /* elapsed time */
+	int i;
+	int nr_filled = FILL_NR_OF_BLOCKS * percent / 100;
+	struct k_block block;
+	char label[SLINE_LEN];
+
+	for (i = 0; i < FILL_NR_OF_BLOCKS; i++) {
+		task_mem_pool_alloc(&fill_blocks[i], FILLPOOL, FILL_BLOCK_SIZE,
+				    TICKS_NONE);
+	}
+	for (i = 0; i < FILL_NR_OF_BLOCKS; i++) {
+		/* keep every other block first, then the remaining ones */
+		int j = (2 * i) % FILL_NR_OF_BLOCKS + (2 * i) / FILL_NR_OF_BLOCKS;
+
+		if (i >= nr_filled) {
+			task_mem_pool_free(&fill_blocks[j]);
+		}
+	}
+
+	et = BENCH_START();
+	for (i = 0; i < NR_OF_POOL_RUNS; i++) {
+		task_mem_pool_alloc(&block, FILLPOOL, FILL_BLOCK_SIZE,
+				    TICKS_UNLIMITED);
+		task_mem_pool_free(&block);
+	}
+	et = TIME_STAMP_DELTA_GET(et);
+	check_result();
+
+	for (i = 0; i < FILL_NR_OF_BLOCKS; i++) {
+		int j = (2 * i) % FILL_NR_OF_BLOCKS + (2 * i) / FILL_NR_OF_BLOCKS;
+
+		if (i < nr_filled) {
+			task_mem_pool_free(&fill_blocks[j]);
+		}
+	}
+
+	snprintf(label, SLINE_LEN,
+		 "average alloc and dealloc 64 byte pool block, pool %d%% full",
+		 percent);
+	PRINT_F(output_file, FORMAT, label,
+			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, (2 * NR_OF_POOL_RUNS)));
+}
+
 /**
  *
  * @brief Memory pool get/free test
@@ -44,6 +107,12 @@ void mempool_test(void)
 	PRINT_F(output_file, FORMAT,
 			"average alloc and dealloc memory pool block",
 			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, (2 * NR_OF_POOL_RUNS)));
+
+	mempool_fill_test(0);
+	mempool_fill_test(25);
+	mempool_fill_test(50);
+	mempool_fill_test(75);
+	mempool_fill_test(95);
 }
 
 #endif /* MEMPOOL_BENCH */
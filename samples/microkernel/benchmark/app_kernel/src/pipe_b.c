@@ -51,6 +51,18 @@
 	     (1000.0 * putsize) / puttime[1],                         \
 	     (1000.0 * putsize) / puttime[2])
 
+#define  PRINT_PEERS()                                                \
+	PRINT_F(output_file,						\
+	     "|%5lu|%5d|%10.3f|%10.3f|%10.3f|%10.3f|%10.3f|%10.3f|\n",\
+	     putsize,                                                 \
+	     getsize,                                                 \
+	     puttime[0] / 1000.0,                                     \
+	     puttime[1] / 1000.0,                                     \
+	     puttime[2] / 1000.0,                                     \
+	     (1000.0 * xfersize) / puttime[0],                        \
+	     (1000.0 * xfersize) / puttime[1],                        \
+	     (1000.0 * xfersize) / puttime[2])
+
 #else
 #define PRINT_ALL_TO_N_HEADER_UNIT()                                       \
 	PRINT_STRING("|   size(B) |       time/packet (nsec)       |         "\
@@ -81,13 +93,35 @@
 	     (uint32_t)((1000000 * (uint64_t)putsize) / puttime[0]), \
 	     (uint32_t)((1000000 * (uint64_t)putsize) / puttime[1]), \
 	     (uint32_t)((1000000 * (uint64_t)putsize) / puttime[2]));
+
+#define  PRINT_PEERS()                                               \
+	PRINT_F(output_file,                                            \
+	     "|%5lu|%5d|%10lu|%10lu|%10lu|%10lu|%10lu|%10lu|\n",     \
+	     putsize,                                                \
+	     getsize,                                                \
+	     puttime[0],                                             \
+	     puttime[1],                                             \
+	     puttime[2],                                             \
+	     (uint32_t)((1000000 * (uint64_t)xfersize) / puttime[0]),\
+	     (uint32_t)((1000000 * (uint64_t)xfersize) / puttime[1]),\
+	     (uint32_t)((1000000 * (uint64_t)xfersize) / puttime[2]));
 #endif /* FLOAT */
 
+#ifdef CONFIG_PIPE_DIRECT_HANDOFF
+#define PIPE_XFER_PATH "direct handoff"
+#else
+#define PIPE_XFER_PATH "movedata requests"
+#endif
+
+PeerInfo pipe_peer_info;
+
 /*
  * Function prototypes.
  */
 int pipeput(kpipe_t pipe, K_PIPE_OPTION
 		 option, int size, int count, uint32_t *time);
+int pipepeers(kpipe_t pipe, int peersget, int size, uint32_t *time);
+void pipe_peer_test(void);
 
 /*
  * Function declarations.
@@ -184,6 +218,68 @@ void pipe_test(void)
 		PRINT_STRING(dashline, output_file);
 		task_priority_set(task_id_get(), TaskPrio);
 	}
+
+	pipe_peer_test();
+}
+
+
+/**
+ *
+ * @brief Test the pipes transfer speed between a task and several others
+ *
+ * The pipe peer tasks, which have a higher priority, wait on the pipe while
+ * this task writes the data of all of them at once (1_TO_N), or reads the
+ * data of all of them at once (N_TO_1).
+ *
+ * @return N/A
+ */
+void pipe_peer_test(void)
+{
+	uint32_t	putsize;
+	int		getsize;
+	uint32_t	xfersize;
+	uint32_t	puttime[3];
+	int		pipe;
+	int		peersget;
+	int		size;
+
+	task_group_start(PIPEPEERS);
+
+	PRINT_F(output_file, "| Send data into a pipe between a task and %d "
+			"waiting higher priority tasks    |\n", NR_OF_PIPE_PEERS);
+	PRINT_F(output_file, "| pipe data transfers: %-55s|\n",
+			PIPE_XFER_PATH);
+	PRINT_STRING(dashline, output_file);
+
+	for (peersget = 1; peersget >= 0; peersget--) {
+		if (peersget) {
+			PRINT_STRING("|                      "
+						 "one writer to several readers (1_TO_N)"
+						 "                 |\n", output_file);
+		} else {
+			PRINT_STRING("|                      "
+						 "several writers to one reader (N_TO_1)"
+						 "                 |\n", output_file);
+		}
+		PRINT_STRING(dashline, output_file);
+		PRINT_1_TO_N_HEADER();
+		PRINT_STRING("| put | get |  no buf  | small buf| big buf  |  "
+					 "no buf  | small buf| big buf  |\n", output_file);
+		PRINT_STRING(dashline, output_file);
+
+		for (size = 8; size <= MESSAGE_SIZE_PIPE / NR_OF_PIPE_PEERS;
+			 size <<= 1) {
+			xfersize = size * NR_OF_PIPE_PEERS;
+			putsize = peersget ? xfersize : size;
+			getsize = peersget ? size : xfersize;
+			for (pipe = 0; pipe < 3; pipe++) {
+				pipepeers(TestPipes[pipe], peersget, size,
+						  &puttime[pipe]);
+			}
+			PRINT_PEERS();
+		}
+		PRINT_STRING(dashline, output_file);
+	}
 }
 
 
@@ -248,4 +344,70 @@ int pipeput(kpipe_t pipe, K_PIPE_OPTION option, int size, int count, uint32_t *t
 	return 0;
 }
 
+
+/**
+ *
+ * @brief Transfer data between this task and the pipe peers and measure time
+ *
+ * @return 0 on success, 1 on error
+ *
+ * @param pipe     The pipe to be tested.
+ * @param peersget Non-zero if the peers read from the pipe, zero if they
+ *                 write to it.
+ * @param size     Data chunk size of each peer.
+ * @param time     Average time of a transfer of this task.
+ */
+int pipepeers(kpipe_t pipe, int peersget, int size, uint32_t *time)
+{
+	int i;
+	unsigned int t;
+	int sizexferd;
+	int ret;
+
+	pipe_peer_info.pipe = pipe;
+	pipe_peer_info.get = peersget;
+	pipe_peer_info.size = size;
+	pipe_peer_info.count = NR_OF_PIPE_RUNS;
+
+	/* each peer preempts this task and starts waiting on the pipe */
+	for (i = 0; i < NR_OF_PIPE_PEERS; i++) {
+		task_sem_give(PIPEPEERGO);
+	}
+
+	t = BENCH_START();
+	for (i = 0; i < NR_OF_PIPE_RUNS; i++) {
+		if (peersget) {
+			ret = task_pipe_put(pipe, data_bench,
+					    size * NR_OF_PIPE_PEERS, &sizexferd,
+					    _ALL_N, TICKS_UNLIMITED);
+		} else {
+			ret = task_pipe_get(pipe, data_recv,
+					    size * NR_OF_PIPE_PEERS, &sizexferd,
+					    _ALL_N, TICKS_UNLIMITED);
+		}
+		if (RC_OK != ret || sizexferd != size * NR_OF_PIPE_PEERS) {
+			return 1;
+		}
+	}
+
+	t = TIME_STAMP_DELTA_GET(t);
+	*time = SYS_CLOCK_HW_CYCLES_TO_NS_AVG(t, NR_OF_PIPE_RUNS);
+	if (bench_test_end() < 0) {
+		if (high_timer_overflow()) {
+			PRINT_STRING("| Timer overflow. Results are invalid            ",
+						 output_file);
+		} else {
+			PRINT_STRING("| Tick occurred. Results may be inaccurate       ",
+						 output_file);
+		}
+		PRINT_STRING("                             |\n", output_file);
+	}
+
+	/* wait for the peers to be done with their last transfer */
+	for (i = 0; i < NR_OF_PIPE_PEERS; i++) {
+		task_sem_take(PIPEPEERDONE, TICKS_UNLIMITED);
+	}
+	return 0;
+}
+
 #endif /* PIPE_BENCH */
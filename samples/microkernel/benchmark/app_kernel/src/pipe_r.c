@@ -83,6 +83,38 @@ void piperecvtask(void)
 }
 
 
+/**
+ *
+ * @brief Pipe peer task
+ *
+ * Several instances of this task read from or write to a pipe at the same
+ * time, to measure the transfers between one task and several others.
+ *
+ * @return N/A
+ */
+void pipepeertask(void)
+{
+	int i;
+	int sizexferd;
+
+	while (1) {
+		task_sem_take(PIPEPEERGO, TICKS_UNLIMITED);
+		for (i = 0; i < pipe_peer_info.count; i++) {
+			if (pipe_peer_info.get) {
+				task_pipe_get(pipe_peer_info.pipe, data_recv,
+					      pipe_peer_info.size, &sizexferd,
+					      _ALL_N, TICKS_UNLIMITED);
+			} else {
+				task_pipe_put(pipe_peer_info.pipe, data_bench,
+					      pipe_peer_info.size, &sizexferd,
+					      _ALL_N, TICKS_UNLIMITED);
+			}
+		}
+		task_sem_give(PIPEPEERDONE);
+	}
+}
+
+
 /**
  *
  * @brief Read a data portion from the pipe and measure time
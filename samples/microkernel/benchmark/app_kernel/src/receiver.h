@@ -30,6 +30,14 @@ typedef struct {
 	int size;
 } GetInfo;
 
+/* transfers performed by each of the pipe peer tasks */
+typedef struct {
+	kpipe_t pipe;
+	int get;
+	int size;
+	int count;
+} PeerInfo;
+
 /* global data */
 extern char data_recv[OCTET_TO_SIZEOFUNIT(MESSAGE_SIZE)];
 
@@ -55,6 +55,9 @@ void nanoTest(void)
 
 	nanoIntLockUnlock();
 	printDashLine();
+
+	nanoTickGet();
+	printDashLine();
 }
 
 #ifdef CONFIG_NANOKERNEL
@@ -81,6 +84,7 @@ int microIntToTask(void);
 int microSemaLockUnlock(void);
 int microMutexLockUnlock(void);
 void microTaskSwitchYield(void);
+int microCmdQueueFlood(void);
 
 /**
  *
@@ -107,6 +111,9 @@ void microTest(void)
 
 	microTaskSwitchYield();
 	printDashLine();
+
+	microCmdQueueFlood();
+	printDashLine();
 }
 
 /**
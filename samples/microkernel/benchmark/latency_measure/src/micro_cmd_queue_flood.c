@@ -0,0 +1,176 @@
+/* micro_cmd_queue_flood.c - measure task wake-up under a flood of requests */
+
+/*
+ * Copyright (c) 2016 Wind River Systems, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * DESCRIPTION
+ * This file contains test that measures how long the request waking up the
+ * high priority task waits in the microkernel server command queue, and the
+ * time from the interrupt handler issuing it to executing that task, while
+ * the interrupt handler floods the server with further requests. The server
+ * is handed a first flood request, the wake-up request is queued behind it,
+ * and the rest of the flood behind the wake-up request: the server processes
+ * the wake-up request right after the first flood request when its commands
+ * are queued in FIFO order, and after all the others when they are stacked.
+ * Either way, the task runs once the server has processed every request.
+ */
+
+#ifdef CONFIG_MICROKERNEL
+#include <zephyr.h>
+#include <irq_offload.h>
+
+#include "timestamp.h"
+#include "utils.h"
+
+#include <arch/cpu.h>
+
+#define NUM_WAKE_UPS 100
+
+/* number of flood requests issued by the ISR */
+#define FLOOD_REQUESTS_PER_INT 32
+
+#ifdef CONFIG_FIFO_COMMAND_QUEUE
+#define CMD_QUEUE_NAME "first in, first out"
+#else
+#define CMD_QUEUE_NAME "last in, first out"
+#endif
+
+static volatile int armed;
+
+static uint32_t timestamp;
+static uint32_t serviceTime;
+
+/**
+ *
+ * @brief Handler of the event waking up the high priority task
+ *
+ * This routine is run by the microkernel server when it processes the
+ * wake-up request, and records how long the request was queued for.
+ *
+ * @return 1, to signal the event
+ */
+static int wakeEventHandler(int event)
+{
+	ARG_UNUSED(event);
+
+	serviceTime = TIME_STAMP_DELTA_GET(timestamp);
+	return 1;
+}
+
+/**
+ *
+ * @brief Test ISR that floods the server and wakes up the high priority task
+ *
+ * @return N/A
+ */
+static void latencyTestIsr(void *unused)
+{
+	int i;
+
+	ARG_UNUSED(unused);
+
+	isr_sem_give(FLOODSEMA);
+
+	timestamp = TIME_STAMP_DELTA_GET(0);
+	isr_event_send(WAKEEVENT);
+
+	for (i = 1; i < FLOOD_REQUESTS_PER_INT; i++) {
+		isr_sem_give(FLOODSEMA);
+	}
+}
+
+/**
+ *
+ * @brief Lower priority task raising the flooding interrupt
+ *
+ * This routine raises the software interrupt once the high priority task
+ * waits for it.
+ *
+ * @return N/A
+ */
+void floodTask(void)
+{
+	while (1) {
+		if (armed) {
+			armed = 0;
+			irq_offload(latencyTestIsr, NULL);
+		}
+	}
+}
+
+/**
+ *
+ * @brief The test main function
+ *
+ * @return 0 on success
+ */
+int microCmdQueueFlood(void)
+{
+	uint32_t delta;
+	uint32_t total = 0;
+	uint32_t worst = 0;
+	uint32_t serviceTotal = 0;
+	uint32_t serviceWorst = 0;
+	int i;
+
+	PRINT_FORMAT(" 6- Measure time from ISR to executing a different task"
+				 " (rescheduled)");
+	PRINT_FORMAT("    while the ISR floods the microkernel server with"
+				 " %d requests", FLOOD_REQUESTS_PER_INT);
+	PRINT_FORMAT(" Server command queue order: %s", CMD_QUEUE_NAME);
+
+	task_event_handler_set(WAKEEVENT, wakeEventHandler);
+	task_group_start(FLOOD);
+
+	for (i = 0; i < NUM_WAKE_UPS; i++) {
+		armed = 1;
+		task_event_recv(WAKEEVENT, TICKS_UNLIMITED);
+		delta = TIME_STAMP_DELTA_GET(timestamp);
+
+		total += delta;
+		if (delta > worst) {
+			worst = delta;
+		}
+
+		serviceTotal += serviceTime;
+		if (serviceTime > serviceWorst) {
+			serviceWorst = serviceTime;
+		}
+
+		/* drain the flood */
+		while (task_sem_take(FLOODSEMA, TICKS_NONE) == RC_OK) {
+		}
+	}
+
+	task_group_suspend(FLOOD);
+	task_event_handler_set(WAKEEVENT, NULL);
+
+	PRINT_FORMAT(" Average time to service the wake-up request is %lu tcs"
+				 " = %lu nsec", serviceTotal / NUM_WAKE_UPS,
+				 SYS_CLOCK_HW_CYCLES_TO_NS(serviceTotal / NUM_WAKE_UPS));
+	PRINT_FORMAT(" Worst-case time to service the wake-up request is %lu"
+				 " tcs = %lu nsec", serviceWorst,
+				 SYS_CLOCK_HW_CYCLES_TO_NS(serviceWorst));
+	PRINT_FORMAT(" Average switch time is %lu tcs = %lu nsec",
+				 total / NUM_WAKE_UPS,
+				 SYS_CLOCK_HW_CYCLES_TO_NS(total / NUM_WAKE_UPS));
+	PRINT_FORMAT(" Worst-case switch time is %lu tcs = %lu nsec",
+				 worst, SYS_CLOCK_HW_CYCLES_TO_NS(worst));
+	return 0;
+}
+
+#endif /* CONFIG_MICROKERNEL */
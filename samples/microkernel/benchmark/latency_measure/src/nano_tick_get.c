@@ -0,0 +1,189 @@
+/* nano_tick_get.c - measure time to read the system tick count */
+
+/*
+ * Copyright (c) 2016 Wind River Systems, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * DESCRIPTION
+ * This file contains test that measures the time needed to read the 64-bit
+ * system tick count with sys_tick_get(), which does not lock interrupts, and
+ * with the read sys_tick_get() used to do, which locks interrupts around it.
+ * It then measures the interrupt latency while the test loops on either read,
+ * using a high resolution timer as interrupt source: the timer interrupt is
+ * raised at a given hardware clock cycle, wherever the loop happens to be,
+ * and the latency is the number of cycles from that one to the timer expiry
+ * function. It includes the time the timer driver takes to dispatch the
+ * expiry, the same for both reads.
+ */
+
+#include "timestamp.h"
+#include "utils.h"
+
+#include <arch/cpu.h>
+#include <sys_clock.h>
+
+/* total number of tick count reads */
+#define NTESTS 100000
+
+/* total number of interrupts raised to measure the interrupt latency */
+#define NINTS 1000
+
+/*
+ * Base delay of the timer interrupts, in hardware clock cycles, and the
+ * number of different delays added to it, so that the interrupts hit the
+ * reads at different points.
+ */
+#define HRTIMER_DELAY 1000
+#define HRTIMER_SPREAD 37
+
+static uint32_t timestamp;
+
+/**
+ *
+ * @brief Read the system tick count with interrupts locked
+ *
+ * This routine reads the system tick count the way sys_tick_get() did before
+ * it stopped locking interrupts.
+ *
+ * @return the current system tick count
+ */
+static int64_t lockedTickGet(void)
+{
+	int64_t ticks;
+	unsigned int imask = irq_lock();
+
+	ticks = _sys_clock_tick_count;
+	irq_unlock(imask);
+	return ticks;
+}
+
+#ifdef CONFIG_SYS_HRTIMER
+static struct sys_hrtimer latencyTimer;
+static volatile int latencyTimerExpired;
+static uint32_t latency;
+
+/**
+ *
+ * @brief Expiry function of the timer used to measure the interrupt latency
+ *
+ * @return N/A
+ */
+static void latencyTimerExpire(struct sys_hrtimer *timer)
+{
+	latency = sys_cycle_get_32() - timer->expiry;
+	latencyTimerExpired = 1;
+}
+
+/**
+ *
+ * @brief Measure the worst-case interrupt latency while reading the tick count
+ *
+ * @param tickGet  routine reading the tick count in a loop until the timer
+ *                 interrupt is serviced
+ *
+ * @return worst-case latency, in hardware clock cycles
+ */
+static uint32_t latencyWorstGet(int64_t (*tickGet)(void))
+{
+	int i;
+	uint32_t worst = 0;
+	volatile int64_t ticks;
+
+	for (i = 0; i < NINTS; i++) {
+		latencyTimerExpired = 0;
+		sys_hrtimer_start(&latencyTimer,
+				  HRTIMER_DELAY + (i % HRTIMER_SPREAD));
+		while (!latencyTimerExpired) {
+			ticks = tickGet();
+		}
+		if (latency > worst) {
+			worst = latency;
+		}
+	}
+
+	ARG_UNUSED(ticks);
+	return worst;
+}
+#endif /* CONFIG_SYS_HRTIMER */
+
+/**
+ *
+ * @brief The test main function
+ *
+ * @return 0 on success
+ */
+int nanoTickGet(void)
+{
+	int i;
+	volatile int64_t ticks;
+#ifdef CONFIG_SYS_HRTIMER
+	uint32_t worst;
+#endif
+
+	PRINT_FORMAT(" 6- Measure time to read the 64-bit system tick count");
+	PRINT_FORMAT(" 6.1- When read with sys_tick_get()");
+	bench_test_start();
+	timestamp = TIME_STAMP_DELTA_GET(0);
+	for (i = 0; i < NTESTS; i++) {
+		ticks = sys_tick_get();
+	}
+	timestamp = TIME_STAMP_DELTA_GET(timestamp);
+	if (bench_test_end() == 0) {
+		PRINT_FORMAT(" Average time for read is %u tcs = %u nsec",
+			timestamp / NTESTS,
+			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(timestamp, NTESTS));
+		PRINT_FORMAT(" Interrupts are not locked by the read");
+	} else {
+		errorCount++;
+		PRINT_OVERFLOW_ERROR();
+	}
+
+	PRINT_FORMAT("");
+	PRINT_FORMAT(" 6.2- When read with interrupts locked");
+	bench_test_start();
+	timestamp = TIME_STAMP_DELTA_GET(0);
+	for (i = 0; i < NTESTS; i++) {
+		ticks = lockedTickGet();
+	}
+	timestamp = TIME_STAMP_DELTA_GET(timestamp);
+	if (bench_test_end() == 0) {
+		PRINT_FORMAT(" Average time for read is %u tcs = %u nsec",
+			timestamp / NTESTS,
+			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(timestamp, NTESTS));
+	} else {
+		errorCount++;
+		PRINT_OVERFLOW_ERROR();
+	}
+
+	PRINT_FORMAT("");
+	PRINT_FORMAT(" 6.3- Interrupt latency while reading the tick count");
+#ifdef CONFIG_SYS_HRTIMER
+	sys_hrtimer_init(&latencyTimer, latencyTimerExpire);
+
+	worst = latencyWorstGet(sys_tick_get);
+	PRINT_FORMAT(" Worst-case latency with sys_tick_get() is "
+		"%u tcs = %u nsec", worst, SYS_CLOCK_HW_CYCLES_TO_NS(worst));
+
+	worst = latencyWorstGet(lockedTickGet);
+	PRINT_FORMAT(" Worst-case latency with interrupts locked is "
+		"%u tcs = %u nsec", worst, SYS_CLOCK_HW_CYCLES_TO_NS(worst));
+#else
+	PRINT_FORMAT(" Not measured: requires CONFIG_SYS_HRTIMER");
+#endif
+
+	ARG_UNUSED(ticks);
+	return 0;
+}
@@ -0,0 +1,180 @@
+/* main.c - microkernel timeout scalability benchmark */
+
+/*
+ * Copyright (c) 2016 Wind River Systems, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * DESCRIPTION
+ * This benchmark measures the cost of a task_sem_take() with a timeout that
+ * blocks until the semaphore is given, while a growing number of other
+ * microkernel timers are running, for the timer queue selected by the project
+ * configuration.
+ *
+ * Each task waiting on a kernel object with a timeout holds one running timer,
+ * so the running timers stand for as many concurrent task_sem_take() calls
+ * with a timeout, without requiring as many task stacks.
+ */
+
+#include <zephyr.h>
+#include <stdio.h>
+#include <misc/util.h>
+
+#include "timestamp.h"
+
+#define MAX_TIMERS 4000
+#define NUM_PROBES 100
+
+/*
+ * The timers and the timeouts are started far enough in the future that none
+ * of them expires while the benchmark is running.
+ */
+#define TIMER_MIN_TICKS 100000
+#define TIMER_RANGE_TICKS 100000
+
+#ifdef CONFIG_MICROKERNEL_TIMER_WHEEL
+#define TIMER_QUEUE_NAME "timing wheel"
+#else
+#define TIMER_QUEUE_NAME "delta list"
+#endif
+
+uint32_t tm_off; /* time necessary to read the time */
+
+static ktimer_t timers[MAX_TIMERS];
+
+static const int num_timers[] = { 10, 100, 1000, MAX_TIMERS };
+
+static uint32_t seed = 1;
+
+/**
+ *
+ * @brief Generate a pseudo-random timer duration
+ *
+ * @return duration in ticks
+ */
+static int random_ticks(void)
+{
+	seed = seed * 1103515245 + 12345;
+
+	return TIMER_MIN_TICKS + (int)((seed >> 8) % TIMER_RANGE_TICKS);
+}
+
+/**
+ *
+ * @brief Print dash line
+ *
+ * @return N/A
+ */
+static void print_dash_line(void)
+{
+	printf("|-----------------------------------------------------------------"
+		   "------------|\n");
+}
+
+/**
+ *
+ * @brief Measure a timed semaphore take with a number of running timers
+ *
+ * @param n number of running timers
+ *
+ * @return N/A
+ */
+static void timeout_scaling_test(int n)
+{
+	uint32_t take_time = 0;
+	uint32_t t;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		task_timer_start(timers[i], random_ticks(), 0, TIMERSEMA);
+	}
+
+	for (i = 0; i < NUM_PROBES; i++) {
+		int ticks = random_ticks();
+
+		/* give_task() gives the semaphore once this task blocks */
+		t = TIME_STAMP_DELTA_GET(0);
+		task_sem_take(PROBESEMA, ticks);
+		take_time += TIME_STAMP_DELTA_GET(t);
+	}
+
+	for (i = 0; i < n; i++) {
+		task_timer_stop(timers[i]);
+	}
+
+	printf("| %14d | %58lu |\n", n,
+		   (unsigned long)(take_time / NUM_PROBES));
+}
+
+/**
+ *
+ * @brief Give the semaphore the probe task waits for
+ *
+ * This task runs at a lower priority than the probe task, and thus only
+ * while the probe task waits for the semaphore.
+ *
+ * @return N/A
+ */
+void give_task(void)
+{
+	int i;
+
+	for (i = 0; i < NUM_PROBES * ARRAY_SIZE(num_timers); i++) {
+		task_sem_give(PROBESEMA);
+	}
+}
+
+/**
+ *
+ * @brief Run the benchmark
+ *
+ * @return N/A
+ */
+void probe_task(void)
+{
+	int i;
+
+	bench_test_init();
+
+	for (i = 0; i < MAX_TIMERS; i++) {
+		timers[i] = task_timer_alloc();
+	}
+
+	print_dash_line();
+	printf("|                  Microkernel Timeout Scalability Benchmark  "
+		   "                |\n");
+	print_dash_line();
+	printf("|  timer queue: %-62s|\n", TIMER_QUEUE_NAME);
+	printf("|  tcs = timer clock cycles: 1 tcs is %-5lu nsec"
+		   "                              |\n",
+		   (unsigned long)SYS_CLOCK_HW_CYCLES_TO_NS(1));
+	print_dash_line();
+	printf("| running timers | task_sem_take() with timeout, blocking "
+		   "(average tcs)       |\n");
+	print_dash_line();
+
+	for (i = 0; i < ARRAY_SIZE(num_timers); i++) {
+		timeout_scaling_test(num_timers[i]);
+	}
+
+	for (i = 0; i < MAX_TIMERS; i++) {
+		task_timer_free(timers[i]);
+	}
+
+	print_dash_line();
+	printf("|                                    E N D                       "
+		   "             |\n");
+	print_dash_line();
+}
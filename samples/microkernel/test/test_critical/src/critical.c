@@ -134,7 +134,12 @@ void RegressionTask(void)
 
 	TC_PRINT("Enabling time slicing ...\n");
 
+#ifdef CONFIG_TIMESLICE_PER_PRIORITY
+	/* slice the priority level of both tasks only */
+	sys_scheduler_time_slice_prio_set(task_priority_get(), 1);
+#else
 	sys_scheduler_time_slice_set(1, 10);
+#endif
 
 	task_sem_give(ALT_SEM);      /* Re-activate AlternateTask() */
 
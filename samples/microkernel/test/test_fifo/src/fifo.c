@@ -24,12 +24,15 @@
  *   task_fifo_get
  *   task_fifo_size_get
  *   task_fifo_purge
+ *   task_fifo_ref_put
+ *   task_fifo_ref_get
  *
  * Scenarios tested include:
  * - Check number of elements in queue when queue is empty, full or
  *   while it is being dequeued
  * - Verify the data being dequeued are in correct order
  * - Verify the return codes are correct for the APIs
+ * - Verify a by-reference FIFO hands back the pointers it was given
  */
 
 #include <tc_util.h>
@@ -51,6 +54,7 @@ static int tcRC = TC_PASS;              /* test case return code */
 
 #ifdef TEST_PRIV_FIFO
 	DEFINE_FIFO(FIFOQ, 2, 4);
+	DEFINE_FIFO_REF(REFQ, 2);
 #endif
 
 /**
@@ -339,6 +343,68 @@ exitTest2:
 } /* verifyQueueData */
 
 
+/**
+ *
+ * @brief Verify by-reference FIFO
+ *
+ * This routine fills the by-reference FIFO queue with pointers to elements of
+ * myData, and checks that the same pointers are dequeued in the same order.
+ *
+ * @return  TC_PASS, TC_FAIL
+ *
+ * Also updates tcRC when result is TC_FAIL.
+ */
+int verifyRefFIFO(void)
+{
+	int result = TC_PASS;       /* TC_PASS or TC_FAIL for this function */
+	int retValue;               /* task_fifo_xxx interface return value */
+	int *locPtr;                /* pointer dequeued from the queue */
+	int i;
+
+	for (i = 0; i < DEPTH_OF_FIFO_QUEUE; i++) {
+		retValue = task_fifo_ref_put(REFQ, &myData[i], TICKS_NONE);
+		if (!verifyRetValue(RC_OK, retValue)) {
+			TC_ERROR("Failed task_fifo_ref_put for i=%d, retValue %d\n",
+					 i, retValue);
+			result = TC_FAIL;
+			goto exitTest5;
+		}
+	}
+
+	retValue = task_fifo_ref_put(REFQ, &myData[i], TICKS_NONE);
+	if (!verifyRetValue(RC_FAIL, retValue)) {
+		TC_ERROR("Incorrect return value %d when REFQ is full\n", retValue);
+		result = TC_FAIL;
+		goto exitTest5;
+	}
+
+	for (i = 0; i < DEPTH_OF_FIFO_QUEUE; i++) {
+		retValue = task_fifo_ref_get(REFQ, &locPtr, TICKS_NONE);
+		if ((retValue != RC_OK) || (locPtr != &myData[i])) {
+			TC_ERROR("Got back pointer %p, retValue %d for i=%d\n",
+					 locPtr, retValue, i);
+			result = TC_FAIL;
+			goto exitTest5;
+		}
+		TC_PRINT("%s: i=%d, got back pointer to data %d\n",
+				 __func__, i, *locPtr);
+	}
+
+	retValue = task_fifo_ref_get(REFQ, &locPtr, TICKS_NONE);
+	if (!verifyRetValue(RC_FAIL, retValue)) {
+		TC_ERROR("Incorrect return value %d when REFQ is empty\n", retValue);
+		result = TC_FAIL;
+	}
+
+exitTest5:
+	if (result == TC_FAIL) {
+		tcRC = TC_FAIL;
+	}
+
+	TC_END_RESULT(result);
+	return result;
+}
+
 /**
  *
  * @brief Main task to test FIFO queue
@@ -619,6 +685,15 @@ void RegressionTask(void)
 		TC_PRINT("%s: queue is empty.  Test Done!\n", __func__);
 	}
 
+	PRINT_LINE;
+/*----------------------------------------------------------------------------*/
+
+	result = verifyRefFIFO();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("Failed verifyRefFIFO.\n");
+		goto exitTest;
+	}
+
 	task_sem_take(SEM_TestDone, TICKS_UNLIMITED);
 
 exitTest:
@@ -26,9 +26,8 @@
  *    task_mbox_data_get
  *    task_mbox_data_block_get
  *
- * The module does NOT test the following mailbox APIs:
- *
  *    task_mbox_block_put
+ *    task_mbox_block_get
  *
  * Also, not all capabilities of all of the tested APIs are exercised.
  * Things that are not (yet) tested include:
@@ -46,6 +45,7 @@
 #include <zephyr.h>
 
 #include <tc_util.h>
+#include <microkernel/command_packet.h>
 
 #define MSGSIZE		16    /* Standard message data size */
 #define XFER_PRIO	5     /* standard message transfer priority */
@@ -74,6 +74,14 @@ DEFINE_MAILBOX(noRcvrMbox);
 extern kmemory_pool_t testPool;
 extern kmemory_pool_t smallBlkszPool;
 
+/* data of the block posted in the block handover test */
+static void *handoverData;
+
+#if (CONFIG_COMMAND_PACKET_RESERVE > 0)
+/* number of messages posted in the command packet back-pressure test */
+#define NUM_POSTED_MSGS	(2 * CONFIG_NUM_COMMAND_PACKETS)
+#endif
+
 /**
  *
  * @brief Sets various fields in the message for the sender
@@ -166,6 +174,9 @@ int MsgSenderTask(void)
 {
 	int retValue;           /* task_mbox_xxx interface return value */
 	struct k_msg  MSTmsg;   /* Message sender task msg */
+#if (CONFIG_COMMAND_PACKET_RESERVE > 0)
+	int i;
+#endif
 
 	/* Send message (no wait) to a mailbox with no receiver */
 
@@ -351,6 +362,93 @@ int MsgSenderTask(void)
 	TC_PRINT("%s: task_mbox_put(timeout) for long-duration receive test is OK\n",
 		__func__);
 
+	/* Post message used in block handover test */
+
+	retValue = task_mem_pool_alloc(&MSTmsg.tx_block, testPool, MSGSIZE,
+				       TICKS_NONE);
+	if (RC_OK != retValue) {
+		TC_ERROR("task_mem_pool_alloc for block handover test returned %d\n",
+			retValue);
+		return TC_FAIL;
+	}
+	handoverData = MSTmsg.tx_block.pointer_to_data;
+	memcpy(handoverData, myData4, MSGSIZE);
+
+	setMsg_Sender(&MSTmsg, myMbox, msgRcvrTask, NULL, MSGSIZE, MSG_INFO1);
+	task_mbox_block_put(myMbox, XFER_PRIO, &MSTmsg, semSync2);
+
+	/* Wait for Receiver Task to take the block */
+
+	if (RC_OK != task_sem_take(semSync2, 5)) {
+		TC_ERROR("task_mbox_block_put for block handover test "
+			"did not complete\n");
+		return TC_FAIL;
+	}
+
+	TC_PRINT("%s: task_mbox_block_put for block handover test is OK\n",
+		__func__);
+
+	/* Post message used in header-only block receive test */
+
+	retValue = task_mem_pool_alloc(&MSTmsg.tx_block, testPool, MSGSIZE, 2);
+	if (RC_OK != retValue) {
+		TC_ERROR("task_mem_pool_alloc for header-only block receive test "
+			"returned %d\n", retValue);
+		return TC_FAIL;
+	}
+
+	setMsg_Sender(&MSTmsg, myMbox, msgRcvrTask, NULL, MSGSIZE, MSG_INFO1);
+	task_mbox_block_put(myMbox, XFER_PRIO, &MSTmsg, semSync2);
+
+	if (RC_OK != task_sem_take(semSync2, 5)) {
+		TC_ERROR("task_mbox_block_put for header-only block receive test "
+			"did not complete\n");
+		return TC_FAIL;
+	}
+
+	/* The receiver took no data, so the block must be back in the pool */
+
+	retValue = task_mem_pool_alloc(&MSTmsg.tx_block, testPool, MSGSIZE,
+				       TICKS_NONE);
+	if (RC_OK != retValue) {
+		TC_ERROR("block of header-only block receive test was not "
+			"released\n");
+		return TC_FAIL;
+	}
+	task_mem_pool_free(&MSTmsg.tx_block);
+
+	TC_PRINT("%s: task_mbox_block_put for header-only block receive test "
+		"is OK\n", __func__);
+
+	/* Send message used in block copy receive test */
+
+	setMsg_Sender(&MSTmsg, myMbox, msgRcvrTask, myData1, MSGSIZE, MSG_INFO2);
+	retValue = task_mbox_put(myMbox, XFER_PRIO, &MSTmsg, TICKS_UNLIMITED);
+	if (RC_OK != retValue) {
+		TC_ERROR("task_mbox_put for block copy receive test returned %d\n",
+			retValue);
+		return TC_FAIL;
+	}
+
+	TC_PRINT("%s: task_mbox_put(TICKS_UNLIMITED) for block copy receive test is OK\n",
+		__func__);
+
+#if (CONFIG_COMMAND_PACKET_RESERVE > 0)
+	/*
+	 * Post more messages than there are command packets; the sender
+	 * must be held back, rather than the system failing, until the
+	 * Receiver Task takes enough of them
+	 */
+
+	for (i = 0; i < NUM_POSTED_MSGS; i++) {
+		setMsg_Sender(&MSTmsg, myMbox, msgRcvrTask, NULL, 0, i);
+		task_mbox_block_put(myMbox, XFER_PRIO, &MSTmsg, 0);
+	}
+
+	TC_PRINT("%s: task_mbox_block_put of %d posted messages is OK\n",
+		__func__, NUM_POSTED_MSGS);
+#endif
+
 	return TC_PASS;
 }
 
@@ -371,6 +469,9 @@ int MsgRcvrTask(void)
 				  space at end for overrun testing) */
 	struct k_block  MRTblock;      /* Message receiver task memory block */
 	struct k_block  MRTblockAlt;   /* Message receiver task memory block (alternate) */
+#if (CONFIG_COMMAND_PACKET_RESERVE > 0)
+	int i;
+#endif
 
 	/* Receive message (no wait) from an empty mailbox */
 
@@ -678,5 +779,108 @@ int MsgRcvrTask(void)
 			__func__);
 	TC_PRINT("%s: task_mbox_data_get of message data #3 is OK\n", __func__);
 
+	/* Receive posted block for block handover test */
+
+	setMsg_Receiver(&MRTmsg, myMbox, msgSenderTask, NULL, MSGSIZE);
+	retValue = task_mbox_block_get(myMbox, &MRTmsg, &MRTblock, testPool,
+				       TICKS_UNLIMITED);
+	if (RC_OK != retValue) {
+		TC_ERROR("task_mbox_block_get of posted block returned %d\n",
+			retValue);
+		return TC_FAIL;
+	}
+	if (MRTmsg.info != MSG_INFO1) {
+		TC_ERROR("task_mbox_block_get of posted block got wrong info (%d)\n",
+			MRTmsg.info);
+		return TC_FAIL;
+	}
+	if (MRTblock.pointer_to_data != handoverData) {
+		TC_ERROR("task_mbox_block_get of posted block got a copy\n");
+		return TC_FAIL;
+	}
+	if (strcmp((char *)(MRTblock.pointer_to_data), myData4) != 0) {
+		TC_ERROR("task_mbox_block_get of posted block got wrong data (%s)\n",
+			MRTblock.pointer_to_data);
+		return TC_FAIL;
+	}
+
+	TC_PRINT("%s: task_mbox_block_get handover of posted block is OK\n",
+			__func__);
+
+	/* Release the block, which now belongs to this task */
+
+	task_mem_pool_free(&MRTblock);
+
+	/* Receive posted block without its data */
+
+	setMsg_Receiver(&MRTmsg, myMbox, msgSenderTask, NULL, 0);
+	retValue = task_mbox_block_get(myMbox, &MRTmsg, &MRTblock, testPool,
+				       TICKS_UNLIMITED);
+	if (RC_OK != retValue) {
+		TC_ERROR("task_mbox_block_get of header only returned %d\n",
+			retValue);
+		return TC_FAIL;
+	}
+	if ((MRTmsg.size != 0) ||
+	    (MRTblock.pool_id != (kmemory_pool_t) -1)) {
+		TC_ERROR("task_mbox_block_get of header only got a block\n");
+		return TC_FAIL;
+	}
+
+	TC_PRINT("%s: task_mbox_block_get of header only is OK\n", __func__);
+
+	/* Receive message data into a block for block copy receive test */
+
+	setMsg_Receiver(&MRTmsg, myMbox, msgSenderTask, NULL, MSGSIZE);
+	retValue = task_mbox_block_get(myMbox, &MRTmsg, &MRTblock, testPool,
+				       TICKS_UNLIMITED);
+	if (RC_OK != retValue) {
+		TC_ERROR("task_mbox_block_get of message data returned %d\n",
+			retValue);
+		return TC_FAIL;
+	}
+	if (strcmp((char *)(MRTblock.pointer_to_data), myData1) != 0) {
+		TC_ERROR("task_mbox_block_get got wrong data (%s)\n",
+			MRTblock.pointer_to_data);
+		return TC_FAIL;
+	}
+
+	TC_PRINT("%s: task_mbox_block_get copy of message data is OK\n",
+			__func__);
+
+	task_mem_pool_free(&MRTblock);
+
+#if (CONFIG_COMMAND_PACKET_RESERVE > 0)
+	/* Receive the messages posted in the back-pressure test */
+
+	for (i = 0; i < NUM_POSTED_MSGS; i++) {
+		setMsg_Receiver(&MRTmsg, myMbox, msgSenderTask, NULL, 0);
+		retValue = task_mbox_get(myMbox, &MRTmsg, TICKS_UNLIMITED);
+		if (RC_OK != retValue) {
+			TC_ERROR("task_mbox_get of posted message #%d returned %d\n",
+				i, retValue);
+			return TC_FAIL;
+		}
+	}
+
+#ifdef CONFIG_COMMAND_PACKET_STATS
+	struct cmd_pkt_stats stats;
+
+	sys_command_packet_stats_get(&stats);
+	if (stats.waits == 0) {
+		TC_ERROR("posted messages were never held back\n");
+		return TC_FAIL;
+	}
+	if (stats.used_max > CONFIG_NUM_COMMAND_PACKETS) {
+		TC_ERROR("command packet high watermark is %d\n",
+			stats.used_max);
+		return TC_FAIL;
+	}
+#endif
+
+	TC_PRINT("%s: task_mbox_get of %d posted messages is OK\n",
+			__func__, NUM_POSTED_MSGS);
+#endif
+
 	return TC_PASS;
 }
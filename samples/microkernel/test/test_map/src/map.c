@@ -25,6 +25,8 @@
  *     task_mem_map_alloc
  *     task_mem_map_free
  *     task_mem_map_used_get
+ *     fiber_mem_map_alloc (with CONFIG_MEM_MAP_LOCK_FREE)
+ *     fiber_mem_map_free (with CONFIG_MEM_MAP_LOCK_FREE)
  *
  * @note
  * One should ensure that the block is released to the same map from which it
@@ -52,6 +54,55 @@ int testMapFreeAllBlocks(void **P);
 DEFINE_MEM_MAP(MAP_LgBlks, 2, 1024);
 #endif
 
+#ifdef CONFIG_MEM_MAP_LOCK_FREE
+#define FIBER_STACK_SIZE 1024
+
+static char __stack fiberStack[FIBER_STACK_SIZE];
+static int fiberRC;
+
+/**
+ *
+ * @brief Fiber allocating and freeing memory blocks
+ *
+ * This fiber allocates all the memory blocks and checks that no more can be
+ * allocated. It then frees them a tick later, while RegressionTask waits for
+ * a block.
+ *
+ * @return  N/A
+ */
+
+static void MapFiber(int unused1, int unused2)
+{
+	void *ptr[NUMBLOCKS];
+	void *b;
+	int i;
+
+	ARG_UNUSED(unused1);
+	ARG_UNUSED(unused2);
+
+	for (i = 0; i < NUMBLOCKS; i++) {
+		if (fiber_mem_map_alloc(MAP_LgBlks, &ptr[i]) != RC_OK) {
+			fiberRC = TC_FAIL;
+			return;
+		}
+	}
+
+	if (fiber_mem_map_alloc(MAP_LgBlks, &b) != RC_FAIL) {
+		fiberRC = TC_FAIL;
+		return;
+	}
+
+	fiber_sleep(1);
+
+	for (i = 0; i < NUMBLOCKS; i++) {
+		fiber_mem_map_free(MAP_LgBlks, &ptr[i]);
+		if (ptr[i] != NULL) {
+			fiberRC = TC_FAIL;
+		}
+	}
+}
+#endif
+
 /**
  *
  * @brief Verify return value
@@ -390,6 +441,36 @@ void RegressionTask(void)
 	TC_PRINT("%s: 1 block freed, used %d block\n",
 		__func__,  task_mem_map_used_get(MAP_LgBlks));
 
+#ifdef CONFIG_MEM_MAP_LOCK_FREE
+	/*
+	 * Part 6 of test.
+	 *
+	 * MapFiber gets all memory blocks, then frees them while this task
+	 * waits for one.
+	 */
+
+	fiberRC = TC_PASS;
+	task_fiber_start(fiberStack, FIBER_STACK_SIZE, MapFiber, 0, 0, 7, 0);
+
+	retValue = task_mem_map_alloc(MAP_LgBlks, &b, 10);
+	if (verifyRetValue(RC_OK, retValue) && (fiberRC == TC_PASS)) {
+		TC_PRINT("%s: block freed by fiber allocated at %p\n",
+			__func__, b);
+	} else {
+		TC_ERROR("Failed fiber_mem_map_xxx, retValue %d\n", retValue);
+		tcRC = TC_FAIL;
+		goto exitTest;           /* terminate test */
+	}
+
+	task_mem_map_free(MAP_LgBlks, &b);
+	if (task_mem_map_used_get(MAP_LgBlks) != 0) {
+		TC_ERROR("Failed task_mem_map_used_get, used %d blocks\n",
+			task_mem_map_used_get(MAP_LgBlks));
+		tcRC = TC_FAIL;
+		goto exitTest;           /* terminate test */
+	}
+#endif
+
 exitTest:
 
 	TC_END_RESULT(tcRC);
@@ -0,0 +1,276 @@
+/* timeslice.c - test fair and per-priority time slicing */
+
+/*
+ * Copyright (c) 2016 Wind River Systems, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+DESCRIPTION
+This module tests per-priority time slicing and fair time slicing.
+
+Two background tasks of equal priority spin while a higher priority I/O task
+wakes up periodically and runs for half a tick, preempting them part way
+through their slices. The background tasks are expected to get CPU shares
+within a tolerance of each other, and the I/O task, whose priority level is
+exempt from slicing, to wake up on time every period.
+
+A task then shares the priority level of the idle task. It is expected to be
+switched back in at the end of each time slice of the idle task, including
+when the idle task has stopped the periodic tick.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+#include <misc/util.h>
+
+#define SLICE_TICKS      2
+#define TEST_TICKS       500
+#define IO_PERIOD        3
+#define FAIR_TOLERANCE   10	/* percent */
+
+/* priorities of the I/O and background tasks, as set in prj.mdef */
+#define IO_PRIO          10
+#define BG_PRIO          12
+
+static volatile int stop;
+static volatile uint32_t bgIterations[2];
+static uint32_t ioWakeups;
+static int32_t ioLateMax;
+static volatile uint32_t idlePeerGapMax;
+
+/**
+ *
+ * @brief Spin for a number of hardware clock cycles
+ *
+ * @param cycles  number of cycles
+ *
+ * @return N/A
+ */
+
+static void busyWait(uint32_t cycles)
+{
+	uint32_t start = sys_cycle_get_32();
+
+	while ((sys_cycle_get_32() - start) < cycles) {
+	}
+}
+
+/**
+ *
+ * @brief I/O task
+ *
+ * This routine wakes up every IO_PERIOD ticks and runs for half a tick,
+ * recording how late it wakes up.
+ *
+ * @return N/A
+ */
+
+void IoTask(void)
+{
+	int32_t next;
+	int32_t delay;
+	int32_t late;
+
+	task_sem_take(IO_SEM, TICKS_UNLIMITED);
+
+	next = sys_tick_get_32();
+	while (!stop) {
+		next += IO_PERIOD;
+		delay = next - sys_tick_get_32();
+		if (delay > 0) {
+			task_sleep(delay);
+		}
+
+		late = sys_tick_get_32() - next;
+		if (late > ioLateMax) {
+			ioLateMax = late;
+		}
+		ioWakeups++;
+
+		busyWait(sys_clock_hw_cycles_per_tick / 2);
+	}
+
+	task_sem_give(DONE_SEM);
+}
+
+/**
+ *
+ * @brief Background task
+ *
+ * This routine spins, counting its iterations, until the test stops it.
+ *
+ * @return N/A
+ */
+
+void BackgroundTask(void)
+{
+	int i = (task_id_get() == BGTASK1) ? 0 : 1;
+
+	task_sem_take(BG_SEM, TICKS_UNLIMITED);
+
+	while (!stop) {
+		bgIterations[i]++;
+	}
+
+	task_sem_give(DONE_SEM);
+}
+
+/**
+ *
+ * @brief Task sharing the priority level of the idle task
+ *
+ * This routine spins until the test stops it, recording the longest time it
+ * was switched out.
+ *
+ * @return N/A
+ */
+
+void IdlePeerTask(void)
+{
+	uint32_t last;
+	uint32_t now;
+
+	task_sem_take(IDLE_PEER_SEM, TICKS_UNLIMITED);
+
+	last = sys_tick_get_32();
+	while (!stop) {
+		now = sys_tick_get_32();
+		if (now - last > idlePeerGapMax) {
+			idlePeerGapMax = now - last;
+		}
+		last = now;
+	}
+
+	task_sem_give(DONE_SEM);
+}
+
+/**
+ *
+ * @brief Check the CPU shares of the background tasks and the I/O task
+ *
+ * @return TC_PASS on success, TC_FAIL on failure
+ */
+
+static int fairSharesCheck(void)
+{
+	uint32_t high = max(bgIterations[0], bgIterations[1]);
+	uint32_t low = min(bgIterations[0], bgIterations[1]);
+
+	TC_PRINT("Background task iterations: %u and %u\n",
+		 bgIterations[0], bgIterations[1]);
+
+	if ((low == 0) ||
+	    ((uint64_t)(high - low) * 100 > (uint64_t)high * FAIR_TOLERANCE)) {
+		TC_ERROR("Background tasks shares differ by more than %d%%\n",
+			 FAIR_TOLERANCE);
+		return TC_FAIL;
+	}
+
+	TC_PRINT("I/O task woke up %u times, at most %d ticks late\n",
+		 ioWakeups, ioLateMax);
+
+	if ((ioWakeups < TEST_TICKS / IO_PERIOD - 1) || (ioLateMax > 1)) {
+		TC_ERROR("I/O task starved by the background tasks\n");
+		return TC_FAIL;
+	}
+
+	return TC_PASS;
+}
+
+/**
+ *
+ * @brief Wait for test tasks to stop
+ *
+ * @param count  number of tasks to wait for
+ *
+ * @return TC_PASS on success, TC_FAIL on failure
+ */
+
+static int tasksStop(int count)
+{
+	stop = 1;
+
+	while (count--) {
+		if (task_sem_take(DONE_SEM, TEST_TICKS) != RC_OK) {
+			TC_ERROR("Timed out waiting for a task to stop\n");
+			return TC_FAIL;
+		}
+	}
+
+	stop = 0;
+	return TC_PASS;
+}
+
+/**
+ *
+ * @brief Regression task
+ *
+ * This routine configures time slicing, and runs the test tasks.
+ *
+ * @return N/A
+ */
+
+void RegressionTask(void)
+{
+	int rv;
+
+	TC_START("Test Microkernel Time Slicing");
+
+	/* slice the background levels only */
+	sys_scheduler_time_slice_prio_set(task_priority_get(), 0);
+	sys_scheduler_time_slice_prio_set(IO_PRIO, 0);
+	sys_scheduler_time_slice_prio_set(BG_PRIO, SLICE_TICKS);
+	sys_scheduler_time_slice_prio_set(CONFIG_NUM_TASK_PRIORITIES - 1,
+					  SLICE_TICKS);
+
+	TC_PRINT("Testing fair shares of equal priority tasks\n");
+
+	task_sem_give(IO_SEM);
+	task_sem_give(BG_SEM);
+	task_sem_give(BG_SEM);
+
+	task_sleep(TEST_TICKS);
+
+	rv = tasksStop(3);
+	if (rv == TC_PASS) {
+		rv = fairSharesCheck();
+	}
+	if (rv != TC_PASS) {
+		goto done;
+	}
+
+	TC_PRINT("Testing time slices of the idle task\n");
+
+	task_sem_give(IDLE_PEER_SEM);
+
+	task_sleep(TEST_TICKS);
+
+	rv = tasksStop(1);
+	if (rv != TC_PASS) {
+		goto done;
+	}
+
+	TC_PRINT("Task sharing the idle level switched out for at most "
+		 "%u ticks\n", idlePeerGapMax);
+
+	if (idlePeerGapMax > SLICE_TICKS + 1) {
+		TC_ERROR("Task sharing the idle level starved by the idle task\n");
+		rv = TC_FAIL;
+	}
+
+done:
+	TC_END_RESULT(rv);
+	TC_END_REPORT(rv);
+}
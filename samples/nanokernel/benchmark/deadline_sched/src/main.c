@@ -0,0 +1,215 @@
+/* main.c - fiber deadline scheduling benchmark */
+
+/*
+ * Copyright (c) 2016 Wind River Systems, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * DESCRIPTION
+ * This benchmark runs a set of periodic fibers whose total utilization
+ * exceeds the CPU capacity, and counts the jobs that complete after their
+ * deadline, which is the end of their period. The fibers are scheduled by
+ * earliest deadline first when CONFIG_NANO_FIBER_EDF is enabled, and by fixed
+ * rate-monotonic priorities otherwise.
+ *
+ * Since fibers are not preemptible, each job is executed as a series of
+ * short busy waits separated by yields, which gives the scheduler a chance to
+ * switch to a more urgent fiber.
+ */
+
+#include <zephyr.h>
+#include <stdio.h>
+#include <misc/util.h>
+
+#define STACKSIZE 1024
+
+/* duration of the benchmark */
+#define TEST_TICKS 1000
+
+/* number of scheduling points per tick of execution */
+#define SLICES_PER_TICK 4
+
+#ifdef CONFIG_NANO_FIBER_EDF
+#define SCHED_NAME "earliest deadline first"
+#else
+#define SCHED_NAME "fixed priority (rate monotonic)"
+#endif
+
+struct periodic {
+	int32_t period;		/* period and deadline, in ticks */
+	int32_t exec;		/* execution time of a job, in ticks */
+	unsigned int prio;	/* rate-monotonic priority */
+	int jobs;
+	int missed;
+};
+
+/* total utilization is 110% */
+static struct periodic fibers[] = {
+	{ 10, 3, 5, 0, 0 },
+	{ 15, 4, 6, 0, 0 },
+	{ 20, 6, 7, 0, 0 },
+	{ 30, 7, 8, 0, 0 },
+};
+
+static char __stack stacks[ARRAY_SIZE(fibers)][STACKSIZE];
+
+static struct nano_sem done_sem;
+
+static uint32_t end_tick;
+
+/**
+ *
+ * @brief Execute one job of a periodic fiber
+ *
+ * @param p periodic fiber
+ *
+ * @return N/A
+ */
+static void job_execute(struct periodic *p)
+{
+	int i;
+
+	for (i = 0; i < p->exec * SLICES_PER_TICK; i++) {
+		sys_thread_busy_wait(sys_clock_us_per_tick / SLICES_PER_TICK);
+		fiber_yield();
+	}
+}
+
+#ifdef CONFIG_NANO_FIBER_EDF
+
+/**
+ *
+ * @brief Periodic fiber scheduled by earliest deadline first
+ *
+ * @param arg1 periodic fiber descriptor
+ * @param arg2 unused
+ *
+ * @return N/A
+ */
+static void periodic_fiber(int arg1, int arg2)
+{
+	struct periodic *p = (struct periodic *)arg1;
+	uint32_t release = sys_tick_get_32();
+
+	ARG_UNUSED(arg2);
+
+	fiber_deadline_set(p->period, p->period);
+
+	while ((int32_t)(release - end_tick) < 0) {
+		job_execute(p);
+		p->missed += fiber_period_wait();
+		p->jobs++;
+		release += p->period;
+	}
+
+	nano_fiber_sem_give(&done_sem);
+}
+
+#else
+
+/**
+ *
+ * @brief Periodic fiber scheduled by fixed priority
+ *
+ * @param arg1 periodic fiber descriptor
+ * @param arg2 unused
+ *
+ * @return N/A
+ */
+static void periodic_fiber(int arg1, int arg2)
+{
+	struct periodic *p = (struct periodic *)arg1;
+	uint32_t release = sys_tick_get_32();
+	int32_t delay;
+
+	ARG_UNUSED(arg2);
+
+	while ((int32_t)(release - end_tick) < 0) {
+		job_execute(p);
+		if ((int32_t)(sys_tick_get_32() - (release + p->period)) > 0) {
+			p->missed++;
+		}
+		p->jobs++;
+		release += p->period;
+
+		delay = (int32_t)(release - sys_tick_get_32());
+		if (delay > 0) {
+			fiber_sleep(delay);
+		}
+	}
+
+	nano_fiber_sem_give(&done_sem);
+}
+
+#endif /* CONFIG_NANO_FIBER_EDF */
+
+/**
+ *
+ * @brief Print dash line
+ *
+ * @return N/A
+ */
+static void print_dash_line(void)
+{
+	printf("|-----------------------------------------------------------------"
+		   "------------|\n");
+}
+
+void main(void)
+{
+	int total_jobs = 0;
+	int total_missed = 0;
+	int i;
+
+	nano_sem_init(&done_sem);
+
+	print_dash_line();
+	printf("|                  Nanokernel Deadline Scheduling Benchmark     "
+		   "              |\n");
+	print_dash_line();
+	printf("|  scheduling: %-63s|\n", SCHED_NAME);
+	printf("|  duration: %-5d ticks, utilization: 110%%"
+		   "                                   |\n", TEST_TICKS);
+	print_dash_line();
+	printf("| period (ticks) | execution (ticks) | jobs       | missed deadlines"
+		   "          |\n");
+	print_dash_line();
+
+	end_tick = sys_tick_get_32() + TEST_TICKS;
+
+	for (i = 0; i < ARRAY_SIZE(fibers); i++) {
+		task_fiber_start(stacks[i], STACKSIZE, periodic_fiber,
+						 (int)&fibers[i], 0, fibers[i].prio, 0);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(fibers); i++) {
+		nano_task_sem_take(&done_sem, TICKS_UNLIMITED);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(fibers); i++) {
+		printf("| %14d | %17d | %10d | %25d |\n", fibers[i].period,
+			   fibers[i].exec, fibers[i].jobs, fibers[i].missed);
+		total_jobs += fibers[i].jobs;
+		total_missed += fibers[i].missed;
+	}
+
+	print_dash_line();
+	printf("| total          |                   | %10d | %25d |\n",
+		   total_jobs, total_missed);
+	print_dash_line();
+	printf("|                                    E N D                       "
+		   "             |\n");
+	print_dash_line();
+}
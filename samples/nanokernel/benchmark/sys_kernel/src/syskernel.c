@@ -187,10 +187,14 @@ void main(void)
 		test_result += lifo_test();
 		test_result += fifo_test();
 		test_result += stack_test();
+		test_result += yield_test();
 
 		if (test_result) {
-			/* sema, lifo, fifo, stack account for twelve tests in total */
-			if (test_result == 12) {
+			/*
+			 * sema, lifo, fifo, stack and yield account for sixteen
+			 * tests in total
+			 */
+			if (test_result == 16) {
 				fprintf(output_file, sz_module_result_fmt, sz_success);
 			} else {
 				fprintf(output_file, sz_module_result_fmt, sz_partial);
@@ -0,0 +1,124 @@
+/* yield.c */
+
+/*
+ * Copyright (c) 2016 Wind River Systems, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "syskernel.h"
+
+#include <misc/util.h>
+
+/*
+ * Each yield reinserts the yielding fiber behind all the other runnable
+ * fibers of the same priority, which is the worst case for a ready queue
+ * kept as a sorted list. The test is repeated with a growing number of
+ * runnable fibers, the total number of yields being NUMBER_OF_LOOPS.
+ */
+
+#define YIELD_MAX_FIBERS 40
+#define YIELD_STACK_SIZE 512
+
+#ifdef CONFIG_NANO_FIBER_PRIO_QUEUES
+#define READY_QUEUE_NAME "multi-level ready queue"
+#else
+#define READY_QUEUE_NAME "sorted ready list"
+#endif
+
+static char __stack yield_stacks[YIELD_MAX_FIBERS][YIELD_STACK_SIZE];
+
+static const int yield_num_fibers[] = { 2, 10, 20, YIELD_MAX_FIBERS };
+
+/**
+ *
+ * @brief Yield test fiber
+ *
+ * @param par1   Address of the counter.
+ * @param par2   Number of test cycles.
+ *
+ * @return N/A
+ */
+void yield_fiber(int par1, int par2)
+{
+	int i;
+	int * pcounter = (int *) par1;
+
+	for (i = 0; i < par2; i++) {
+		fiber_yield();
+		(*pcounter)++;
+	}
+}
+
+
+/**
+ *
+ * @brief Fiber that makes the yield test fibers runnable
+ *
+ * Starting the test fibers from a fiber queues them all before any of them
+ * gets to run.
+ *
+ * @param par1   Address of the counter.
+ * @param par2   Number of test fibers.
+ *
+ * @return N/A
+ */
+void yield_starter(int par1, int par2)
+{
+	int i;
+
+	for (i = 0; i < par2; i++) {
+		fiber_fiber_start(yield_stacks[i], YIELD_STACK_SIZE, yield_fiber,
+						  par1, NUMBER_OF_LOOPS / par2, 4, 0);
+	}
+}
+
+
+/**
+ *
+ * @brief The main test entry
+ *
+ * @return number of successful test cases
+ */
+int yield_test(void)
+{
+	uint32_t t;
+	int i;
+	int j;
+	int return_value = 0;
+	char sz_title[32];
+
+	for (j = 0; j < ARRAY_SIZE(yield_num_fibers); j++) {
+		sprintf(sz_title, "Yield #%d (%d fibers)", j + 1,
+				yield_num_fibers[j]);
+		fprintf(output_file, sz_test_case_fmt, sz_title);
+		fprintf(output_file, sz_description,
+				"\n\tfiber_fiber_start"
+				"\n\tfiber_yield"
+				"\n\t" READY_QUEUE_NAME);
+		printf(sz_test_start_fmt);
+
+		i = 0;
+
+		t = BENCH_START();
+
+		task_fiber_start(fiber_stack1, STACK_SIZE, yield_starter, (int) &i,
+						 yield_num_fibers[j], 3, 0);
+
+		t = TIME_STAMP_DELTA_GET(t);
+
+		return_value += check_result(i, t);
+	}
+
+	return return_value;
+}
@@ -0,0 +1,273 @@
+/* main.c - nanokernel timer scalability benchmark */
+
+/*
+ * Copyright (c) 2016 Wind River Systems, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * DESCRIPTION
+ * This benchmark measures the cost of starting and stopping a nanokernel
+ * timer, and the time taken by the tick interrupt with and without timers
+ * expiring, while a growing number of other timers are running, for the
+ * timer queue selected by the project configuration.
+ */
+
+#include <zephyr.h>
+#include <stdio.h>
+#include <misc/util.h>
+
+#include "timestamp.h"
+
+#define MAX_TIMERS 10000
+#define NUM_PROBES 100
+
+/* timers expiring on the same tick, and number of such ticks measured */
+#define NUM_EXPIRING 10
+#define NUM_ROUNDS 10
+
+/*
+ * The timers are started far enough in the future that none of them expires
+ * while the benchmark is running, so their user data is never used.
+ */
+#define TIMER_MIN_TICKS 100000
+#define TIMER_RANGE_TICKS 100000
+
+#ifdef CONFIG_NANO_TIMEOUT_WHEEL
+#define TIMER_QUEUE_NAME "timing wheel"
+#else
+#define TIMER_QUEUE_NAME "delta list"
+#endif
+
+uint32_t tm_off; /* time necessary to read the time */
+
+static struct nano_timer timers[MAX_TIMERS];
+static struct nano_timer probe;
+static struct nano_timer expiring[NUM_EXPIRING];
+
+/* user data of the expiring timers, which is linked through its first word */
+static void *expiring_data[NUM_EXPIRING][1];
+
+static const int num_timers[] = { 10, 100, 1000, MAX_TIMERS };
+
+static uint32_t seed = 1;
+
+/**
+ *
+ * @brief Generate a pseudo-random timer duration
+ *
+ * @return duration in ticks
+ */
+static int random_ticks(void)
+{
+	seed = seed * 1103515245 + 12345;
+
+	return TIMER_MIN_TICKS + (int)((seed >> 8) % TIMER_RANGE_TICKS);
+}
+
+/**
+ *
+ * @brief Print dash line
+ *
+ * @return N/A
+ */
+static void print_dash_line(void)
+{
+	printf("|-----------------------------------------------------------------"
+		   "------------|\n");
+}
+
+/**
+ *
+ * @brief Start a number of timers that do not expire during the benchmark
+ *
+ * @param n number of timers
+ *
+ * @return N/A
+ */
+static void timers_start(int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++) {
+		nano_timer_init(&timers[i], NULL);
+		nano_task_timer_start(&timers[i], random_ticks());
+	}
+}
+
+/**
+ *
+ * @brief Stop the timers started by timers_start()
+ *
+ * @param n number of timers
+ *
+ * @return N/A
+ */
+static void timers_stop(int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++) {
+		nano_task_timer_stop(&timers[i]);
+	}
+}
+
+/**
+ *
+ * @brief Measure timer start and stop with a number of running timers
+ *
+ * @param n number of running timers
+ *
+ * @return N/A
+ */
+static void timer_scaling_test(int n)
+{
+	uint32_t start_time = 0;
+	uint32_t stop_time = 0;
+	uint32_t t;
+	int i;
+
+	timers_start(n);
+
+	nano_timer_init(&probe, NULL);
+
+	for (i = 0; i < NUM_PROBES; i++) {
+		int ticks = random_ticks();
+
+		t = TIME_STAMP_DELTA_GET(0);
+		nano_task_timer_start(&probe, ticks);
+		start_time += TIME_STAMP_DELTA_GET(t);
+
+		t = TIME_STAMP_DELTA_GET(0);
+		nano_task_timer_stop(&probe);
+		stop_time += TIME_STAMP_DELTA_GET(t);
+	}
+
+	timers_stop(n);
+
+	printf("| %14d | %27lu | %28lu |\n", n,
+		   (unsigned long)(start_time / NUM_PROBES),
+		   (unsigned long)(stop_time / NUM_PROBES));
+}
+
+/**
+ *
+ * @brief Measure the time taken by the next tick interrupt
+ *
+ * The task polls the cycle counter until the next tick: the longest gap
+ * between two reads is the time taken by the tick interrupt, including the
+ * handling of the timers that expire on that tick.
+ *
+ * @return time taken by the tick interrupt, in timer clock cycles
+ */
+static uint32_t tick_time(void)
+{
+	uint32_t tick = sys_tick_get_32();
+	uint32_t prev = sys_cycle_get_32();
+	uint32_t gap = 0;
+	uint32_t now;
+
+	while (sys_tick_get_32() == tick) {
+		now = sys_cycle_get_32();
+		gap = max(gap, now - prev);
+		prev = now;
+	}
+
+	return gap;
+}
+
+/**
+ *
+ * @brief Measure timer expiry with a number of running timers
+ *
+ * @param n number of running timers
+ *
+ * @return N/A
+ */
+static void expiry_scaling_test(int n)
+{
+	uint32_t idle_time = 0;
+	uint32_t expiry_time = 0;
+	int round;
+	int i;
+
+	timers_start(n);
+
+	for (i = 0; i < NUM_EXPIRING; i++) {
+		nano_timer_init(&expiring[i], expiring_data[i]);
+	}
+
+	for (round = 0; round < NUM_ROUNDS; round++) {
+		/* a tick on which no timer expires */
+		TICK_SYNCH();
+		idle_time += tick_time();
+
+		/* a tick on which all the expiring timers expire */
+		TICK_SYNCH();
+		for (i = 0; i < NUM_EXPIRING; i++) {
+			nano_task_timer_start(&expiring[i], 1);
+		}
+		expiry_time += tick_time();
+
+		for (i = 0; i < NUM_EXPIRING; i++) {
+			if (!nano_task_timer_test(&expiring[i], TICKS_NONE)) {
+				printf("| timer %d did not expire on time\n", i);
+			}
+		}
+	}
+
+	timers_stop(n);
+
+	printf("| %14d | %27lu | %28lu |\n", n,
+		   (unsigned long)(idle_time / NUM_ROUNDS),
+		   (unsigned long)(expiry_time / NUM_ROUNDS));
+}
+
+void main(void)
+{
+	int i;
+
+	bench_test_init();
+
+	print_dash_line();
+	printf("|                    Nanokernel Timer Scalability Benchmark   "
+		   "                |\n");
+	print_dash_line();
+	printf("|  timer queue: %-62s|\n", TIMER_QUEUE_NAME);
+	printf("|  tcs = timer clock cycles: 1 tcs is %-5lu nsec"
+		   "                              |\n",
+		   (unsigned long)SYS_CLOCK_HW_CYCLES_TO_NS(1));
+	print_dash_line();
+	printf("| running timers | timer start (average tcs)   |"
+		   " timer stop (average tcs)     |\n");
+	print_dash_line();
+
+	for (i = 0; i < ARRAY_SIZE(num_timers); i++) {
+		timer_scaling_test(num_timers[i]);
+	}
+
+	print_dash_line();
+	printf("| running timers | tick, no expiry (avg tcs)   |"
+		   " tick, 10 expiries (avg tcs)  |\n");
+	print_dash_line();
+
+	for (i = 0; i < ARRAY_SIZE(num_timers); i++) {
+		expiry_scaling_test(num_timers[i]);
+	}
+
+	print_dash_line();
+	printf("|                                    E N D                       "
+		   "             |\n");
+	print_dash_line();
+}
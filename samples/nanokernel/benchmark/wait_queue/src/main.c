@@ -0,0 +1,208 @@
+/* main.c - wait queue ordering benchmark */
+
+/*
+ * Copyright (c) 2016 Wind River Systems, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * DESCRIPTION
+ * This benchmark measures how long the highest priority fiber waiting on a
+ * nanokernel object takes to wake up when lower priority fibers started
+ * waiting on the same object before it. The task then hands one buffer at a
+ * time to the object, each woken fiber spending some time processing it,
+ * until the highest priority fiber gets one.
+ *
+ * The waiters wake up in the order in which they started waiting by default,
+ * and in priority order when CONFIG_NANO_PRIO_WAIT_QUEUES is enabled.
+ */
+
+#include <zephyr.h>
+#include <stdio.h>
+#include <misc/util.h>
+
+#define STACKSIZE 1024
+
+#define NUM_ITERATIONS 100
+
+/* lower priority fibers that started waiting first */
+#define NUM_LOW_WAITERS 4
+#define LOW_PRIO 10
+#define HIGH_PRIO 5
+
+/* time spent by a woken lower priority fiber processing its buffer */
+#define LOW_WORK_US 100
+
+#ifdef CONFIG_NANO_PRIO_WAIT_QUEUES
+#define WAIT_Q_NAME "priority order"
+#else
+#define WAIT_Q_NAME "waiting order"
+#endif
+
+struct buffer {
+	void *link_in_fifo;
+	int data;
+};
+
+static char __stack low_stacks[NUM_LOW_WAITERS][STACKSIZE];
+static char __stack high_stack[STACKSIZE];
+
+static struct nano_sem buf_sem;
+static struct nano_fifo buf_fifo;
+static struct buffer buffers[NUM_LOW_WAITERS + 1];
+
+static uint32_t start_stamp;
+static int gives;
+
+/* results of the current iteration */
+static uint32_t wake_cycles;
+static int wake_gives;
+
+/* wait for a buffer on the FIFO if use_fifo is set, else on the semaphore */
+static void buffer_wait(int use_fifo)
+{
+	if (use_fifo) {
+		nano_fiber_fifo_get(&buf_fifo, TICKS_UNLIMITED);
+	} else {
+		nano_fiber_sem_take(&buf_sem, TICKS_UNLIMITED);
+	}
+}
+
+/**
+ *
+ * @brief Lower priority waiter, e.g. a logger
+ *
+ * @param arg1 non-zero to wait on the FIFO rather than the semaphore
+ * @param arg2 unused
+ *
+ * @return N/A
+ */
+static void low_fiber(int arg1, int arg2)
+{
+	ARG_UNUSED(arg2);
+
+	buffer_wait(arg1);
+	sys_thread_busy_wait(LOW_WORK_US);
+}
+
+/**
+ *
+ * @brief Highest priority waiter, e.g. a network RX fiber
+ *
+ * @param arg1 non-zero to wait on the FIFO rather than the semaphore
+ * @param arg2 unused
+ *
+ * @return N/A
+ */
+static void high_fiber(int arg1, int arg2)
+{
+	ARG_UNUSED(arg2);
+
+	buffer_wait(arg1);
+	wake_cycles = sys_cycle_get_32() - start_stamp;
+	wake_gives = gives;
+}
+
+/**
+ *
+ * @brief Measure the time to wake the highest priority waiter
+ *
+ * @param use_fifo non-zero to hand buffers through a FIFO rather than a
+ * semaphore
+ *
+ * @return N/A
+ */
+static void wait_queue_test(int use_fifo)
+{
+	uint32_t total_cycles = 0;
+	uint32_t max_cycles = 0;
+	int total_gives = 0;
+	int i;
+	int j;
+
+	for (i = 0; i < NUM_ITERATIONS; i++) {
+		nano_sem_init(&buf_sem);
+		nano_fifo_init(&buf_fifo);
+
+		/* fibers preempt the task and start waiting right away */
+		for (j = 0; j < NUM_LOW_WAITERS; j++) {
+			task_fiber_start(low_stacks[j], STACKSIZE, low_fiber,
+							 use_fifo, 0, LOW_PRIO, 0);
+		}
+		task_fiber_start(high_stack, STACKSIZE, high_fiber,
+						 use_fifo, 0, HIGH_PRIO, 0);
+
+		/* each buffer preempts the task to run the fiber it wakes up */
+		gives = 0;
+		start_stamp = sys_cycle_get_32();
+		for (j = 0; j < ARRAY_SIZE(buffers); j++) {
+			gives++;
+			if (use_fifo) {
+				nano_task_fifo_put(&buf_fifo, &buffers[j]);
+			} else {
+				nano_task_sem_give(&buf_sem);
+			}
+		}
+
+		total_cycles += wake_cycles;
+		max_cycles = max(max_cycles, wake_cycles);
+		total_gives += wake_gives;
+	}
+
+	printf("| %-9s | %18d.%02d | %19lu | %17lu |\n",
+		   use_fifo ? "fifo" : "semaphore",
+		   total_gives / NUM_ITERATIONS,
+		   (total_gives % NUM_ITERATIONS) * 100 / NUM_ITERATIONS,
+		   (unsigned long)SYS_CLOCK_HW_CYCLES_TO_NS(total_cycles /
+							  NUM_ITERATIONS) / 1000,
+		   (unsigned long)SYS_CLOCK_HW_CYCLES_TO_NS(max_cycles) / 1000);
+}
+
+/**
+ *
+ * @brief Print dash line
+ *
+ * @return N/A
+ */
+static void print_dash_line(void)
+{
+	printf("|-----------------------------------------------------------------"
+		   "------------|\n");
+}
+
+void main(void)
+{
+	print_dash_line();
+	printf("|                   Nanokernel Wait Queue Ordering Benchmark  "
+		   "                |\n");
+	print_dash_line();
+	printf("|  wake up order: %-61s|\n", WAIT_Q_NAME);
+	printf("|  waiters: %-2d of priority %-3d ahead of one of priority %-3d"
+		   "                   |\n", NUM_LOW_WAITERS, LOW_PRIO, HIGH_PRIO);
+	printf("|  work per buffer: %-5d usec"
+		   "                                                |\n",
+		   LOW_WORK_US);
+	print_dash_line();
+	printf("| object    | buffers until wake-up | time to wake (usec) |"
+		   " worst case (usec) |\n");
+	print_dash_line();
+
+	wait_queue_test(0);
+	wait_queue_test(1);
+
+	print_dash_line();
+	printf("|                                    E N D                       "
+		   "             |\n");
+	print_dash_line();
+}
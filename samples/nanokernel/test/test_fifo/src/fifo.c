@@ -24,6 +24,7 @@
  * nano_fiber_fifo_get, nano_fiber_fifo_put
  * nano_task_fifo_get, nano_task_fifo_put
  * nano_isr_fifo_get, nano_isr_fifo_put
+ * nano_task_fifo_put_list
  *
  * Scenario #1
  * Task enters items into a queue, starts the fiber and waits for a semaphore.
@@ -48,6 +49,11 @@
  *
  * Scenario #4:
  * Timeout scenarios with multiple FIFOs and fibers.
+ *
+ * Scenario #5:
+ * Task enters a list of items into a queue at once, first with no fiber
+ * waiting on the queue, then with a fiber waiting on it. The waiting fiber
+ * must get the first item, and the task must get the remaining ones.
  */
 
 #include <zephyr.h>
@@ -76,6 +82,7 @@ typedef struct {
 char __stack fiberStack1[FIBER_STACKSIZE];
 char __stack fiberStack2[FIBER_STACKSIZE];
 char __stack fiberStack3[FIBER_STACKSIZE];
+char __stack fiberStack4[FIBER_STACKSIZE];
 
 struct nano_fifo  nanoFifoObj;
 struct nano_fifo  nanoFifoObj2;
@@ -122,6 +129,7 @@ void fiber3(void);
 
 void initNanoObjects(void);
 void testTaskFifoGetW(void);
+void testTaskFifoPutList(void);
 
 extern int test_fifo_timeout(void);
 
@@ -552,6 +560,112 @@ void testTaskFifoGetW(void)
 	TC_END_RESULT(retCode);
 } /* testTaskFifoGetW */
 
+/**
+ *
+ * @brief Link the items of pPutList1 into a list
+ *
+ * @return N/A
+ */
+
+static void linkPutList(void)
+{
+	for (int i = 0; i < NUM_FIFO_ELEMENT - 1; i++) {
+		*(void **)pPutList1[i] = pPutList1[i + 1];
+	}
+}
+
+/**
+ *
+ * @brief Check that the queue holds the items of pPutList1, starting at @a first
+ *
+ * @return TC_PASS on success, TC_FAIL on failure
+ */
+
+static int checkPutList(int first)
+{
+	void *pData;
+
+	for (int i = first; i < NUM_FIFO_ELEMENT; i++) {
+		pData = nano_task_fifo_get(&nanoFifoObj, TICKS_NONE);
+		TC_PRINT("TASK FIFO Get: count = %d, ptr is %p\n", i, pData);
+		if (pData != pPutList1[i]) {
+			TCERR1(i);
+			return TC_FAIL;
+		}
+	}
+
+	if (nano_task_fifo_get(&nanoFifoObj, TICKS_NONE) != NULL) {
+		TCERR3;
+		return TC_FAIL;
+	}
+
+	return TC_PASS;
+}
+
+/**
+ *
+ * @brief Fiber waiting on the queue for the put list test
+ *
+ * The fiber takes a single item from the queue and hands it to the task.
+ *
+ * @return N/A
+ */
+
+static void fiber4(int arg1, int arg2)
+{
+	ARG_UNUSED(arg2);
+
+	*(void **)arg1 = nano_fiber_fifo_get(&nanoFifoObj, TICKS_UNLIMITED);
+	nano_fiber_sem_give(&nanoSemObjTask);
+}
+
+/**
+ *
+ * @brief Test putting a list of items into a FIFO from a task
+ *
+ * @return N/A
+ */
+
+void testTaskFifoPutList(void)
+{
+	void *pFiberData = INVALID_DATA;
+
+	PRINT_LINE;
+	TC_PRINT("Test Task FIFO Put List\n\n");
+
+	linkPutList();
+	nano_task_fifo_put_list(&nanoFifoObj, pPutList1[0],
+				pPutList1[NUM_FIFO_ELEMENT - 1]);
+
+	if (checkPutList(0) != TC_PASS) {
+		retCode = TC_FAIL;
+		return;
+	}
+
+	/* the fiber preempts the task and waits on the empty queue */
+	task_fiber_start(fiberStack4, FIBER_STACKSIZE, fiber4,
+					 (int)&pFiberData, 0, 7, 0);
+
+	linkPutList();
+	nano_task_fifo_put_list(&nanoFifoObj, pPutList1[0],
+				pPutList1[NUM_FIFO_ELEMENT - 1]);
+
+	nano_task_sem_take(&nanoSemObjTask, TICKS_UNLIMITED);
+	TC_PRINT("FIBER FIFO Get: ptr is %p\n", pFiberData);
+	if (pFiberData != pPutList1[0]) {
+		TCERR2;
+		retCode = TC_FAIL;
+		return;
+	}
+
+	if (checkPutList(1) != TC_PASS) {
+		retCode = TC_FAIL;
+		return;
+	}
+
+	TC_END_RESULT(retCode);
+} /* testTaskFifoPutList */
+
 /**
  *
  * @brief Initialize nanokernel objects
@@ -700,6 +814,12 @@ void main(void)
 	testIsrFifoFromTask();
 	PRINT_LINE;
 
+	testTaskFifoPutList();
+	if (retCode == TC_FAIL) {
+		goto exit;
+	}
+	PRINT_LINE;
+
 	/* test timeouts */
 	if (test_fifo_timeout() != TC_PASS) {
 		retCode = TC_FAIL;
@@ -25,6 +25,7 @@
  * nano_fiber_sem_give, nano_fiber_sem_take
  * nano_task_sem_give, nano_task_sem_take
  * nano_isr_sem_give, nano_isr_sem_take
+ * nano_task_sem_give_n
  *
  * Scenario #1:
  * A task, fiber or ISR does not wait for the semaphore when taking it.
@@ -33,7 +34,8 @@
  * A task or fiber must wait for the semaphore to be given before it gets it.
  *
  * Scenario #3:
- * Multiple fibers pend on the same semaphore.
+ * Multiple fibers pend on the same semaphore, and are woken up one at a time
+ * or all at once.
  *
  * Scenario #4:
  * Timeout scenarios with multiple semaphores and fibers.
@@ -474,6 +476,112 @@ static int do_test_multiple_waiters(void)
 	return TC_PASS;
 }
 
+/**
+ *
+ * @brief Wake up all the waiters with a single give operation
+ *
+ * NUM_WAITERS fibers pend on the multi_waiters semaphore, then the task gives
+ * the semaphore NUM_WAITERS + EXTRA_GIVES times at once. Each fiber must get
+ * the semaphore, and the semaphore must be left with a count of EXTRA_GIVES.
+ *
+ * @return TC_PASS on success, TC_FAIL on failure
+ */
+
+#define EXTRA_GIVES 2
+
+static int test_multiple_waiters_give_n(void)
+{
+	int ii;
+
+	for (ii = 0; ii < NUM_WAITERS; ii++) {
+		task_fiber_start(fiber_multi_waiters_stacks[ii], FIBER_STACKSIZE,
+							fiber_multi_waiters, ii, 0, FIBER_PRIORITY, 0);
+	}
+
+	/* wake up all the fibers: the task is preempted only once */
+	nano_task_sem_give_n(&multi_waiters, NUM_WAITERS + EXTRA_GIVES);
+
+	for (ii = 0; ii < NUM_WAITERS; ii++) {
+		if (!nano_task_sem_take(&reply_multi_waiters, TICKS_NONE)) {
+			TC_ERROR(" *** Cannot take sem supposedly given by waiters.\n");
+			return TC_FAIL;
+		}
+	}
+
+	for (ii = 0; ii < EXTRA_GIVES; ii++) {
+		if (!nano_task_sem_take(&multi_waiters, TICKS_NONE)) {
+			TC_ERROR(" *** multi_waiters should have been given.\n");
+			return TC_FAIL;
+		}
+	}
+
+	if (nano_task_sem_take(&multi_waiters, TICKS_NONE)) {
+		TC_ERROR(" *** multi_waiters should have been empty.\n");
+		return TC_FAIL;
+	}
+
+	TC_PRINT("Single give operation woke up %d waiters, as expected.\n",
+				NUM_WAITERS);
+
+	return TC_PASS;
+}
+
+#ifdef CONFIG_NANO_PRIO_WAIT_QUEUES
+
+/*
+ * Priority-ordered waiters test
+ *
+ * NUM_WAITERS fibers of different priorities pend on the multi_waiters
+ * semaphore, lowest priority first. Each time the task gives the semaphore,
+ * the highest priority fiber still waiting must wake up.
+ */
+static const int prio_waiters_prio[NUM_WAITERS] = {
+	FIBER_PRIORITY + 3, FIBER_PRIORITY + 1, FIBER_PRIORITY + 2
+};
+static int prio_waiters_woken[NUM_WAITERS];
+static int prio_waiters_count;
+
+static void fiber_prio_waiters(int arg1, int arg2)
+{
+	ARG_UNUSED(arg2);
+
+	nano_fiber_sem_take(&multi_waiters, TICKS_UNLIMITED);
+	prio_waiters_woken[prio_waiters_count++] = arg1;
+	nano_fiber_sem_give(&reply_multi_waiters);
+}
+
+static int test_prio_waiters(void)
+{
+	int ii;
+
+	prio_waiters_count = 0;
+
+	for (ii = 0; ii < NUM_WAITERS; ii++) {
+		task_fiber_start(fiber_multi_waiters_stacks[ii], FIBER_STACKSIZE,
+							fiber_prio_waiters, prio_waiters_prio[ii], 0,
+							prio_waiters_prio[ii], 0);
+	}
+
+	for (ii = 0; ii < NUM_WAITERS; ii++) {
+		nano_task_sem_give(&multi_waiters);
+		nano_task_sem_take(&reply_multi_waiters, TICKS_UNLIMITED);
+	}
+
+	for (ii = 0; ii < NUM_WAITERS; ii++) {
+		if (prio_waiters_woken[ii] != FIBER_PRIORITY + 1 + ii) {
+			TC_ERROR(" *** fiber of priority %d woke up, expected %d\n",
+						prio_waiters_woken[ii], FIBER_PRIORITY + 1 + ii);
+			return TC_FAIL;
+		}
+	}
+
+	TC_PRINT("Waiters woke up in priority order, as expected.\n");
+
+	return TC_PASS;
+}
+
+#endif /* CONFIG_NANO_PRIO_WAIT_QUEUES */
+
 /**
  *
  * @brief Entry point for multiple-waiters test
@@ -500,6 +608,18 @@ static int test_multiple_waiters(void)
 		return TC_FAIL;
 	}
 
+	TC_PRINT("Giving to all waiters at once\n");
+	if (test_multiple_waiters_give_n() == TC_FAIL) {
+		return TC_FAIL;
+	}
+
+#ifdef CONFIG_NANO_PRIO_WAIT_QUEUES
+	TC_PRINT("Waking up waiters of different priorities\n");
+	if (test_prio_waiters() == TC_FAIL) {
+		return TC_FAIL;
+	}
+#endif
+
 	return TC_PASS;
 }
 
@@ -22,7 +22,9 @@
  *  nano_timer_init(), nano_fiber_timer_start(), nano_fiber_timer_stop(),
  *  nano_fiber_timer_test(), nano_task_timer_start(),
  *  nano_task_timer_stop(), nano_task_timer_test(),
- *  sys_tick_get_32(), sys_cycle_get_32(), sys_tick_delta()
+ *  nano_timer_ticks_remain(),
+ *  sys_tick_get_32(), sys_cycle_get_32(), sys_tick_delta(),
+ *  sys_hrtimer_init(), sys_hrtimer_start(), sys_hrtimer_stop()
  */
 
 #include <tc_util.h>
@@ -446,6 +448,190 @@ int sys_cycle_get_32Test(void)
 	return TC_PASS;
 }
 
+/**
+ *
+ * @brief Test the nano_timer_ticks_remain() API
+ *
+ * A timer that is not running has no ticks remaining. A running timer has
+ * the ticks it was started with remaining, less those that have elapsed,
+ * and none once it has expired or been stopped.
+ *
+ * @return TC_PASS on success, TC_FAIL on failure
+ */
+
+int ticksRemainTest(void)
+{
+	int32_t  remaining;
+	int32_t  tick;
+
+	if (nano_timer_ticks_remain(&timer) != 0) {
+		TC_ERROR("Ticks remaining on a timer not running\n");
+		return TC_FAIL;
+	}
+
+	/* Start the timer at the beginning of a tick */
+	tick = sys_tick_get_32();
+	while (sys_tick_get_32() == tick) {
+	}
+
+	nano_task_timer_start(&timer, TWO_SECONDS);
+	remaining = nano_timer_ticks_remain(&timer);
+	if ((remaining < TWO_SECONDS - 1) || (remaining > TWO_SECONDS)) {
+		TC_ERROR("%d ticks remaining on a timer just started for %d\n",
+			 remaining, TWO_SECONDS);
+		return TC_FAIL;
+	}
+
+	tick = sys_tick_get_32();
+	while ((int32_t)(sys_tick_get_32() - tick) < SHORT_TIMEOUT) {
+	}
+
+	remaining = nano_timer_ticks_remain(&timer);
+	if ((remaining < TWO_SECONDS - SHORT_TIMEOUT - 2) ||
+	    (remaining > TWO_SECONDS - SHORT_TIMEOUT)) {
+		TC_ERROR("%d ticks remaining %d ticks into a timer of %d\n",
+			 remaining, SHORT_TIMEOUT, TWO_SECONDS);
+		return TC_FAIL;
+	}
+
+	nano_task_timer_stop(&timer);
+	if (nano_timer_ticks_remain(&timer) != 0) {
+		TC_ERROR("Ticks remaining on a stopped timer\n");
+		return TC_FAIL;
+	}
+	nano_task_timer_start(&timer, 1);
+	if (nano_task_timer_test(&timer, TICKS_UNLIMITED) != timerData) {
+		TC_ERROR("Timer did not expire\n");
+		return TC_FAIL;
+	}
+	if (nano_timer_ticks_remain(&timer) != 0) {
+		TC_ERROR("Ticks remaining on an expired timer\n");
+		return TC_FAIL;
+	}
+
+	return TC_PASS;
+}
+
+#ifdef CONFIG_SYS_HRTIMER
+
+#define NUM_HRTIMERS       3
+#define HRTIMER_PERIODS    5
+
+static struct sys_hrtimer hrTimers[NUM_HRTIMERS];
+static struct sys_hrtimer hrStoppedTimer;
+static struct sys_hrtimer hrPeriodicTimer;
+static uint32_t hrExpiry[NUM_HRTIMERS];
+static uint32_t hrStamp[NUM_HRTIMERS];
+static int hrOrder[NUM_HRTIMERS];
+static int hrCount;
+static int hrStoppedFired;
+static int hrPeriods;
+static uint32_t hrPeriod;
+
+static void hrTimerExpire(struct sys_hrtimer *hrTimer)
+{
+	int i = hrTimer - hrTimers;
+
+	hrStamp[i] = sys_cycle_get_32();
+	hrOrder[hrCount++] = i;
+
+	if (hrCount == NUM_HRTIMERS) {
+		nano_isr_sem_give(&wakeTask);
+	}
+}
+
+static void hrStoppedTimerExpire(struct sys_hrtimer *hrTimer)
+{
+	ARG_UNUSED(hrTimer);
+
+	hrStoppedFired = 1;
+}
+
+static void hrPeriodicTimerExpire(struct sys_hrtimer *hrTimer)
+{
+	if (++hrPeriods < HRTIMER_PERIODS) {
+		sys_hrtimer_start(hrTimer, hrPeriod);
+	} else {
+		nano_isr_sem_give(&wakeTask);
+	}
+}
+
+/**
+ *
+ * @brief Test the high resolution timers
+ *
+ * This routine starts timers expiring a fraction of a tick apart, in reverse
+ * order of expiry, along with a timer that is stopped before it expires. It
+ * checks that the timers expire in order, not before their deadline, and
+ * that the stopped timer does not expire. It then checks that a timer can
+ * be restarted from its expiry function.
+ *
+ * @return TC_PASS on success, TC_FAIL on failure
+ */
+
+int hrTimerTest(void)
+{
+	uint32_t step = sys_clock_hw_cycles_per_tick / 4;
+	uint32_t now;
+	int i;
+
+	for (i = 0; i < NUM_HRTIMERS; i++) {
+		sys_hrtimer_init(&hrTimers[i], hrTimerExpire);
+	}
+	sys_hrtimer_init(&hrStoppedTimer, hrStoppedTimerExpire);
+	sys_hrtimer_init(&hrPeriodicTimer, hrPeriodicTimerExpire);
+
+	now = sys_cycle_get_32();
+	sys_hrtimer_start(&hrStoppedTimer, step);
+	for (i = NUM_HRTIMERS - 1; i >= 0; i--) {
+		hrExpiry[i] = now + (i + 1) * step;
+		sys_hrtimer_start(&hrTimers[i],
+				  hrExpiry[i] - sys_cycle_get_32());
+	}
+	sys_hrtimer_stop(&hrStoppedTimer);
+
+	if (!sys_hrtimer_is_running(&hrTimers[0]) ||
+	    sys_hrtimer_is_running(&hrStoppedTimer)) {
+		TC_ERROR("High resolution timer running state is wrong\n");
+		return TC_FAIL;
+	}
+
+	if (nano_task_sem_take(&wakeTask, SIX_SECONDS) != 1) {
+		TC_ERROR("High resolution timers did not expire\n");
+		return TC_FAIL;
+	}
+
+	for (i = 0; i < NUM_HRTIMERS; i++) {
+		if (hrOrder[i] != i) {
+			TC_ERROR("High resolution timer %d expired out of order\n",
+				 hrOrder[i]);
+			return TC_FAIL;
+		}
+
+		if ((int32_t)(hrStamp[i] - hrExpiry[i]) < 0) {
+			TC_ERROR("High resolution timer %d expired early\n", i);
+			return TC_FAIL;
+		}
+	}
+
+	if (hrStoppedFired) {
+		TC_ERROR("Stopped high resolution timer expired\n");
+		return TC_FAIL;
+	}
+
+	hrPeriod = step;
+	sys_hrtimer_start(&hrPeriodicTimer, hrPeriod);
+
+	if (nano_task_sem_take(&wakeTask, SIX_SECONDS) != 1) {
+		TC_ERROR("Restarted high resolution timer did not expire\n");
+		return TC_FAIL;
+	}
+
+	return TC_PASS;
+}
+
+#endif /* CONFIG_SYS_HRTIMER */
+
 /**
  *
  * @brief Entry point to timer tests
@@ -489,6 +675,13 @@ void main(void)
 		goto doneTests;
 	}
 
+	TC_PRINT("Task testing the ticks remaining on a timer\n");
+	rv = ticksRemainTest();
+	if (rv != TC_PASS) {
+		TC_ERROR("Task-level timer ticks remaining test failed\n");
+		goto doneTests;
+	}
+
 	/*
 	 * Start the fiber.  The fiber will be given a higher priority than the
 	 * main task.
@@ -540,6 +733,15 @@ void main(void)
 
 	nano_task_sem_take(&wakeTask, TICKS_UNLIMITED);
 
+#ifdef CONFIG_SYS_HRTIMER
+	TC_PRINT("Task testing high resolution timers\n");
+	rv = hrTimerTest();
+	if (rv != TC_PASS) {
+		TC_ERROR("High resolution timer test failed\n");
+		goto doneTests;
+	}
+#endif
+
 #if 0
 	/*
 	 * Due to recent changes in the i8253 file that correct an issue on real
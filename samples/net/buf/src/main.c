@@ -18,6 +18,7 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include <string.h>
 #include <misc/printk.h>
 
 #include <net/buf.h>
@@ -49,6 +50,105 @@ static void buf_destroy(struct net_buf *buf)
 static NET_BUF_POOL(bufs_pool, 22, 74, &bufs_fifo, buf_destroy,
 		    sizeof(struct bt_data));
 
+static struct nano_fifo frags_fifo;
+
+static NET_BUF_POOL(frags_pool, 13, 16, &frags_fifo, NULL, 0);
+
+static const char example_data[] = "0123456789"
+				   "abcdefghijklmnopqrstuvxyz"
+				   "!#%&/()=?";
+
+static int frags_free_count(void)
+{
+	struct net_buf *bufs[ARRAY_SIZE(frags_pool)];
+	int count = 0;
+	int i;
+
+	while (count < ARRAY_SIZE(frags_pool)) {
+		bufs[count] = nano_fifo_get(&frags_fifo, TICKS_NONE);
+		if (!bufs[count]) {
+			break;
+		}
+		count++;
+	}
+
+	for (i = 0; i < count; i++) {
+		nano_fifo_put(&frags_fifo, bufs[i]);
+	}
+
+	return count;
+}
+
+static int frags_test(void)
+{
+	struct net_buf *head, *frag;
+	uint8_t data[sizeof(example_data) + 8];
+	size_t len;
+
+	net_buf_pool_init(frags_pool);
+
+	head = net_buf_get(&frags_fifo, 0);
+	len = net_buf_frags_add_mem(head, &frags_fifo, example_data,
+				    sizeof(example_data));
+	if (len != sizeof(example_data) ||
+	    net_buf_frags_len(head) != sizeof(example_data)) {
+		printk("Failed to add data to a fragment chain\n");
+		return -1;
+	}
+
+	if (frags_free_count() !=
+	    ARRAY_SIZE(frags_pool) - ROUND_UP(sizeof(example_data), 16) / 16) {
+		printk("Unexpected number of fragments in the chain\n");
+		return -1;
+	}
+
+	/* no headroom: the header goes to a new fragment in front */
+	frag = net_buf_frags_push(head, &frags_fifo, 8);
+	if (!frag || frag == head || frag->frags != head) {
+		printk("Failed to push data to a fragment chain\n");
+		return -1;
+	}
+	head = frag;
+	memset(head->data, 0xaa, 8);
+
+	len = net_buf_linearize(data, sizeof(data), head, 0, sizeof(data));
+	if (len != sizeof(data) || data[7] != 0xaa ||
+	    memcmp(&data[8], example_data, sizeof(example_data))) {
+		printk("Failed to linearize a fragment chain\n");
+		return -1;
+	}
+
+	/* the emptied fragments after the head leave the chain */
+	net_buf_frags_pull(head, 8 + 20);
+	if (net_buf_frags_len(head) != sizeof(example_data) - 20 ||
+	    head->frags->data[0] != example_data[20]) {
+		printk("Failed to pull data from a fragment chain\n");
+		return -1;
+	}
+
+	len = net_buf_linearize(data, sizeof(data), head, 4, 3);
+	if (len != 3 || memcmp(data, &example_data[24], 3)) {
+		printk("Failed to linearize part of a fragment chain\n");
+		return -1;
+	}
+
+	/* a fragment referenced by another chain outlives the first one */
+	frag = net_buf_ref(net_buf_frag_last(head));
+	net_buf_unref(head);
+	if (frags_free_count() != ARRAY_SIZE(frags_pool) - 1) {
+		printk("Fragment chain not freed\n");
+		return -1;
+	}
+
+	net_buf_unref(frag);
+	if (frags_free_count() != ARRAY_SIZE(frags_pool)) {
+		printk("Shared fragment not freed\n");
+		return -1;
+	}
+
+	return 0;
+}
+
 #ifdef CONFIG_MICROKERNEL
 void mainloop(void)
 #else
@@ -85,5 +185,9 @@ void main(void)
 		return;
 	}
 
+	if (frags_test()) {
+		return;
+	}
+
 	printk("Buffer tests passed\n");
 }
@@ -0,0 +1,194 @@
+/* main.c - IPv6 route lookup scalability benchmark */
+
+/*
+ * Copyright (c) 2016 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * DESCRIPTION
+ * This benchmark measures the time the uIP stack takes to find the route to
+ * a destination while the routing table holds a growing number of routes,
+ * for the route lookup selected by the project configuration.
+ *
+ * Every route is a /64 prefix through the same neighbor, and the lookups go
+ * to destinations in each of these prefixes in turn.
+ */
+
+#include <zephyr.h>
+#include <stdio.h>
+#include <string.h>
+#include <misc/util.h>
+
+#include <net/net_core.h>
+
+#include <contiki/ip/uip.h>
+#include <contiki/ipv6/uip-ds6.h>
+#include <contiki/ipv6/uip-ds6-nbr.h>
+#include <contiki/ipv6/uip-ds6-route.h>
+
+#include "timestamp.h"
+
+#define MAX_ROUTES 1000
+#define NUM_PROBES 1000
+
+#define STACKSIZE 2000
+
+#ifdef CONFIG_NET_ROUTE_TRIE
+#define LOOKUP_NAME "prefix trie"
+#else
+#define LOOKUP_NAME "linear scan"
+#endif
+
+uint32_t tm_off; /* time necessary to read the time */
+
+static char __stack fiber_stack[STACKSIZE];
+
+static int num_routes;
+
+static const int route_counts[] = { 1, 10, 100, MAX_ROUTES };
+
+static uip_ipaddr_t nexthop;
+
+/**
+ *
+ * @brief Print dash line
+ *
+ * @return N/A
+ */
+static void print_dash_line(void)
+{
+	printf("|-----------------------------------------------------------------"
+		   "------------|\n");
+}
+
+/**
+ *
+ * @brief Set an address in the prefix of a route
+ *
+ * @param addr address to set
+ * @param route index of the route, whose prefix is 2001:db8:0:<route>::/64
+ * @param host interface identifier
+ *
+ * @return N/A
+ */
+static void route_addr_set(uip_ipaddr_t *addr, int route, uint16_t host)
+{
+	uip_ip6addr(addr, 0x2001, 0xdb8, 0, route, 0, 0, 0, host);
+}
+
+/**
+ *
+ * @brief Measure route lookups with a number of routes
+ *
+ * @param n number of routes
+ *
+ * @return N/A
+ */
+static void route_scaling_test(int n)
+{
+	uip_ds6_route_t *route;
+	uip_ipaddr_t prefix;
+	uip_ipaddr_t dest;
+	uint32_t lookup_time = 0;
+	uint32_t t;
+	uint32_t ns;
+	int missed = 0;
+	int i;
+
+	for (; num_routes < n; num_routes++) {
+		route_addr_set(&prefix, num_routes, 0);
+		if (!uip_ds6_route_add(&prefix, 64, &nexthop)) {
+			printf("Failed to add route %d\n", num_routes);
+			return;
+		}
+	}
+
+	for (i = 0; i < NUM_PROBES; i++) {
+		route_addr_set(&dest, i % n, 1);
+
+		t = TIME_STAMP_DELTA_GET(0);
+		route = uip_ds6_route_lookup(&dest);
+		lookup_time += TIME_STAMP_DELTA_GET(t);
+
+		if (!route || route->ipaddr.u16[3] != dest.u16[3]) {
+			missed++;
+		}
+	}
+
+	if (missed) {
+		printf("%d destinations not matched to their route\n", missed);
+	}
+
+	lookup_time /= NUM_PROBES;
+	ns = SYS_CLOCK_HW_CYCLES_TO_NS(lookup_time);
+
+	printf("| %14d | %27lu | %28lu |\n", n, (unsigned long)lookup_time,
+		   ns ? (unsigned long)(1000000000 / ns) : 0UL);
+}
+
+static void fiber_entry(void)
+{
+	uip_lladdr_t lladdr;
+	int i;
+
+	bench_test_init();
+
+	/* All the routes go through this neighbor */
+	memset(&lladdr, 0, sizeof(lladdr));
+	lladdr.addr[sizeof(lladdr.addr) - 1] = 1;
+	uip_ip6addr(&nexthop, 0xfe80, 0, 0, 0, 0, 0, 0, 1);
+
+	if (!uip_ds6_nbr_add(&nexthop, &lladdr, 1, NBR_REACHABLE)) {
+		printf("Failed to add the next hop neighbor\n");
+		return;
+	}
+
+	print_dash_line();
+	printf("|                   IPv6 Route Lookup Scalability Benchmark   "
+		   "                |\n");
+	print_dash_line();
+	printf("|  route lookup: %-61s|\n", LOOKUP_NAME);
+	printf("|  tcs = timer clock cycles: 1 tcs is %-5lu nsec"
+		   "                              |\n",
+		   (unsigned long)SYS_CLOCK_HW_CYCLES_TO_NS(1));
+	print_dash_line();
+	printf("|         routes | route lookup (average tcs)  |"
+		   " lookups per second           |\n");
+	print_dash_line();
+
+	for (i = 0; i < ARRAY_SIZE(route_counts); i++) {
+		route_scaling_test(route_counts[i]);
+	}
+
+	print_dash_line();
+	printf("|                                    E N D                       "
+		   "             |\n");
+	print_dash_line();
+}
+
+void main(void)
+{
+	/* Pretend to be ethernet with 6 byte mac */
+	uint8_t mac[] = { 0x0a, 0xbe, 0xef, 0x15, 0xf0, 0x0d };
+
+	net_init();
+	net_set_mac(mac, sizeof(mac));
+
+	/* The stack fibers cannot run in the middle of a measurement made
+	 * from a fiber.
+	 */
+	task_fiber_start(fiber_stack, STACKSIZE,
+			 (nano_fiber_entry_t)fiber_entry, 0, 0, 7, 0);
+}
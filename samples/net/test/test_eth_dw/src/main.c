@@ -0,0 +1,300 @@
+/* main.c - DesignWare Ethernet descriptor ring test */
+
+/*
+ * Copyright (c) 2016 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * DESCRIPTION
+ * This test sends UDP packets to the loopback address through the eth_dw
+ * driver, built against the software loopback model of the device. It
+ * checks that:
+ * - the receive ring is refilled, so that more frames than there are
+ *   receive buffers are all received;
+ * - the transmit descriptors and buffers are reclaimed once the frames are
+ *   transmitted;
+ * - a sender waits on the tx_free semaphore while all the transmit
+ *   descriptors are in use, and resumes once they are reclaimed.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+#include <string.h>
+
+#include <net/ip_buf.h>
+#include <net/net_core.h>
+#include <net/net_socket.h>
+
+/* The following uIP includes are for testing purposes only. */
+#include "contiki/ipv6/uip-ds6-route.h"
+#include "contiki/ipv6/uip-ds6-nbr.h"
+
+#include "eth_dw_priv.h"
+
+#define PORT 4242
+#define PAYLOAD_LEN 64
+
+/* enough frames to go through every receive buffer and descriptor */
+#define NUM_FRAMES (ETH_DW_RX_BUF_COUNT + ETH_DW_TX_DESC_COUNT)
+/* frames sent while the link is stalled: more than the transmit ring */
+#define NUM_HELD (ETH_DW_TX_DESC_COUNT + 2)
+
+#define RECV_TICKS 10
+
+static const struct in6_addr in6addr_any = IN6ADDR_ANY_INIT;
+static const struct in6_addr in6addr_loopback = IN6ADDR_LOOPBACK_INIT;
+
+static struct net_context *tx_ctx;
+static struct net_context *rx_ctx;
+static struct eth_runtime *eth;
+
+static int setup(void)
+{
+	struct net_addr any_addr;
+	struct net_addr loopback_addr;
+	struct device *dev;
+
+	dev = device_get_binding(CONFIG_ETH_DW_0_NAME);
+	if (!dev) {
+		TC_ERROR("cannot find %s\n", CONFIG_ETH_DW_0_NAME);
+		return TC_FAIL;
+	}
+	eth = dev->driver_data;
+
+	net_init();
+
+	/* Reach the loopback address through the Ethernet device. */
+	if (!uip_ds6_addr_add((uip_ipaddr_t *)&in6addr_loopback, 0,
+			      ADDR_MANUAL) ||
+	    !uip_ds6_nbr_add((uip_ipaddr_t *)&in6addr_loopback,
+			     &uip_lladdr, 0, NBR_REACHABLE) ||
+	    !uip_ds6_route_add((uip_ipaddr_t *)&in6addr_loopback, 128,
+			       (uip_ipaddr_t *)&in6addr_loopback)) {
+		TC_ERROR("cannot set up the loopback address\n");
+		return TC_FAIL;
+	}
+
+	any_addr.in6_addr = in6addr_any;
+	any_addr.family = AF_INET6;
+	loopback_addr.in6_addr = in6addr_loopback;
+	loopback_addr.family = AF_INET6;
+
+	tx_ctx = net_context_get(IPPROTO_UDP, &loopback_addr, PORT,
+				 &any_addr, 0);
+	rx_ctx = net_context_get(IPPROTO_UDP, &any_addr, 0,
+				 &loopback_addr, PORT);
+	if (!tx_ctx || !rx_ctx) {
+		TC_ERROR("cannot get network contexts\n");
+		return TC_FAIL;
+	}
+
+	return TC_PASS;
+}
+
+static int send_frame(uint8_t seq)
+{
+	struct net_buf *buf;
+	uint8_t *ptr;
+
+	buf = ip_buf_get_tx(tx_ctx);
+	if (!buf) {
+		TC_ERROR("cannot get TX buffer for frame %u\n", seq);
+		return TC_FAIL;
+	}
+
+	ptr = net_buf_add(buf, PAYLOAD_LEN);
+	memset(ptr, seq, PAYLOAD_LEN);
+
+	if (net_send(buf) < 0) {
+		TC_ERROR("cannot send frame %u\n", seq);
+		ip_buf_unref(buf);
+		return TC_FAIL;
+	}
+
+	return TC_PASS;
+}
+
+static int recv_frame(uint8_t seq)
+{
+	struct net_buf *buf;
+	uint8_t *data;
+	int rv = TC_PASS;
+	int i;
+
+	buf = net_receive(rx_ctx, RECV_TICKS);
+	if (!buf) {
+		TC_ERROR("frame %u not received\n", seq);
+		return TC_FAIL;
+	}
+
+	data = ip_buf_appdata(buf);
+	if (ip_buf_appdatalen(buf) != PAYLOAD_LEN) {
+		TC_ERROR("frame %u received with %u bytes\n", seq,
+			 ip_buf_appdatalen(buf));
+		rv = TC_FAIL;
+	}
+	for (i = 0; rv == TC_PASS && i < PAYLOAD_LEN; i++) {
+		if (data[i] != seq) {
+			TC_ERROR("frame %u received with data of frame %u\n",
+				 seq, data[i]);
+			rv = TC_FAIL;
+		}
+	}
+
+	ip_buf_unref(buf);
+	return rv;
+}
+
+/* Check that the transmit ring is free, and the receive ring full. */
+static int check_rings(void)
+{
+	struct net_buf *bufs[ETH_DW_RX_BUF_COUNT];
+	int count = 0;
+	int i;
+
+	if (eth->tx_free.nsig != ETH_DW_TX_DESC_COUNT) {
+		TC_ERROR("%d TX descriptors free, instead of %d\n",
+			 eth->tx_free.nsig, ETH_DW_TX_DESC_COUNT);
+		return TC_FAIL;
+	}
+
+	for (i = 0; i < ETH_DW_TX_DESC_COUNT; i++) {
+		if (eth->tx_bufs[i]) {
+			TC_ERROR("TX descriptor %d still holds a buffer\n", i);
+			return TC_FAIL;
+		}
+	}
+
+	for (i = 0; i < ETH_DW_RX_DESC_COUNT; i++) {
+		if (!eth->rx_desc[i].own || !eth->rx_bufs[i] ||
+		    eth->rx_desc[i].buf1_ptr != eth->rx_bufs[i]->data) {
+			TC_ERROR("RX descriptor %d is not ready\n", i);
+			return TC_FAIL;
+		}
+	}
+
+	/* Every receive buffer not in the ring is back in the pool. */
+	while (count < ETH_DW_RX_BUF_COUNT &&
+	       (bufs[count] = net_buf_get(&eth->rx_free, 0)) != NULL) {
+		count++;
+	}
+	for (i = 0; i < count; i++) {
+		net_buf_unref(bufs[i]);
+	}
+
+	if (count != ETH_DW_RX_BUF_COUNT - ETH_DW_RX_DESC_COUNT) {
+		TC_ERROR("%d RX buffers free, instead of %d\n", count,
+			 ETH_DW_RX_BUF_COUNT - ETH_DW_RX_DESC_COUNT);
+		return TC_FAIL;
+	}
+
+	return TC_PASS;
+}
+
+static int test_rx_refill(void)
+{
+	int i;
+
+	for (i = 0; i < NUM_FRAMES; i++) {
+		if (send_frame(i) != TC_PASS || recv_frame(i) != TC_PASS) {
+			return TC_FAIL;
+		}
+	}
+
+	/* let the driver reclaim the last transmit descriptor */
+	task_sleep(1);
+
+	return check_rings();
+}
+
+static int test_tx_free(void)
+{
+	struct net_buf *buf;
+	int i;
+
+	eth_dw_loopback_hold(true);
+
+	for (i = 0; i < NUM_HELD; i++) {
+		if (send_frame(i) != TC_PASS) {
+			eth_dw_loopback_hold(false);
+			return TC_FAIL;
+		}
+	}
+
+	/* let the stack hand the frames over to the driver */
+	task_sleep(2);
+
+	if (eth->tx_free.nsig != 0) {
+		TC_ERROR("%d TX descriptors free on a stalled link\n",
+			 eth->tx_free.nsig);
+		eth_dw_loopback_hold(false);
+		return TC_FAIL;
+	}
+
+	for (i = 0; i < ETH_DW_TX_DESC_COUNT; i++) {
+		if (!eth->tx_desc[i].own || !eth->tx_bufs[i]) {
+			TC_ERROR("TX descriptor %d not in use on a stalled "
+				 "link\n", i);
+			eth_dw_loopback_hold(false);
+			return TC_FAIL;
+		}
+	}
+
+	buf = net_receive(rx_ctx, TICKS_NONE);
+	if (buf) {
+		TC_ERROR("frame received on a stalled link\n");
+		ip_buf_unref(buf);
+		eth_dw_loopback_hold(false);
+		return TC_FAIL;
+	}
+
+	/* The sender waiting for a descriptor resumes once they are freed. */
+	eth_dw_loopback_hold(false);
+
+	for (i = 0; i < NUM_HELD; i++) {
+		if (recv_frame(i) != TC_PASS) {
+			return TC_FAIL;
+		}
+	}
+
+	task_sleep(1);
+
+	return check_rings();
+}
+
+void main(void)
+{
+	int rv;
+
+	TC_START("Test DesignWare Ethernet descriptor rings");
+
+	rv = setup();
+	if (rv != TC_PASS) {
+		goto done;
+	}
+
+	TC_PRINT("Testing RX ring refill and TX completion\n");
+	rv = test_rx_refill();
+	if (rv != TC_PASS) {
+		goto done;
+	}
+
+	TC_PRINT("Testing TX descriptor waits\n");
+	rv = test_tx_free();
+
+done:
+	TC_END_RESULT(rv);
+	TC_END_REPORT(rv);
+}
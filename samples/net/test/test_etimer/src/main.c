@@ -0,0 +1,179 @@
+/* main.c - Contiki event timer wakeup test */
+
+/*
+ * Copyright (c) 2016 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * DESCRIPTION
+ * This test checks that the net stack timer fiber, which sleeps until the
+ * earliest Contiki event timer expires, still wakes up for the timers set
+ * while it is busy running another timer, including when its wakeup expires
+ * before it waits for it again. It also checks that a timer its process keeps
+ * setting again as already expired is run once per tick, rather than keeping
+ * the fiber busy.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+
+#include <net/net_core.h>
+
+#include <sys/etimer.h>
+#include <sys/process.h>
+
+/* the timer run first keeps the timer fiber busy for this long */
+#define BUSY_TICKS 3
+/* set while the fiber is busy, this one expires meanwhile */
+#define SHORT_TICKS 1
+/* and this one after the fiber is done */
+#define LONG_TICKS 6
+/* set once everything is idle again */
+#define FINAL_TICKS 2
+/* allowed lateness of a timer */
+#define SLACK_TICKS 2
+/* times the timer set again as already expired is run */
+#define REARM_COUNT 5
+
+static struct etimer busy_timer;
+static struct etimer short_timer;
+static struct etimer long_timer;
+static struct etimer final_timer;
+static struct etimer rearm_timer;
+
+static uint32_t busy_set;
+static uint32_t short_fired;
+static uint32_t long_fired;
+static uint32_t rearm_fired;
+static int rearm_runs;
+static bool rearm_run_twice;
+
+static struct nano_sem fired_sem;
+
+static void busy_wait(uint32_t ticks)
+{
+	uint32_t end = sys_tick_get_32() + ticks;
+
+	while (sys_tick_get_32() < end) {
+	}
+}
+
+static void timer_run(struct etimer *t)
+{
+	if (t == &busy_timer) {
+		busy_set = sys_tick_get_32();
+		etimer_set(&short_timer, SHORT_TICKS, PROCESS_CURRENT());
+		etimer_set(&long_timer, LONG_TICKS, PROCESS_CURRENT());
+
+		/* The wakeup armed for the short timer expires while the
+		 * fiber spins here, with nobody waiting for it.
+		 */
+		busy_wait(BUSY_TICKS);
+	} else if (t == &short_timer) {
+		short_fired = sys_tick_get_32();
+	} else if (t == &long_timer) {
+		long_fired = sys_tick_get_32();
+		nano_fiber_sem_give(&fired_sem);
+	} else if (t == &final_timer) {
+		nano_fiber_sem_give(&fired_sem);
+	} else if (t == &rearm_timer) {
+		if (rearm_runs && rearm_fired == sys_tick_get_32()) {
+			rearm_run_twice = true;
+		}
+		rearm_fired = sys_tick_get_32();
+
+		if (++rearm_runs < REARM_COUNT) {
+			etimer_set(&rearm_timer, 0, PROCESS_CURRENT());
+		} else {
+			nano_fiber_sem_give(&fired_sem);
+		}
+	}
+}
+
+PROCESS(test_process, "Event timer test process");
+PROCESS_THREAD(test_process, ev, data, buf)
+{
+	PROCESS_BEGIN();
+
+	while (1) {
+		PROCESS_YIELD_UNTIL(ev == PROCESS_EVENT_TIMER);
+		timer_run(data);
+	}
+
+	PROCESS_END();
+}
+
+void main(void)
+{
+	int rv = TC_PASS;
+
+	TC_START("Test Contiki event timer wakeups");
+
+	nano_sem_init(&fired_sem);
+	net_init();
+	process_start(&test_process, NULL);
+
+	etimer_set(&busy_timer, 1, &test_process);
+
+	if (!nano_task_sem_take(&fired_sem,
+				1 + LONG_TICKS + SLACK_TICKS)) {
+		TC_ERROR("timer set while the fiber was busy did not fire\n");
+		rv = TC_FAIL;
+		goto done;
+	}
+
+	if (!short_fired) {
+		TC_ERROR("timer expired while the fiber was busy did not fire\n");
+		rv = TC_FAIL;
+		goto done;
+	}
+
+	if (long_fired - busy_set > LONG_TICKS + SLACK_TICKS) {
+		TC_ERROR("timer fired %u ticks late\n",
+			 long_fired - busy_set - LONG_TICKS);
+		rv = TC_FAIL;
+		goto done;
+	}
+
+	etimer_set(&final_timer, FINAL_TICKS, &test_process);
+
+	if (!nano_task_sem_take(&fired_sem, FINAL_TICKS + SLACK_TICKS)) {
+		TC_ERROR("timer set while idle did not fire\n");
+		rv = TC_FAIL;
+		goto done;
+	}
+
+	/* The timer fiber would never let this task run again if it kept
+	 * running the timer set again as already expired.
+	 */
+	etimer_set(&rearm_timer, 0, &test_process);
+
+	if (!nano_task_sem_take(&fired_sem,
+				1 + REARM_COUNT + SLACK_TICKS)) {
+		TC_ERROR("timer set again as expired ran %d times\n",
+			 rearm_runs);
+		rv = TC_FAIL;
+		goto done;
+	}
+
+	if (rearm_run_twice) {
+		TC_ERROR("timer set again as expired ran twice in a tick\n");
+		rv = TC_FAIL;
+	}
+
+done:
+	TC_END_RESULT(rv);
+	TC_END_REPORT(rv);
+}
@@ -0,0 +1,395 @@
+/* main.c - IPv6 route trie randomized test */
+
+/*
+ * Copyright (c) 2016 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * DESCRIPTION
+ * This test checks the IPv6 routing table indexed by the route prefix trie
+ * against a model that finds the longest matching prefix by comparing the
+ * destination with every route, over a random sequence of route additions,
+ * removals and lookups.
+ *
+ * The prefixes are drawn from sparse addresses truncated at random lengths,
+ * including ::/0 and /128, so that they nest and share leading bits, which
+ * makes the trie insert routes above others and branch between them, and
+ * collapse those branches as routes are removed. The routes go through two
+ * next hops, so that adding a route often drops the route that matched its
+ * prefix. The table is small, so that adding a route often drops the least
+ * recently used one.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+#include <string.h>
+#include <misc/util.h>
+
+#include <net/net_core.h>
+
+#include <contiki/ip/uip.h>
+#include <contiki/ipv6/uip-ds6.h>
+#include <contiki/ipv6/uip-ds6-nbr.h>
+#include <contiki/ipv6/uip-ds6-route.h>
+
+#define MAX_ROUTES CONFIG_NET_MAX_ROUTES
+#define NUM_NEXTHOPS 2
+#define NUM_OPS 5000
+#define SEED 0x2016
+
+struct model_route {
+	uip_ds6_route_t *route;
+	uip_ipaddr_t prefix;
+	uint8_t length;
+	int nexthop;
+	uint32_t last_used;
+};
+
+static struct model_route model[MAX_ROUTES];
+static int model_count;
+static uint32_t model_clock;
+
+static uip_ipaddr_t nexthops[NUM_NEXTHOPS];
+
+static uint32_t rand_state = SEED;
+
+/* number of times each case was checked */
+static int num_lookups;
+static int num_adds;
+static int num_existing;
+static int num_replaced;
+static int num_evicted;
+static int num_removed;
+static int num_default_added;
+static int num_host_added;
+
+static uint32_t rand32(void)
+{
+	/* xorshift32, so that a failing sequence can be reproduced */
+	rand_state ^= rand_state << 13;
+	rand_state ^= rand_state >> 17;
+	rand_state ^= rand_state << 5;
+	return rand_state;
+}
+
+static int prefix_match(const uip_ipaddr_t *addr,
+			const uip_ipaddr_t *prefix, uint8_t length)
+{
+	int i;
+
+	for (i = 0; i < length; i++) {
+		if (((addr->u8[i >> 3] ^ prefix->u8[i >> 3]) <<
+		     (i & 7)) & 0x80) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+static void prefix_mask(uip_ipaddr_t *addr, uint8_t length)
+{
+	int i;
+
+	for (i = length; i < 128; i++) {
+		addr->u8[i >> 3] &= ~(0x80 >> (i & 7));
+	}
+}
+
+/* bits that may be set in an address, and lengths a prefix often has */
+static const uint8_t addr_bits[] = {
+	32, 33, 40, 47, 48, 56, 63, 64, 65, 80, 96, 100, 112, 120, 126, 127
+};
+static const uint8_t lengths[] = { 48, 64, 65, 96, 112, 127, 128 };
+
+/*
+ * Draw an address from 2001:db8::/32 with a few of the bits above set, so
+ * that the addresses drawn share long runs of leading bits, and are often
+ * the same.
+ */
+static void addr_rand(uip_ipaddr_t *addr)
+{
+	int bits = rand32() % 5;
+	int i;
+
+	uip_ip6addr(addr, 0x2001, 0xdb8, 0, 0, 0, 0, 0, 0);
+	while (bits--) {
+		i = addr_bits[rand32() % ARRAY_SIZE(addr_bits)];
+		addr->u8[i >> 3] |= 0x80 >> (i & 7);
+	}
+}
+
+static uint8_t length_rand(void)
+{
+	switch (rand32() % 64) {
+	case 0:
+		return 0;
+	case 1:
+	case 2:
+		return 32;
+	default:
+		break;
+	}
+
+	if (rand32() % 4 == 0) {
+		return 1 + rand32() % 127;
+	}
+	return lengths[rand32() % ARRAY_SIZE(lengths)];
+}
+
+/*
+ * Longest prefix match over the model, comparing the address with every
+ * route; the route found is stamped as the most recently used.
+ */
+static int model_lookup(const uip_ipaddr_t *addr)
+{
+	int best = -1;
+	int i;
+
+	for (i = 0; i < model_count; i++) {
+		if (!prefix_match(addr, &model[i].prefix, model[i].length)) {
+			continue;
+		}
+		if (best < 0 || model[i].length > model[best].length) {
+			best = i;
+		}
+	}
+
+	if (best >= 0) {
+		model[best].last_used = ++model_clock;
+	}
+	return best;
+}
+
+static void model_remove(int i)
+{
+	model[i] = model[--model_count];
+}
+
+static int model_oldest(void)
+{
+	int oldest = 0;
+	int i;
+
+	for (i = 1; i < model_count; i++) {
+		if (model[i].last_used < model[oldest].last_used) {
+			oldest = i;
+		}
+	}
+	return oldest;
+}
+
+static int table_check(void)
+{
+	uip_ds6_route_t *r;
+	int i;
+
+	if (uip_ds6_route_num_routes() != model_count) {
+		TC_ERROR("%d routes, expected %d\n",
+			 uip_ds6_route_num_routes(), model_count);
+		return TC_FAIL;
+	}
+
+	for (r = uip_ds6_route_head(); r != NULL; r = uip_ds6_route_next(r)) {
+		for (i = 0; i < model_count && model[i].route != r; i++) {
+		}
+		if (i == model_count ||
+		    r->length != model[i].length ||
+		    !uip_ipaddr_cmp(&r->ipaddr, &model[i].prefix) ||
+		    !uip_ipaddr_cmp(uip_ds6_route_nexthop(r),
+				    &nexthops[model[i].nexthop])) {
+			TC_ERROR("unexpected route in the table\n");
+			return TC_FAIL;
+		}
+	}
+
+	return TC_PASS;
+}
+
+static int lookup_check(void)
+{
+	uip_ipaddr_t addr;
+	uip_ds6_route_t *r;
+	int i;
+
+	addr_rand(&addr);
+
+	r = uip_ds6_route_lookup(&addr);
+	i = model_lookup(&addr);
+	num_lookups++;
+
+	if (r != (i < 0 ? NULL : model[i].route)) {
+		TC_ERROR("lookup found %s route, expected %s route\n",
+			 r ? "a" : "no", i < 0 ? "no" : "another");
+		return TC_FAIL;
+	}
+
+	return TC_PASS;
+}
+
+static int add_check(void)
+{
+	uip_ipaddr_t prefix;
+	uint8_t length = length_rand();
+	int nexthop = rand32() % NUM_NEXTHOPS;
+	uip_ds6_route_t *r;
+	int i;
+
+	addr_rand(&prefix);
+	prefix_mask(&prefix, length);
+
+	/*
+	 * uip_ds6_route_add() first looks the prefix up as an address: the
+	 * route found is kept if it goes through the same next hop, and
+	 * dropped otherwise, even if it is not for the same prefix.
+	 */
+	i = model_lookup(&prefix);
+	if (i >= 0 && model[i].nexthop == nexthop) {
+		r = uip_ds6_route_add(&prefix, length, &nexthops[nexthop]);
+		num_existing++;
+		if (r != model[i].route) {
+			TC_ERROR("route added over an existing one\n");
+			return TC_FAIL;
+		}
+		return TC_PASS;
+	}
+
+	if (i >= 0) {
+		model_remove(i);
+		num_replaced++;
+	}
+	if (model_count == MAX_ROUTES) {
+		model_remove(model_oldest());
+		num_evicted++;
+	}
+
+	r = uip_ds6_route_add(&prefix, length, &nexthops[nexthop]);
+	num_adds++;
+	if (!r) {
+		TC_ERROR("failed to add a route\n");
+		return TC_FAIL;
+	}
+
+	model[model_count].route = r;
+	uip_ipaddr_copy(&model[model_count].prefix, &prefix);
+	model[model_count].length = length;
+	model[model_count].nexthop = nexthop;
+	model[model_count].last_used = ++model_clock;
+	model_count++;
+
+	if (length == 0) {
+		num_default_added++;
+	} else if (length == 128) {
+		num_host_added++;
+	}
+
+	return TC_PASS;
+}
+
+static int rm_check(void)
+{
+	int i;
+
+	if (!model_count) {
+		return TC_PASS;
+	}
+
+	i = rand32() % model_count;
+	uip_ds6_route_rm(model[i].route);
+	model_remove(i);
+	num_removed++;
+
+	return TC_PASS;
+}
+
+static int nexthops_add(void)
+{
+	uip_lladdr_t lladdr;
+	int i;
+
+	memset(&lladdr, 0, sizeof(lladdr));
+	for (i = 0; i < NUM_NEXTHOPS; i++) {
+		lladdr.addr[sizeof(lladdr.addr) - 1] = i + 1;
+		uip_ip6addr(&nexthops[i], 0xfe80, 0, 0, 0, 0, 0, 0, i + 1);
+
+		if (!uip_ds6_nbr_add(&nexthops[i], &lladdr, 1,
+				     NBR_REACHABLE)) {
+			TC_ERROR("failed to add next hop neighbor %d\n", i);
+			return TC_FAIL;
+		}
+	}
+
+	return TC_PASS;
+}
+
+void main(void)
+{
+	/* Pretend to be ethernet with 6 byte mac */
+	uint8_t mac[] = { 0x0a, 0xbe, 0xef, 0x15, 0xf0, 0x0d };
+	int rv;
+	int i;
+
+	TC_START("Test IPv6 route trie");
+
+	net_init();
+	net_set_mac(mac, sizeof(mac));
+
+	rv = nexthops_add();
+
+	for (i = 0; i < NUM_OPS && rv == TC_PASS; i++) {
+		switch (rand32() % 8) {
+		case 0:
+		case 1:
+		case 2:
+		case 3:
+			rv = add_check();
+			break;
+		case 4:
+		case 5:
+		case 6:
+			rv = lookup_check();
+			break;
+		default:
+			rv = rm_check();
+			break;
+		}
+
+		if (rv == TC_PASS) {
+			rv = table_check();
+		}
+	}
+
+	if (rv != TC_PASS) {
+		TC_ERROR("at operation %d of the sequence seeded with 0x%x\n",
+			 i, SEED);
+		goto done;
+	}
+
+	TC_PRINT("%d lookups, %d routes added, %d already there, "
+		 "%d replaced, %d dropped when full, %d removed\n",
+		 num_lookups, num_adds, num_existing, num_replaced,
+		 num_evicted, num_removed);
+	TC_PRINT("%d ::/0 and %d /128 routes added\n",
+		 num_default_added, num_host_added);
+
+	if (!num_existing || !num_replaced || !num_evicted ||
+	    !num_removed || !num_default_added || !num_host_added) {
+		TC_ERROR("sequence did not cover every case\n");
+		rv = TC_FAIL;
+	}
+
+done:
+	TC_END_RESULT(rv);
+	TC_END_REPORT(rv);
+}
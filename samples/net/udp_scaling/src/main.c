@@ -0,0 +1,226 @@
+/* main.c - UDP demultiplexing scalability benchmark */
+
+/*
+ * Copyright (c) 2016 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * DESCRIPTION
+ * This benchmark measures the time the uIP stack takes to receive a UDP
+ * datagram while a growing number of UDP connections are open, for the UDP
+ * connection lookup selected by the project configuration.
+ *
+ * The datagrams are handed to uip_input() directly, bypassing the network
+ * driver and the RX fiber, and are addressed to the port of the most recently
+ * opened connection, which is the last one a linear lookup finds.
+ */
+
+#include <zephyr.h>
+#include <stdio.h>
+#include <string.h>
+#include <misc/util.h>
+
+#include <net/ip_buf.h>
+#include <net/net_core.h>
+
+#include <contiki/ip/uip.h>
+#include <contiki/ipv6/uip-ds6.h>
+
+#include "timestamp.h"
+
+#define MAX_CONNS 200
+#define NUM_PROBES 1000
+
+#define LOCAL_PORT_BASE 5000
+#define PEER_PORT 4000
+#define PAYLOAD_LEN 32
+
+#define STACKSIZE 2000
+
+#ifdef CONFIG_NET_UDP_CONN_HASH
+#define LOOKUP_NAME "hash table"
+#else
+#define LOOKUP_NAME "linear scan"
+#endif
+
+#define IP_HDR(buf) ((struct uip_ip_hdr *)&uip_buf(buf)[UIP_LLH_LEN])
+#define UDP_HDR(buf) \
+	((struct uip_udp_hdr *)&uip_buf(buf)[UIP_LLH_LEN + UIP_IPH_LEN])
+
+uint32_t tm_off; /* time necessary to read the time */
+
+static char __stack fiber_stack[STACKSIZE];
+
+static struct uip_udp_conn *conns[MAX_CONNS];
+static int num_open;
+
+static const int num_conns[] = { 1, 10, 50, MAX_CONNS };
+
+static uip_ipaddr_t peer_addr;
+
+/**
+ *
+ * @brief Print dash line
+ *
+ * @return N/A
+ */
+static void print_dash_line(void)
+{
+	printf("|-----------------------------------------------------------------"
+		   "------------|\n");
+}
+
+/**
+ *
+ * @brief Fill a buffer with a UDP datagram from the peer
+ *
+ * The checksum is left out, which uIP accepts, so that the measurement does
+ * not depend on the length of the datagram.
+ *
+ * @param buf buffer to fill
+ * @param port destination port, in network byte order
+ *
+ * @return N/A
+ */
+static void datagram_build(struct net_buf *buf, uint16_t port)
+{
+	uip_ds6_addr_t *my_addr = uip_ds6_get_link_local(-1);
+
+	memset(uip_buf(buf), 0, UIP_LLH_LEN + UIP_IPUDPH_LEN + PAYLOAD_LEN);
+
+	IP_HDR(buf)->vtc = 0x60;
+	IP_HDR(buf)->len[1] = UIP_UDPH_LEN + PAYLOAD_LEN;
+	IP_HDR(buf)->proto = UIP_PROTO_UDP;
+	IP_HDR(buf)->ttl = 64;
+	uip_ipaddr_copy(&IP_HDR(buf)->srcipaddr, &peer_addr);
+	uip_ipaddr_copy(&IP_HDR(buf)->destipaddr, &my_addr->ipaddr);
+
+	UDP_HDR(buf)->srcport = UIP_HTONS(PEER_PORT);
+	UDP_HDR(buf)->destport = port;
+	UDP_HDR(buf)->udplen = UIP_HTONS(UIP_UDPH_LEN + PAYLOAD_LEN);
+	UDP_HDR(buf)->udpchksum = 0;
+
+	uip_len(buf) = UIP_IPUDPH_LEN + PAYLOAD_LEN;
+}
+
+/**
+ *
+ * @brief Measure the reception of a datagram with a number of connections
+ *
+ * @param buf buffer to receive the datagrams in
+ * @param n number of open UDP connections
+ *
+ * @return N/A
+ */
+static void udp_scaling_test(struct net_buf *buf, int n)
+{
+	struct uip_udp_conn *target;
+	uint32_t recv_time = 0;
+	uint32_t t;
+	uint32_t ns;
+	int missed = 0;
+	int i;
+
+	for (; num_open < n; num_open++) {
+		conns[num_open] = uip_udp_new(NULL, 0);
+		if (!conns[num_open]) {
+			printf("Failed to open UDP connection %d\n", num_open);
+			return;
+		}
+
+		uip_udp_bind(conns[num_open],
+			     UIP_HTONS(LOCAL_PORT_BASE + num_open));
+	}
+
+	target = conns[n - 1];
+
+	for (i = 0; i < NUM_PROBES; i++) {
+		datagram_build(buf, target->lport);
+
+		t = TIME_STAMP_DELTA_GET(0);
+		uip_input(buf);
+		recv_time += TIME_STAMP_DELTA_GET(t);
+
+		if (uip_udp_conn(buf) != target) {
+			missed++;
+		}
+	}
+
+	if (missed) {
+		printf("%d datagrams not received on their connection\n",
+		       missed);
+	}
+
+	recv_time /= NUM_PROBES;
+	ns = SYS_CLOCK_HW_CYCLES_TO_NS(recv_time);
+
+	printf("| %14d | %27lu | %28lu |\n", n, (unsigned long)recv_time,
+		   ns ? (unsigned long)(1000000000 / ns) : 0UL);
+}
+
+static void fiber_entry(void)
+{
+	struct net_buf *buf;
+	int i;
+
+	bench_test_init();
+
+	buf = ip_buf_get_reserve_rx(0);
+	if (!buf) {
+		printf("Failed to get a buffer\n");
+		return;
+	}
+
+	uip_ip6addr(&peer_addr, 0xfe80, 0, 0, 0, 0, 0, 0, 1);
+
+	print_dash_line();
+	printf("|                  UDP Demultiplexing Scalability Benchmark  "
+		   "                 |\n");
+	print_dash_line();
+	printf("|  connection lookup: %-56s|\n", LOOKUP_NAME);
+	printf("|  tcs = timer clock cycles: 1 tcs is %-5lu nsec"
+		   "                              |\n",
+		   (unsigned long)SYS_CLOCK_HW_CYCLES_TO_NS(1));
+	print_dash_line();
+	printf("| UDP conns open | datagram RX (average tcs)   |"
+		   " datagrams per second         |\n");
+	print_dash_line();
+
+	for (i = 0; i < ARRAY_SIZE(num_conns); i++) {
+		udp_scaling_test(buf, num_conns[i]);
+	}
+
+	ip_buf_unref(buf);
+
+	print_dash_line();
+	printf("|                                    E N D                       "
+		   "             |\n");
+	print_dash_line();
+}
+
+void main(void)
+{
+	/* Pretend to be ethernet with 6 byte mac */
+	uint8_t mac[] = { 0x0a, 0xbe, 0xef, 0x15, 0xf0, 0x0d };
+
+	net_init();
+	net_set_mac(mac, sizeof(mac));
+
+	/* The stack fibers cannot run in the middle of a measurement made
+	 * from a fiber.
+	 */
+	task_fiber_start(fiber_stack, STACKSIZE,
+			 (nano_fiber_entry_t)fiber_entry, 0, 0, 7, 0);
+}